@@ -67,6 +67,7 @@ HEADERS += \
     src/renderview.h \
     src/renderwindow.h \
     src/curveeditorwindow.h \
+    src/framewriter.h \
     src/widgets/curveeditorcanvas.h
 
 # List of source code files to be used when building the project
@@ -105,6 +106,7 @@ SOURCES += \
     src/renderview.cpp \
     src/renderwindow.cpp \
     src/curveeditorwindow.cpp \
+    src/framewriter.cpp \
     src/widgets/curveeditorcanvas.cpp
 
 RESOURCES += \
@@ -9,10 +9,6 @@
  ****************************************************************************/
 #include "curve.h"
 #include <animation/keyframe.h>
-#include <animation/linearcurveevaluator.h>
-#include <animation/beziercurveevaluator.h>
-#include <animation/bsplinecurveevaluator.h>
-#include <animation/catmullromcurveevaluator.h>
 #include <animation/curvesplot.h>
 #include <animation/controlpoint.h>
 #include <algorithm>
@@ -20,16 +16,12 @@
 Curve::Curve(CurvesPlot& parent_plot) :
     parent_plot_(&parent_plot),
     graph_(parent_plot.addGraph()),
-    tracer_(new QCPItemTracer(&parent_plot)),
     curve_type_(CurveType::Linear),
     visible_(false),
     wrap_curve_(false),
     animation_length_(parent_plot.GetAnimationLength())
 {
     graph_->setAntialiased(true);
-    tracer_->setGraph(graph_);
-    tracer_->setStyle(QCPItemTracer::tsNone);
-    tracer_->setInterpolating(true);
 
     // Listen for changes in the animation length
     parent_plot.AnimationLengthChanged.Connect(this, &Curve::OnAnimationLengthChanged);
@@ -39,9 +31,7 @@ Curve::Curve(CurvesPlot& parent_plot) :
 }
 
 float Curve::SampleAt(float t) const {
-    tracer_->setGraphKey(t);
-    parent_plot_->replot(); // Necessary to update the tracer's position
-    return tracer_->position->value();
+    return compiled_curve_.SampleAt(t);
 }
 
 std::vector<Keyframe*> Curve::GetKeyframes() const {
@@ -159,18 +149,14 @@ std::vector<ControlPoint *> Curve::GetControlPoints(const QRectF& rect) const {
 }
 
 void Curve::GenerateCurve() {
-    CurveEvaluator* curve_evaluator = GetCurveEvaluator(curve_type_);
-    std::vector<glm::vec2> evaluated_pts = {glm::vec2(0, 0), glm::vec2(animation_length_, 0)};
-
-    if (control_points_.size() > 0) {
-        // TODO: This is a bit inefficient
-        std::vector<glm::vec2> ctrl_pts;
-        for (auto& ctrl_pt : control_points_) ctrl_pts.push_back(ctrl_pt->Get());
-        std::sort(ctrl_pts.begin(), ctrl_pts.end(), [] (const glm::vec2& a, const glm::vec2& b) { return a.x < b.x; });
-        evaluated_pts = curve_evaluator->EvaluateCurve(ctrl_pts, 0);
-    }
-
-    // Pass the data to the graph
+    std::vector<glm::vec2> ctrl_pts;
+    ctrl_pts.reserve(control_points_.size());
+    for (auto& ctrl_pt : control_points_) ctrl_pts.push_back(ctrl_pt->Get());
+    std::sort(ctrl_pts.begin(), ctrl_pts.end(), [] (const glm::vec2& a, const glm::vec2& b) { return a.x < b.x; });
+    compiled_curve_.Compile(curve_type_, ctrl_pts, animation_length_, wrap_curve_);
+
+    // Pass the data to the graph, which is only used for display
+    const std::vector<glm::vec2>& evaluated_pts = compiled_curve_.GetPoints();
     size_t num_pts = evaluated_pts.size();
     QVector<double> x(num_pts);
     QVector<double> y(num_pts);
@@ -181,7 +167,6 @@ void Curve::GenerateCurve() {
     graph_->setData(x, y);
 
     parent_plot_->replot();
-    delete curve_evaluator;
 }
 
 void Curve::SetVisible(bool visible) {
@@ -206,21 +191,3 @@ void Curve::OnAnimationLengthChanged(unsigned int t) {
 bool Curve::IsInterpolating() const {
     return curve_type_ != CurveType::Bezier && curve_type_ != CurveType::BSpline;
 }
-
-CurveEvaluator* Curve::GetCurveEvaluator(CurveType curve_type) {
-    switch (curve_type) {
-        case CurveType::Bezier:
-            return new BezierCurveEvaluator(animation_length_, wrap_curve_);
-            break;
-        case CurveType::CatmullRom:
-            return new CatmullRomCurveEvaluator(animation_length_, wrap_curve_);
-            break;
-        case CurveType::BSpline:
-            return new BSplineCurveEvaluator(animation_length_, wrap_curve_);
-            break;
-        case CurveType::Linear:
-        default:
-            return new LinearCurveEvaluator(animation_length_, wrap_curve_);
-            break;
-    }
-}
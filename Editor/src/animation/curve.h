@@ -12,13 +12,12 @@
 
 #include <animator.h>
 #include <animation/curvesampler.h>
-#include <animation/curveevaluator.h>
+#include <animation/compiledcurve.h>
 
 class QRectF;
 class CurvesPlot;
 class ControlPoint;
 class QCPGraph;
-class QCPItemTracer;
 
 // TODO: Add discrete curves that use integral values of y.
 // TODO: Add binary curves that only use values 0 and 1 for y.
@@ -27,7 +26,7 @@ public:
     // Curve is hidden by default
     Curve(CurvesPlot& parent_plot);
 
-    // Samples the splined curve at time t.
+    // Samples the splined curve at time t from the curve cached by GenerateCurve.
     virtual float SampleAt(float t) const override;
 
     // Returns a vector of Control Points representing Keyframe<time, value>
@@ -94,7 +93,7 @@ protected:
     std::set<ControlPoint*> hidden_points_;
     CurvesPlot* parent_plot_;
     QCPGraph* graph_;
-    QCPItemTracer* tracer_;
+    CompiledCurve compiled_curve_;
     CurveType curve_type_;
     bool visible_;
     bool wrap_curve_;
@@ -102,8 +101,5 @@ protected:
 
     // Called when the plot changes the animation length
     void OnAnimationLengthChanged(unsigned int t);
-
-    // Returns the curve evaluator for the splined curve type.
-    CurveEvaluator* GetCurveEvaluator(CurveType curve_type);
 };
 #endif // CURVE_H
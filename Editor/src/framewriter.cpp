@@ -0,0 +1,73 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#include "framewriter.h"
+#include <animator.h>
+
+class FrameWriter::WriteJob : public QRunnable {
+public:
+    WriteJob(FrameWriter& writer, QImage&& image, const QString& filename, const QSize& size) :
+        writer_(writer), image_(std::move(image)), filename_(filename), size_(size) { }
+
+    virtual void run() override {
+        if (image_.size() != size_) image_ = image_.scaled(size_);
+        writer_.OnJobDone(filename_, image_.save(filename_, nullptr, writer_.quality_));
+    }
+
+private:
+    FrameWriter& writer_;
+    QImage image_;
+    QString filename_;
+    QSize size_;
+};
+
+FrameWriter::FrameWriter() :
+    queued_(0),
+    quality_(-1)
+{
+    pool_.setMaxThreadCount(WRITER_THREADS);
+}
+
+FrameWriter::~FrameWriter() {
+    pool_.waitForDone(-1);
+}
+
+void FrameWriter::Write(QImage&& image, const QString& filename, const QSize& size) {
+    {
+        // Hold the renderer back while the writers catch up
+        QMutexLocker lock(&mutex_);
+        while (queued_ >= MAX_QUEUED) job_done_.wait(&mutex_);
+        queued_++;
+    }
+    pool_.start(new WriteJob(*this, std::move(image), filename, size));
+    LogFailures();
+}
+
+void FrameWriter::WaitForDone() {
+    pool_.waitForDone(-1);
+    LogFailures();
+}
+
+void FrameWriter::OnJobDone(const QString& filename, bool saved) {
+    QMutexLocker lock(&mutex_);
+    if (!saved) failed_.append(filename);
+    queued_--;
+    job_done_.wakeAll();
+}
+
+void FrameWriter::LogFailures() {
+    QStringList failed;
+    {
+        QMutexLocker lock(&mutex_);
+        failed.swap(failed_);
+    }
+    for (const QString& filename : failed) {
+        Debug::Log.WriteLine("Could not save frame to " + filename.toStdString(), Priority::Error);
+    }
+}
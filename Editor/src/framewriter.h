@@ -0,0 +1,55 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#ifndef FRAMEWRITER_H
+#define FRAMEWRITER_H
+
+#include <QImage>
+#include <QMutex>
+#include <QRunnable>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+// Encodes and saves rendered frames on background threads, so the renderer can move on to the next frame.
+// At most MAX_QUEUED frames wait to be written; past that, Write blocks until one is done.
+class FrameWriter {
+public:
+    static const int MAX_QUEUED = 8;
+    static const int WRITER_THREADS = 2;
+
+    FrameWriter();
+    // Waits for every queued frame to be written
+    ~FrameWriter();
+
+    // Quality passed on to QImage::save. For PNG, lower values compress harder. -1 uses the default.
+    void SetQuality(int quality) { quality_ = quality; }
+
+    // Queues a frame to be scaled to size, if it isn't already, and saved to filename
+    void Write(QImage&& image, const QString& filename, const QSize& size);
+    // Waits for every queued frame to be written and logs the ones that couldn't be
+    void WaitForDone();
+
+private:
+    class WriteJob;
+
+    QThreadPool pool_;
+    QMutex mutex_;
+    QWaitCondition job_done_;
+    int queued_;
+    int quality_;
+    QStringList failed_;
+
+    void OnJobDone(const QString& filename, bool saved);
+    void LogFailures();
+};
+
+#endif // FRAMEWRITER_H
@@ -25,7 +25,6 @@ GizmoManager::GizmoManager()
 template<typename T>
 static void recursive_add_map(std::unordered_map<uint64_t, T>& m, SceneObject* n, T v) {
     m[n->GetUID()] = v;
-    std::vector<SceneObject*> children = n->GetChildren();
     for (auto child : n->GetChildren()) recursive_add_map(m, child, v);
 }
 
@@ -27,6 +27,7 @@
 #include <QTextBlock>
 #include <QTextStream>
 #include <QFile>
+#include <QElapsedTimer>
 
 const bool ANIMATOR_ENABLED = true;
 
@@ -38,6 +39,7 @@ MainWindow::MainWindow(QWidget *parent) :
     curve_editor_dialog_(nullptr),
     render_window_(this),
     vertex_editing(false),
+    image_quality_(-1),
 #if defined(_WIN32) || defined (_WIN64)
     trace_path_(tr("Trace.exe")),
 #else
@@ -46,10 +48,16 @@ MainWindow::MainWindow(QWidget *parent) :
     previous_animation_time_(0),
     grid_(nullptr),
     selected_object_(nullptr),
+    preload_timer_(new QTimer(this)),
+    reload_timer_(new QTimer(this)),
+    load_progress_(nullptr),
     ui(new Ui::MainWindow),
     actions_(this),
     hierarchy_context_menu_(new QMenu(tr("Hierarchy Context Menu"), this))
 {
+    QElapsedTimer startup_timer;
+    startup_timer.start();
+
     // Creates the widgets from the .ui designer file
     ui->setupUi(this);
     setFocusPolicy(Qt::NoFocus);
@@ -57,6 +65,7 @@ MainWindow::MainWindow(QWidget *parent) :
     // Attach Listener to the Debug output
     Debug::Log.AttachListener("MainWindow", std::bind(&MainWindow::LogCallback, this, std::placeholders::_1, std::placeholders::_2));
     Debug::Log.WriteLine("Ready", Priority::Status);
+    scene_manager_.LoadProgress.Connect(this, &MainWindow::OnLoadProgress);
 
     // Initialize OpenGLContext so we can create context specific resources
     InitializeContext();
@@ -134,8 +143,24 @@ MainWindow::MainWindow(QWidget *parent) :
 
 
 
+    // Timers still fire while the load progress dialog processes events, so leave the assets alone until loading ends
+    connect(preload_timer_, &QTimer::timeout, this, [this]() {
+        if (scene_manager_.IsLoading()) return;
+        AssetManager* assets = AssetManager::Instance();
+        if (assets == nullptr || !assets->PublishPreloadedAssets()) preload_timer_->stop();
+    });
+    // Tracer threads read textures and meshes as they go, so reloads stay queued until the render window is done
+    connect(reload_timer_, &QTimer::timeout, this, [this]() {
+        if (scene_manager_.IsLoading() || render_window_.IsRendering()) return;
+        AssetManager* assets = AssetManager::Instance();
+        if (assets != nullptr && assets->PublishReloadedAssets()) RedrawSceneViews();
+    });
+    reload_timer_->start(100);
+
     // Initialize default scene
     NewScene();
+
+    Debug::Log.WriteLine("Started in " + std::to_string(startup_timer.elapsed()) + " ms");
 }
 
 MainWindow::~MainWindow() {
@@ -206,6 +231,29 @@ void MainWindow::LogCallback(std::string message, Priority p) {
     }
 }
 
+void MainWindow::OnLoadProgress(size_t loaded, size_t total) {
+    statusBar()->showMessage(tr("Loading assets %1 of %2").arg(loaded).arg(total));
+    // The event loop isn't running while loading, so draw the message now
+    statusBar()->repaint();
+
+    if (load_progress_ == nullptr) {
+        load_progress_ = new QProgressDialog(tr("Loading assets..."), tr("Cancel"), 0, 0, this);
+        // Modal, so that while it processes events the only input that gets through is its Cancel button and Esc
+        load_progress_->setWindowModality(Qt::WindowModal);
+        load_progress_->setAutoReset(false);
+        load_progress_->setMinimumDuration(500);
+        connect(load_progress_, &QProgressDialog::canceled, this, [this]() { scene_manager_.CancelLoad(); });
+    }
+    load_progress_->setMaximum(total);
+    load_progress_->setValue(loaded);
+}
+
+Scene* MainWindow::LoadScene(const std::string& filename) {
+    Scene* new_scene = scene_manager_.LoadScene(filename);
+    if (load_progress_ != nullptr) load_progress_->reset();
+    return new_scene;
+}
+
 void MainWindow::GrayoutConsole() {
     ui->console->selectAll();
     ui->console->setTextColor(Qt::gray);
@@ -291,7 +339,7 @@ void MainWindow::OpenScene() {
     if (filename.isNull() || filename.isEmpty()) return;
     auto file_info = QFileInfo(filename);
     FilePicker::LastPath = file_info.path();
-    Scene* new_scene = scene_manager_.LoadScene(filename.toStdString());
+    Scene* new_scene = LoadScene(filename.toStdString());
     if (new_scene != nullptr) {
         current_file_path_ = filename.toStdString();
         GrayoutConsole();
@@ -306,7 +354,7 @@ void MainWindow::SaveScene() {
 void MainWindow::SaveSceneAs() {
     QString filename = QFileDialog::getSaveFileName(this, tr("Save Scene"), FilePicker::LastPath, FilePicker::FileFilters[FileType::Scene], 0, QFileDialog::DontUseNativeDialog);
     if (filename.isNull() || filename.isEmpty()) return;
-    if (!filename.endsWith(".yaml")) filename += ".yaml";
+    if (!filename.endsWith(".yaml") && !SceneManager::IsBinarySceneFile(filename.toStdString())) filename += ".yaml";
     QFileInfo file_info(filename);
     FilePicker::LastPath = file_info.path();
     current_file_path_ = filename.toStdString();
@@ -325,6 +373,7 @@ void MainWindow::RaytraceFrame() {
     QString filename = QFileDialog::getSaveFileName(this, tr("Save Frame As"), FilePicker::LastPath, "Image Files (*.png)", 0, QFileDialog::DontUseNativeDialog);
     if (filename.isNull() || filename.isEmpty()) return;
     AnimationSettings settings(animator_.GetFPS(), 0, filename.toStdString(), true);
+    settings.ImageQuality = image_quality_;
     render_window_.exec(*scene_, settings);
 }
 
@@ -334,6 +383,7 @@ void MainWindow::RasterizeMovieFrames() {
     QString filename = QFileDialog::getSaveFileName(this, tr("Save Frames As"), FilePicker::LastPath, "Image Files (*.png)", 0, QFileDialog::DontUseNativeDialog);
     if (filename.isNull() || filename.isEmpty()) return;
     AnimationSettings settings(animator_.GetFPS(), animator_.GetAnimationLength(), filename.toStdString(), false);
+    settings.ImageQuality = image_quality_;
     render_window_.exec(*scene_, settings);
 }
 
@@ -343,9 +393,16 @@ void MainWindow::RaytraceMovieFrames() {
     QString filename = QFileDialog::getSaveFileName(this, tr("Save Frames As"), FilePicker::LastPath, "Image Files (*.png)", 0, QFileDialog::DontUseNativeDialog);
     if (filename.isNull() || filename.isEmpty()) return;
     AnimationSettings settings(animator_.GetFPS(), animator_.GetAnimationLength(), filename.toStdString(), true);
+    settings.ImageQuality = image_quality_;
     render_window_.exec(*scene_, settings);
 }
 
+void MainWindow::SetImageQuality() {
+    bool okay;
+    int quality = QInputDialog::getInt(this, tr("Image Quality"), tr("Quality of Saved Frames (0 compresses PNGs hardest, 100 least, -1 for the default)"), image_quality_, -1, 100, 1, &okay, Qt::WindowTitleHint | Qt::WindowSystemMenuHint | Qt::WindowCloseButtonHint);
+    if (okay) image_quality_ = quality;
+}
+
 void MainWindow::RaytraceFrameAndDiff() {
     Debug::Log.WriteLine("\n\n============ Start Diff Evaluations ============");
 
@@ -393,7 +450,7 @@ void MainWindow::DiffAllRaytraceScenes()
     {
         std::string scene_file_path = scene_files[i];
 
-        Scene* new_scene = scene_manager_.LoadScene(scene_file_path);
+        Scene* new_scene = LoadScene(scene_file_path);
         if (new_scene != nullptr)
         {
             current_file_path_ = scene_file_path;
@@ -410,7 +467,7 @@ void MainWindow::DiffAllRaytraceScenes()
 
     if (is_yaml_file(old_scene_file_path))
     {
-        Scene* new_scene = scene_manager_.LoadScene(old_scene_file_path);
+        Scene* new_scene = LoadScene(old_scene_file_path);
         if (new_scene != nullptr)
         {
             GrayoutConsole();
@@ -563,8 +620,12 @@ void MainWindow::SetScene(Scene& scene) {
     grid.GetComponent<TriangleMesh>()->MeshFilter.Set(grid_mesh);
     Material* gray_material = asset_manager.GetMaterial("_internal Unlit Gray");
     grid.GetComponent<Geometry>()->RenderMaterial.Set(gray_material);
-    grid_mesh->SetPositions(grid_positions);
+    grid_mesh->SetPositions(std::move(grid_positions));
     grid.GetTransform().Rotate(glm::vec3(1.0f, 0.0f, 0.0f), 90);
+
+    // Load the built-in assets the scene hasn't used yet while the editor is idle
+    asset_manager.PreloadAssets();
+    preload_timer_->start(100);
 }
 
 void MainWindow::CreateSplitScreen() {
@@ -660,6 +721,10 @@ void MainWindow::CreateRenderActions() {
     connect(trace_frames_action, &QAction::triggered, this, &MainWindow::RaytraceMovieFrames);
     addAction(trace_frames_action);
 
+    QAction* image_quality_action = actions_.CreateAction("Set Image Quality");
+    connect(image_quality_action, &QAction::triggered, this, &MainWindow::SetImageQuality);
+    addAction(image_quality_action);
+
     QAction* trace_frame_diff_action = actions_.CreateAction("Raytrace Frame And Diff");
     connect(trace_frame_diff_action, &QAction::triggered, this, &MainWindow::RaytraceFrameAndDiff);
     addAction(trace_frame_diff_action);
@@ -793,7 +858,7 @@ void MainWindow::CreateAssetsActions() {
                 if (geo == nullptr) {
                     return;
                 }
-                Mesh* mesh = geo->GetRenderMesh();
+                Mesh* mesh = geo->GetCompleteRenderMesh();
                 if (mesh == nullptr) {
                     return;
                 }
@@ -1268,6 +1333,7 @@ void MainWindow::CreateMenus() {
     render_menu_->addAction(actions_["Raytrace and Save Frame"]);
     render_menu_->addAction(actions_["Save Movie Frames"]);
     render_menu_->addAction(actions_["Raytrace and Save Movie Frames"]);
+    render_menu_->addAction(actions_["Set Image Quality"]);
     render_menu_->addSeparator();
     render_menu_->addAction(actions_["Raytrace Frame And Diff"]);
     render_menu_->addAction(actions_["Diff All Raytrace Scenes"]);
@@ -22,7 +22,9 @@
 #include <qtwidgets.h>
 #include <QMainWindow>
 #include <QProcess>
+#include <QProgressDialog>
 #include <QSplitter>
+#include <QTimer>
 #include <scene/scenemanager.h>
 #include <scene/translator.h>
 #include <actionmanager.h>
@@ -60,6 +62,8 @@ protected:
     RenderWindow render_window_;
     SceneWindow::MouseMode mode;
     bool vertex_editing;
+    // QImage::save quality for saved frames; for PNG, lower compresses harder. -1 uses Qt's default.
+    int image_quality_;
     std::string current_file_path_;
     QString trace_path_;
     QProcess trace_process_;
@@ -67,6 +71,12 @@ protected:
     // TODO: Move this to renderer?
     SceneObject* grid_;
     SceneObject* selected_object_;
+    // Publishes the scene's built-in assets as they finish loading in the background
+    QTimer* preload_timer_;
+    // Publishes assets reloaded in the background after their files changed on disk
+    QTimer* reload_timer_;
+    // Lets the user cancel (with its button or Esc) a scene whose files take a while to load
+    QProgressDialog* load_progress_;
 
     // UI Stuff
     Ui::MainWindow *ui;
@@ -83,6 +93,10 @@ protected:
 
     // Notification from the logger that user wants to write something
     void LogCallback(std::string message, Priority p);
+    // Shows how many of the scene's files have been imported while it loads
+    void OnLoadProgress(size_t loaded, size_t total);
+    // Loads a scene, hiding the load progress afterwards whether or not it loaded
+    Scene* LoadScene(const std::string& filename);
 
     // Previous console messages may no longer apply (e.g. on refresh, scene load)
     void GrayoutConsole();
@@ -106,6 +120,7 @@ protected:
     void RaytraceFrame();
     void RasterizeMovieFrames();
     void RaytraceMovieFrames();
+    void SetImageQuality();
 
     void DiffAllRaytraceScenes();
     void RaytraceFrameAndDiff();
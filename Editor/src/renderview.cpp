@@ -31,16 +31,26 @@ RenderView::RenderView(QWidget* parent) :
     renderer_->DisplayLights(false);
     renderer_->DisplayCamera(false);
     renderer_->DisplayColliders(false);
+    // Saved frames must show every subdivision level in full
+    renderer_->SetWaitForCompleteMeshes(true);
 }
 
 void RenderView::SaveFrame(Scene& scene, SceneObject& rendercam, std::string output_filename, bool trace) {
+    if (trace) {
+        // automatically starts drawing on other threads
+        SaveFrame(std::make_unique<RayTracer>(scene, rendercam), scene, rendercam, output_filename);
+        return;
+    }
+    SaveFrame(nullptr, scene, rendercam, output_filename);
+}
+
+void RenderView::SaveFrame(std::unique_ptr<RayTracer> tracer, Scene& scene, SceneObject& rendercam, std::string output_filename) {
     scene_ = &scene;
     render_cam_ = &rendercam;
-    trace_ = trace;
+    trace_ = tracer != nullptr;
 
-    if (trace) {
-        // automatically starts drawing on other threads
-        tracer_.reset(new RayTracer(scene, rendercam));
+    if (trace_) {
+        tracer_ = std::move(tracer);
 
         //if window is closed, tracer_ is deleted
         while(tracer_!=nullptr && tracer_->GetProgress() < 100) {
@@ -61,12 +71,8 @@ void RenderView::SaveFrame(Scene& scene, SceneObject& rendercam, std::string out
             Camera* cam = rendercam.GetComponent<Camera>();
             int rwidth = cam->RenderWidth.Get();
             int rheight = cam->RenderHeight.Get();
-            QImage cnv = grabFramebuffer();
-            if (cnv.width() == rwidth && cnv.height() == rheight) {
-                cnv.save(rfile);
-            } else {
-                cnv.scaled(rwidth, rheight).save(rfile);
-            }
+            // Only the grab needs the GL context; scaling and encoding happen on the writer threads
+            frame_writer_.Write(grabFramebuffer(), rfile, QSize(rwidth, rheight));
         }
 }
 
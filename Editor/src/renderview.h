@@ -19,6 +19,7 @@
 #include <QMouseEvent>
 #include <opengl/glrenderer.h>
 #include <trace/raytracer.h>
+#include "framewriter.h"
 
 class Scene;
 class SceneObject;
@@ -29,7 +30,13 @@ class RenderView : public QOpenGLWidget {
 public:
     RenderView(QWidget* parent = nullptr);
     void SaveFrame(Scene& scene, SceneObject& rendercam, std::string output_filename, bool trace);
+    // Shows and saves the frame of a tracer that was started earlier, waiting for it to finish
+    void SaveFrame(std::unique_ptr<RayTracer> tracer, Scene& scene, SceneObject& rendercam, std::string output_filename);
     void Cancel();
+    // Quality for saved frames, as passed to QImage::save
+    void SetImageQuality(int quality) { frame_writer_.SetQuality(quality); }
+    // Saved frames are written in the background; this waits until they are all on disk
+    void WaitForWrites() { frame_writer_.WaitForDone(); }
 
     void mousePressEvent(QMouseEvent *event);
 
@@ -44,6 +51,7 @@ private:
     bool trace_;
     std::unique_ptr<QOpenGLTextureBlitter> blitter_;
     std::unique_ptr<RayTracer> tracer_;
+    FrameWriter frame_writer_;
 
     void initializeGL() override;
     void paintGL() override;
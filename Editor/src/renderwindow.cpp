@@ -14,6 +14,7 @@
 #include <scene/components/camera.h>
 #include <scene/renderer.h>
 #include <opengl/glrenderer.h>
+#include <deque>
 #include <iomanip>
 #include <sstream>
 #include <string>
@@ -22,6 +23,7 @@
 #include <QScrollArea>
 #include <QStyle>
 #include <QDesktopServices>
+#include <QElapsedTimer>
 
 // Pads a number with leading zeroes
 std::string ZeroPadNumber(int num, unsigned int width = 5) {
@@ -37,6 +39,7 @@ std::string ZeroPadNumber(int num, unsigned int width = 5) {
 RenderWindow::RenderWindow(QWidget *parent) :
     QDockWidget("Render View", parent),
     rendering_(false),
+    exec_depth_(0),
     first_view_(true)
 {
     QWidget* new_render_widget = new QWidget(parent);
@@ -67,21 +70,24 @@ void RenderWindow::closeEvent(QCloseEvent *event) {
 
 int RenderWindow::exec(Scene& scene, const AnimationSettings& settings)
 {
+    int result = 0;
+    exec_depth_++;
     switch (settings.Mode)
     {
     case AnimationSettings::AS_NORMAL:
-        return exec_normal(scene, settings);
+        result = exec_normal(scene, settings);
         break;
 
     case AnimationSettings::AS_DIFF:
-        return exec_diff(scene, settings);
+        result = exec_diff(scene, settings);
         break;
 
     default:
         break;
     }
+    exec_depth_--;
 
-    return 0;
+    return result;
 }
 
 int RenderWindow::exec_normal(Scene& scene, const AnimationSettings& settings) {
@@ -128,29 +134,33 @@ int RenderWindow::exec_normal(Scene& scene, const AnimationSettings& settings) {
     resize(camera->RenderWidth.Get() + 4, camera->RenderHeight.Get() + titleBarHeight);
 
     // Save out all the frames
+    render_view_.SetImageQuality(settings.ImageQuality);
 
     if (settings.Length == 0) {
         setWindowTitle(QString::fromStdString("Frame"));
         std::string fn = filename;
         render_view_.SaveFrame(scene, *render_cam, fn, settings.Trace);
+        render_view_.WaitForWrites();
     } else {
         unsigned int total_frames = settings.FPS * settings.Length;
-        double frame_time = 1.0 / settings.FPS;
-        double current_time = 0.0;
+        QElapsedTimer timer;
+        timer.start();
         scene.Start();
-        for (unsigned int current_frame = 0; rendering_ && current_frame < total_frames; current_frame++) {
-            scene.Update(current_time, frame_time);
-            std::string fn = filename;
-            if (fn != "") {
-                fn = fn + "_" + ZeroPadNumber(current_frame);
-            }
-            render_view_.SaveFrame(scene, *render_cam, fn, settings.Trace);
-            setWindowTitle(QString::fromStdString("Saving frames (" + std::to_string(current_frame) + " of " + std::to_string(total_frames) + ")"));
-            current_time += frame_time;
+        if (settings.Trace && settings.FrameParallel && RayTracer::IsSnapshotSafe(scene)) {
+            trace_frames_parallel(scene, *render_cam, filename, settings);
+        } else {
+            save_frames(scene, *render_cam, filename, settings);
         }
+        bool completed = rendering_;
         rendering_ = false;
         scene.Stop();
         scene.Reset();
+        render_view_.WaitForWrites();
+
+        if (completed && timer.elapsed() > 0) {
+            double frames_per_minute = total_frames * 60000.0 / timer.elapsed();
+            Debug::Log.WriteLine("Saved " + std::to_string(total_frames) + " frames at " + std::to_string(frames_per_minute) + " frames/minute");
+        }
     }
 
     // Close the window
@@ -159,6 +169,56 @@ int RenderWindow::exec_normal(Scene& scene, const AnimationSettings& settings) {
     return 0;
 }
 
+void RenderWindow::save_frames(Scene& scene, SceneObject& render_cam, const std::string& filename, const AnimationSettings& settings) {
+    unsigned int total_frames = settings.FPS * settings.Length;
+    double frame_time = 1.0 / settings.FPS;
+    double current_time = 0.0;
+    for (unsigned int current_frame = 0; rendering_ && current_frame < total_frames; current_frame++) {
+        scene.Update(current_time, frame_time);
+        std::string fn = filename;
+        if (fn != "") {
+            fn = fn + "_" + ZeroPadNumber(current_frame);
+        }
+        render_view_.SaveFrame(scene, render_cam, fn, settings.Trace);
+        setWindowTitle(QString::fromStdString("Saving frames (" + std::to_string(current_frame) + " of " + std::to_string(total_frames) + ")"));
+        current_time += frame_time;
+    }
+}
+
+void RenderWindow::trace_frames_parallel(Scene& scene, SceneObject& render_cam, const std::string& filename, const AnimationSettings& settings) {
+    unsigned int total_frames = settings.FPS * settings.Length;
+    double frame_time = 1.0 / settings.FPS;
+    double current_time = 0.0;
+
+    // Split the same thread budget a single tracer would use between the frames in flight
+    int thread_budget = std::max(QThread::idealThreadCount() - 1, 1);
+    unsigned int frames_in_flight = std::min((unsigned int) MAX_FRAMES_IN_FLIGHT, (unsigned int) thread_budget);
+    int threads_per_frame = std::max(thread_budget / (int) frames_in_flight, 1);
+
+    // Each tracer copies what it needs from the scene when it is built, so the scene can move on to the
+    // next frame while it traces. Updates stay sequential, which also keeps particle simulation in order.
+    std::deque<std::unique_ptr<RayTracer>> in_flight;
+    unsigned int next_frame = 0;
+    for (unsigned int current_frame = 0; rendering_ && current_frame < total_frames; current_frame++) {
+        while (next_frame < total_frames && in_flight.size() < frames_in_flight) {
+            scene.Update(current_time, frame_time);
+            in_flight.push_back(std::make_unique<RayTracer>(scene, render_cam, threads_per_frame));
+            current_time += frame_time;
+            next_frame++;
+        }
+
+        // Frames are shown and saved in order, while the later ones keep tracing
+        std::string fn = filename;
+        if (fn != "") {
+            fn = fn + "_" + ZeroPadNumber(current_frame);
+        }
+        render_view_.SaveFrame(std::move(in_flight.front()), scene, render_cam, fn);
+        in_flight.pop_front();
+        setWindowTitle(QString::fromStdString("Saving frames (" + std::to_string(current_frame) + " of " + std::to_string(total_frames) + ")"));
+    }
+    // Closing the window cancels whatever is still tracing
+}
+
 int get_render_depth(Scene& scene)
 {
     SceneObject* render_cam = scene.GetOrCreateRenderCam();
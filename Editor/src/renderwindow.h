@@ -30,10 +30,12 @@ struct AnimationSettings {
 
     AS_Mode Mode;
     bool isOpenDiffImage;
+    bool FrameParallel; //trace several frames at once when the scene allows it
+    int ImageQuality; //passed to QImage::save, lower compresses PNGs harder; -1 = default
 
-    AnimationSettings(unsigned int fps_, unsigned int length_, std::string filename_, bool trace_, AS_Mode mode_ = AS_NORMAL, bool is_open_diff_=false)
+    AnimationSettings(unsigned int fps_, unsigned int length_, std::string filename_, bool trace_, AS_Mode mode_ = AS_NORMAL, bool is_open_diff_=false, bool frame_parallel_=true, int image_quality_=-1)
         : FPS(fps_), Length(length_), Filename(filename_), Trace(trace_)
-        , Mode(mode_), isOpenDiffImage(is_open_diff_){ }
+        , Mode(mode_), isOpenDiffImage(is_open_diff_), FrameParallel(frame_parallel_), ImageQuality(image_quality_){ }
 };
 
 class RenderWindow : public QDockWidget {
@@ -45,6 +47,9 @@ public:
 
     virtual void closeEvent(QCloseEvent* event) override;
     virtual int exec(Scene& scene, const AnimationSettings& settings);
+    // Whether exec is still rendering or tracing frames. It processes events while it waits, so timers (and another
+    // exec) can run meanwhile.
+    bool IsRendering() const { return exec_depth_ > 0; }
 
     int exec_normal(Scene& scene, const AnimationSettings& settings);
     int exec_diff(Scene& scene, const AnimationSettings& settings);
@@ -52,8 +57,15 @@ public:
 private:
     RenderView render_view_;
     bool rendering_;
+    int exec_depth_;
     bool first_view_;
 
+    // Most frames a frame-parallel trace keeps in flight
+    static const unsigned int MAX_FRAMES_IN_FLIGHT = 4;
+
+    void save_frames(Scene& scene, SceneObject& render_cam, const std::string& filename, const AnimationSettings& settings);
+    void trace_frames_parallel(Scene& scene, SceneObject& render_cam, const std::string& filename, const AnimationSettings& settings);
+
     MainWindow* get_main_wnd();
     SceneObject* set_render_view(Scene& scene, int &render_width, int &render_height);
 };
@@ -12,6 +12,7 @@
 #include <scenewindow.h>
 #include <scene/components/camera.h>
 #include <opengl/glrenderer.h>
+#include <resource/subdivisioncache.h>
 #include <QMouseEvent>
 #include <QSurface>
 #include <QVBoxLayout>
@@ -207,6 +208,8 @@ SceneWindow::SceneWindow(QVBoxLayout& managing_layout, QWidget *parent) :
     });
 
     connect(camera_timer_, &QTimer::timeout, this, [this]() {
+        // Redraw with any subdivision levels that finished building in the background
+        if (SubdivisionCache::Instance().TakeFinishedBuilds()) needs_update_ = true;
         for (auto k : keys_down_) {
             camera_velocity_ += cameraControls.at(k);
         }
@@ -19,7 +19,7 @@ std::map<FileType, QString> FilePicker::FileFilters = {
     {FileType::Curve, QString::fromStdString("Curve Files (*.apts)")},
     {FileType::Image, QString::fromStdString("Image Files (*.jpg *.jpeg *.png *.bmp *.tga *.psd)")},
     {FileType::Mesh, QString::fromStdString("Mesh Files (*.obj *.ply *.stl)")},
-    {FileType::Scene, QString::fromStdString("Scene Files (*.yaml)")},
+    {FileType::Scene, QString::fromStdString("Scene Files (*.yaml *.scene)")},
     {FileType::Points, QString::fromStdString("Point Sample Files (*.apts)")},
     {FileType::Ray, QString::fromStdString("Ray File (*.ray)")}
 };
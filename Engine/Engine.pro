@@ -20,6 +20,7 @@ HEADERS +=  src/components.h \
     src/exceptions.h \
     src/fileio.h \
     src/forward.h \
+    src/mapvaluerange.h \
     src/properties.h \
     src/resources.h \
     src/shadervars.h \
@@ -36,9 +37,15 @@ HEADERS +=  src/components.h \
     src/properties/property.h \
     src/properties/resourceproperty.h \
     src/properties/vec3property.h \
+    src/properties/propertybatch.h \
     src/resource/asset.h \
     src/resource/assetmanager.h \
     src/resource/importers.h \
+    src/resource/meshcache.h \
+    src/resource/revolutioncache.h \
+    src/resource/subdivisioncache.h \
+    src/resource/texturecompression.h \
+    src/resource/texturecache.h \
     src/resource/material.h \
     src/resource/mesh.h \
     src/resource/shaderprogram.h \
@@ -46,8 +53,11 @@ HEADERS +=  src/components.h \
     src/resource/texture.h \
     src/scene/renderer.h \
     src/scene/scene.h \
+    src/scene/simulationclock.h \
     src/scene/scenecamera.h \
     src/scene/sceneobject.h \
+    src/scene/transformbatch.h \
+    src/scene/yamlscenereader.h \
     src/scene/trackball.h \
     src/scene/translator.h \
     src/scene/components/camera.h \
@@ -79,12 +89,16 @@ HEADERS +=  src/components.h \
     src/animation/catmullromcurveevaluator.h \
     src/animation/bsplinecurveevaluator.h \
     src/animation/keyframe.h \
+    src/animation/compiledcurve.h \
+    src/animation/cubicsegments.h \
     src/scene/scenemanager.h \
     src/glextinclude.h \
     src/scene/scaler.h \
     src/scene/rotator.h \
     src/scene/components/ring.h \
     src/meshprocessing.h \
+    src/meshadjacency.h \
+    src/parallelfor.h \
     src/scene/components/spherecollider.h \
     src/scene/components/planecollider.h \
     src/scene/components/cylindercollider.h \
@@ -108,6 +122,7 @@ HEADERS +=  src/components.h \
     src/trace/randomsampler.h \
     src/trace/tracesceneobject.h \
     src/serializable.h \
+    src/binarystream.h \
     src/properties/propertygroup.h \
     src/singleton.h \
     src/scene/components/robotarmprop.h \
@@ -126,15 +141,23 @@ SOURCES +=  src/debug/debug.cpp \
     src/properties/property.cpp \
     src/properties/resourceproperty.cpp \
     src/properties/vec3property.cpp \
+    src/properties/propertybatch.cpp \
     src/resource/asset.cpp \
     src/resource/assetmanager.cpp \
     src/resource/importers.cpp \
+    src/resource/meshcache.cpp \
+    src/resource/revolutioncache.cpp \
+    src/resource/subdivisioncache.cpp \
+    src/resource/texturecompression.cpp \
+    src/resource/texturecache.cpp \
     src/resource/material.cpp \
     src/resource/mesh.cpp \
     src/resource/texture.cpp \
     src/scene/scene.cpp \
     src/scene/scenecamera.cpp \
     src/scene/sceneobject.cpp \
+    src/scene/transformbatch.cpp \
+    src/scene/yamlscenereader.cpp \
     src/scene/trackball.cpp \
     src/scene/translator.cpp \
     src/scene/components/camera.cpp \
@@ -158,11 +181,14 @@ SOURCES +=  src/debug/debug.cpp \
     src/animation/beziercurveevaluator.cpp \
     src/animation/catmullromcurveevaluator.cpp \
     src/animation/bsplinecurveevaluator.cpp \
+    src/animation/compiledcurve.cpp \
+    src/animation/cubicsegments.cpp \
     src/scene/scenemanager.cpp \
     src/scene/scaler.cpp \
     src/scene/rotator.cpp \
     src/scene/components/ring.cpp \
     src/meshprocessing.cpp \
+    src/meshadjacency.cpp \
     src/scene/components/spherecollider.cpp \
     src/scene/components/planecollider.cpp \
     src/scene/components/cylindercollider.cpp \
@@ -184,6 +210,7 @@ SOURCES +=  src/debug/debug.cpp \
     src/trace/randomsampler.cpp \
     src/trace/tracesceneobject.cpp \
     src/serializable.cpp \
+    src/binarystream.cpp \
     src/properties/propertygroup.cpp \
     src/scene/components/robotarmprop.cpp \
     src/scene/components/customprop.cpp
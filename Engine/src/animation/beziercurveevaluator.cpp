@@ -64,3 +64,31 @@ std::vector<glm::vec2> BezierCurveEvaluator::EvaluateCurve(const std::vector<glm
 
 
 }
+
+bool BezierCurveEvaluator::EvaluateSegments(const std::vector<glm::vec2>& ctrl_pts, CubicSegments& segments,
+                                            size_t first_changed, size_t last_changed) const {
+    if (ctrl_pts.size() <= 2) {
+        EvaluateLineSegments(ctrl_pts, segments, first_changed, last_changed);
+        return true;
+    }
+    // Same control points as EvaluateCurve, with the first point repeated one period later when wrapping
+    const size_t num_pts = ctrl_pts.size() + (wrap_y_ ? 1 : 0);
+    auto point = [&] (size_t k) {
+        return k < ctrl_pts.size() ? ctrl_pts[k] : glm::vec2(ctrl_pts[0].x + max_x_, ctrl_pts[0].y);
+    };
+    const size_t total_group = (num_pts - 1) / 3;
+    const size_t remain_lines = num_pts - 1 - total_group * 3;
+    segments.Resize(total_group + remain_lines);
+
+    for (size_t i = 0; i < total_group; i++) {
+        if (!DependsOn(3*i, 3*i+3, first_changed, last_changed)) continue;
+        segments.SetBezier(i, point(3*i), point(3*i+1), point(3*i+2), point(3*i+3));
+    }
+    // Points that don't make up a full bezier group are connected linearly
+    for (size_t i = 0; i < remain_lines; i++) {
+        size_t k = total_group * 3 + i;
+        if (!DependsOn(k, k+1, first_changed, last_changed)) continue;
+        segments.SetLine(total_group + i, point(k), point(k+1));
+    }
+    return true;
+}
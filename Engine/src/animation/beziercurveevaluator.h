@@ -19,6 +19,8 @@ public:
 			: CurveEvaluator(animation_length, wrap) {}
 
     virtual std::vector<glm::vec2> EvaluateCurve(const std::vector<glm::vec2>& ctrl_pts, int density) const override;
+    virtual bool EvaluateSegments(const std::vector<glm::vec2>& ctrl_pts, CubicSegments& segments,
+                                  size_t first_changed = 0, size_t last_changed = ~size_t(0)) const override;
 };
 
 #endif // BEZIERCURVEEVALUATOR_H
\ No newline at end of file
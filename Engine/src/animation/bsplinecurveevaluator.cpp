@@ -69,10 +69,33 @@ std::vector<glm::vec2> BSplineCurveEvaluator::EvaluateCurve(const std::vector<gl
     return evaluated_pts;
     }
 
+bool BSplineCurveEvaluator::EvaluateSegments(const std::vector<glm::vec2>& ctrl_pts, CubicSegments& segments,
+                                             size_t first_changed, size_t last_changed) const {
+    if (ctrl_pts.size() <= 2) {
+        EvaluateLineSegments(ctrl_pts, segments, first_changed, last_changed);
+        return true;
+    }
+    // Same control points as EvaluateCurve: the end points tripled, or the neighbouring period's points when wrapping
+    const size_t num_pts = ctrl_pts.size();
+    const glm::vec2 before = wrap_y_ ? glm::vec2(ctrl_pts.back().x - max_x_, ctrl_pts.back().y) : ctrl_pts[0];
+    const glm::vec2 after = wrap_y_ ? glm::vec2(ctrl_pts[0].x + max_x_, ctrl_pts[0].y) : ctrl_pts.back();
+    auto point = [&] (size_t k) {
+        if (k < 2) return before;
+        if (k - 2 < num_pts) return ctrl_pts[k-2];
+        return after;
+    };
+    segments.Resize(num_pts + 1);
 
-
-
-
-
-
-
+    for (size_t i = 1; i <= num_pts + 1; i++) {
+        // Each segment depends on four consecutive de Boor points
+        if (!DependsOn((long) i - 3, i, first_changed, last_changed)) continue;
+        glm::vec2 v0 = point(i-1)/6.0f + 2.0f * point(i)/3.0f + point(i+1)/6.0f;
+        glm::vec2 v1 = 2.0f * point(i)/3.0f + point(i+1)/3.0f;
+        glm::vec2 v2 = point(i)/3.0f + 2.0f * point(i+1)/3.0f;
+        glm::vec2 v3 = point(i)/6.0f + 2.0f * point(i+1)/3.0f + point(i+2)/6.0f;
+        if (v1.x > v3.x) v1.x = v3.x;
+        if (v0.x > v2.x) v2.x = v0.x;
+        segments.SetBezier(i - 1, v0, v1, v2, v3);
+    }
+    return true;
+}
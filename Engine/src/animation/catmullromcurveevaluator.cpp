@@ -69,3 +69,37 @@ std::vector<glm::vec2> CatmullRomCurveEvaluator::EvaluateCurve(const std::vector
     if (extend_x_) ExtendX(evaluated_pts, ctrl_pts);
     return evaluated_pts;
 }
+
+bool CatmullRomCurveEvaluator::EvaluateSegments(const std::vector<glm::vec2>& ctrl_pts, CubicSegments& segments,
+                                                size_t first_changed, size_t last_changed) const {
+    if (ctrl_pts.size() <= 2) {
+        EvaluateLineSegments(ctrl_pts, segments, first_changed, last_changed);
+        return true;
+    }
+    // Same control points as EvaluateCurve: the first point doubled, the wrap point (if wrapping), then the last point
+    const size_t num_pts = ctrl_pts.size();
+    const size_t size = wrap_y_ ? num_pts + 1 : num_pts;
+    auto point = [&] (size_t k) {
+        if (k == 0) return ctrl_pts[0];
+        if (k <= num_pts) return ctrl_pts[k-1];
+        if (wrap_y_ && k == num_pts + 1) return glm::vec2(ctrl_pts[0].x + max_x_, ctrl_pts[0].y);
+        return ctrl_pts.back();
+    };
+    segments.Resize(size - 1);
+
+    for (size_t i = 1; i < size; i++) {
+        // Segment i spans points i and i+1, and takes its tangents from their neighbours
+        if (!DependsOn((long) i - 2, i + 1, first_changed, last_changed)) continue;
+        glm::vec2 v0 = point(i);
+        glm::vec2 v1 = point(i) + (point(i+1) - point(i-1)) / 6.0f;
+        glm::vec2 v2 = point(i+1) - (point(i+2) - point(i)) / 6.0f;
+        glm::vec2 v3 = point(i+1);
+        if (wrap_y_ && i == 1) {
+            v1 = point(i) + (point(size) - point(size - 1)) / 6.0f;
+        }
+        if (v1.x > v3.x) v1.x = v3.x;
+        if (v0.x > v2.x) v2.x = v0.x;
+        segments.SetBezier(i - 1, v0, v1, v2, v3);
+    }
+    return true;
+}
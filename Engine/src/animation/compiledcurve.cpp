@@ -0,0 +1,114 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#include "compiledcurve.h"
+#include <animation/linearcurveevaluator.h>
+#include <animation/beziercurveevaluator.h>
+#include <animation/bsplinecurveevaluator.h>
+#include <animation/catmullromcurveevaluator.h>
+#include <algorithm>
+
+void CompiledCurve::Compile(CurveType curve_type, const std::vector<glm::vec2>& ctrl_pts, float animation_length, bool wrap) {
+    if (ctrl_pts.empty()) {
+        ctrl_pts_.clear();
+        SetPoints({glm::vec2(0, 0), glm::vec2(animation_length, 0)});
+        return;
+    }
+
+    // When the same control points have only moved, find the range of points that changed
+    size_t first_changed = 0;
+    size_t last_changed = ctrl_pts.size() - 1;
+    bool same_curve = !segments_.IsEmpty() && curve_type == curve_type_ && animation_length == animation_length_
+            && wrap == wrap_ && ctrl_pts.size() == ctrl_pts_.size();
+    if (same_curve) {
+        while (first_changed < ctrl_pts.size() && ctrl_pts[first_changed] == ctrl_pts_[first_changed]) first_changed++;
+        if (first_changed == ctrl_pts.size()) return; // Nothing changed
+        while (ctrl_pts[last_changed] == ctrl_pts_[last_changed]) last_changed--;
+    }
+
+    curve_type_ = curve_type;
+    animation_length_ = animation_length;
+    wrap_ = wrap;
+    ctrl_pts_ = ctrl_pts;
+
+    std::unique_ptr<CurveEvaluator> curve_evaluator(CreateEvaluator(curve_type, animation_length, wrap));
+    if (same_curve) {
+        curve_evaluator->EvaluateSegments(ctrl_pts, segments_, first_changed, last_changed);
+        TessellateSegments();
+    } else if (curve_evaluator->EvaluateSegments(ctrl_pts, segments_)) {
+        TessellateSegments();
+    } else {
+        SetPoints(curve_evaluator->EvaluateCurve(ctrl_pts, 0));
+    }
+}
+
+void CompiledCurve::SetPoints(std::vector<glm::vec2> points) {
+    segments_.Clear();
+    points_ = std::move(points);
+    // Approximating curves may wander backwards in time; keep the points ordered so we can binary search
+    std::stable_sort(points_.begin(), points_.end(), [] (const glm::vec2& a, const glm::vec2& b) { return a.x < b.x; });
+}
+
+float CompiledCurve::SampleAt(float t) const {
+    if (!segments_.IsEmpty()) {
+        // A wrapped curve runs one period past its first point, which covers the start of the animation
+        if (wrap_ && t < segments_.GetStartTime()) t += animation_length_;
+        return segments_.SampleAt(t);
+    }
+    if (points_.empty()) return 0.0f;
+    // First point strictly after t
+    auto next = std::upper_bound(points_.begin(), points_.end(), t, [] (float t, const glm::vec2& p) { return t < p.x; });
+    if (next == points_.begin()) return points_.front().y;
+    if (next == points_.end()) return points_.back().y;
+    auto prev = next - 1;
+    float dx = next->x - prev->x;
+    if (dx <= 0.0f) return next->y;
+    float u = (t - prev->x) / dx;
+    return prev->y + u * (next->y - prev->y);
+}
+
+void CompiledCurve::TessellateSegments() {
+    points_.clear();
+    segments_.Tessellate(0, points_);
+    if (wrap_) {
+        // Move the part past the end of the animation around to the front
+        auto wrapped = std::find_if(points_.begin(), points_.end(), [this] (const glm::vec2& p) { return p.x > animation_length_; });
+        if (wrapped != points_.begin() && wrapped != points_.end()) {
+            // Split the polyline at the end of the animation so both halves reach the boundary
+            glm::vec2 a = *(wrapped - 1);
+            glm::vec2 b = *wrapped;
+            float y = a.y + (b.y - a.y) * (animation_length_ - a.x) / (b.x - a.x);
+            wrapped = points_.insert(wrapped, {glm::vec2(animation_length_, y), glm::vec2(animation_length_, y)}) + 1;
+        }
+        // Only the part before the start of the curve is sampled from the wrapped end
+        float start = segments_.GetStartTime();
+        auto end = std::remove_if(wrapped, points_.end(), [&] (const glm::vec2& p) { return p.x - animation_length_ >= start; });
+        points_.erase(end, points_.end());
+        for (auto it = wrapped; it != points_.end(); it++) it->x -= animation_length_;
+        std::stable_sort(points_.begin(), points_.end(), [] (const glm::vec2& a, const glm::vec2& b) { return a.x < b.x; });
+    } else {
+        // Hold the end values out to the ends of the animation
+        if (points_.back().x < animation_length_) points_.push_back(glm::vec2(animation_length_, points_.back().y));
+        if (points_.front().x > 0) points_.insert(points_.begin(), glm::vec2(0, points_.front().y));
+    }
+}
+
+CurveEvaluator* CompiledCurve::CreateEvaluator(CurveType curve_type, float animation_length, bool wrap) {
+    switch (curve_type) {
+        case CurveType::Bezier:
+            return new BezierCurveEvaluator(animation_length, wrap);
+        case CurveType::CatmullRom:
+            return new CatmullRomCurveEvaluator(animation_length, wrap);
+        case CurveType::BSpline:
+            return new BSplineCurveEvaluator(animation_length, wrap);
+        case CurveType::Linear:
+        default:
+            return new LinearCurveEvaluator(animation_length, wrap);
+    }
+}
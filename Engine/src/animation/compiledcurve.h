@@ -0,0 +1,58 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#ifndef COMPILEDCURVE_H
+#define COMPILEDCURVE_H
+
+#include <animator.h>
+#include <vectors.h>
+#include <animation/cubicsegments.h>
+
+class CurveEvaluator;
+
+// A curve that has been evaluated once into cubic segments (or a polyline, for evaluators
+// that can't produce segments) sorted by time. Sampling does a binary search over the cached
+// curve instead of re-evaluating the spline, and does not depend on how the curve is displayed.
+class CompiledCurve {
+public:
+    CompiledCurve() : curve_type_(CurveType::Linear), animation_length_(0.0f), wrap_(false) {}
+
+    // Evaluates the control points (sorted by time) with the evaluator for the given curve type
+    // and caches the result. With no control points the curve is flat at zero.
+    // If only the positions of some control points changed since the last compile, only the
+    // segments that depend on them are rebuilt.
+    void Compile(CurveType curve_type, const std::vector<glm::vec2>& ctrl_pts, float animation_length, bool wrap);
+
+    // Caches an already evaluated polyline, dropping any cubic segments; the points are sorted by time.
+    void SetPoints(std::vector<glm::vec2> points);
+    // Polyline through the curve over the whole animation, for display.
+    const std::vector<glm::vec2>& GetPoints() const { return points_; }
+    const CubicSegments& GetSegments() const { return segments_; }
+
+    // Samples the curve at time t, either exactly from its cubic segments or by linearly
+    // interpolating the cached polyline. Times outside of the curve take the value of the nearest end point.
+    float SampleAt(float t) const;
+
+    // Creates the curve evaluator for the given curve type. The caller owns the evaluator.
+    static CurveEvaluator* CreateEvaluator(CurveType curve_type, float animation_length, bool wrap);
+
+protected:
+    std::vector<glm::vec2> points_;
+    CubicSegments segments_;
+    // What segments_ was compiled from, to find out which segments an edit touches
+    std::vector<glm::vec2> ctrl_pts_;
+    CurveType curve_type_;
+    float animation_length_;
+    bool wrap_;
+
+    // Rebuilds the display polyline from the cubic segments
+    void TessellateSegments();
+};
+
+#endif // COMPILEDCURVE_H
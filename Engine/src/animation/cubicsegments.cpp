@@ -0,0 +1,95 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#include "cubicsegments.h"
+#include <algorithm>
+
+void CubicSegments::Clear() {
+    Resize(0);
+}
+
+void CubicSegments::Resize(size_t count) {
+    for (auto coeffs : {&ax_, &bx_, &cx_, &dx_, &ay_, &by_, &cy_, &dy_, &end_x_})
+        coeffs->resize(count, 0.0f);
+}
+
+void CubicSegments::SetBezier(size_t i, const glm::vec2& v0, const glm::vec2& v1, const glm::vec2& v2, const glm::vec2& v3) {
+    assert(i < GetCount());
+    glm::vec2 a = -v0 + 3.0f*v1 - 3.0f*v2 + v3;
+    glm::vec2 b = 3.0f*v0 - 6.0f*v1 + 3.0f*v2;
+    glm::vec2 c = -3.0f*v0 + 3.0f*v1;
+    ax_[i] = a.x; bx_[i] = b.x; cx_[i] = c.x; dx_[i] = v0.x;
+    ay_[i] = a.y; by_[i] = b.y; cy_[i] = c.y; dy_[i] = v0.y;
+    end_x_[i] = v3.x;
+}
+
+void CubicSegments::SetLine(size_t i, const glm::vec2& p0, const glm::vec2& p1) {
+    assert(i < GetCount());
+    glm::vec2 c = p1 - p0;
+    ax_[i] = 0.0f; bx_[i] = 0.0f; cx_[i] = c.x; dx_[i] = p0.x;
+    ay_[i] = 0.0f; by_[i] = 0.0f; cy_[i] = c.y; dy_[i] = p0.y;
+    end_x_[i] = p1.x;
+}
+
+glm::vec2 CubicSegments::Evaluate(size_t i, float u) const {
+    float x = ((ax_[i]*u + bx_[i])*u + cx_[i])*u + dx_[i];
+    float y = ((ay_[i]*u + by_[i])*u + cy_[i])*u + dy_[i];
+    return glm::vec2(x, y);
+}
+
+float CubicSegments::SampleAt(float t) const {
+    if (IsEmpty()) return 0.0f;
+    if (t <= dx_.front()) return dy_.front();
+    size_t i = FindSegment(t);
+    if (i == GetCount()) return Evaluate(i - 1, 1.0f).y;
+    float u = SolveForU(i, t);
+    return ((ay_[i]*u + by_[i])*u + cy_[i])*u + dy_[i];
+}
+
+void CubicSegments::Tessellate(int density, std::vector<glm::vec2>& out_pts) const {
+    if (IsEmpty()) return;
+    if (density <= 0) density = 100;
+    out_pts.push_back(Evaluate(0, 0.0f));
+    for (size_t i = 0; i < GetCount(); i++) {
+        // Segments share their end points, so skip the first point of each one
+        int steps = IsLine(i) ? 1 : density;
+        for (int j = 1; j <= steps; j++) out_pts.push_back(Evaluate(i, j / (float) steps));
+    }
+}
+
+size_t CubicSegments::FindSegment(float t) const {
+    return std::lower_bound(end_x_.begin(), end_x_.end(), t) - end_x_.begin();
+}
+
+float CubicSegments::SolveForU(size_t i, float t) const {
+    float x0 = dx_[i];
+    float span = end_x_[i] - x0;
+    // A vertical segment jumps at t; take the value after the jump
+    if (span <= 0.0f) return 1.0f;
+    float tolerance = span * 1e-6f;
+
+    // Start from the linear guess, which is exact for lines and evenly spaced control points
+    float lo = 0.0f, hi = 1.0f;
+    float u = glm::clamp((t - x0) / span, 0.0f, 1.0f);
+    for (unsigned int iteration = 0; iteration < MAX_ITERATIONS; iteration++) {
+        float error = ((ax_[i]*u + bx_[i])*u + cx_[i])*u + x0 - t;
+        if (std::abs(error) <= tolerance) break;
+        if (error < 0.0f) lo = u;
+        else hi = u;
+        float slope = (3.0f*ax_[i]*u + 2.0f*bx_[i])*u + cx_[i];
+        float next = slope > 0.0f ? u - error / slope : lo;
+        // Bisect whenever Newton's step leaves the bracket
+        u = (next > lo && next < hi) ? next : 0.5f * (lo + hi);
+    }
+    return u;
+}
+
+bool CubicSegments::IsLine(size_t i) const {
+    return ax_[i] == 0.0f && bx_[i] == 0.0f && ay_[i] == 0.0f && by_[i] == 0.0f;
+}
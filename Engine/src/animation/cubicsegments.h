@@ -0,0 +1,65 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#ifndef CUBICSEGMENTS_H
+#define CUBICSEGMENTS_H
+
+#include <animator.h>
+#include <vectors.h>
+
+// A piecewise cubic curve y(x) made of Bezier segments ordered by x (time).
+// Each segment is stored as power basis coefficients in structure-of-arrays layout, so evaluating
+// a segment is a couple of Horner steps. Sampling at a time t finds the segment by binary search
+// and inverts x(u) = t with Newton's method, falling back to bisection. Segments are assumed
+// to be monotone in x, which holds when their x control values are non-decreasing.
+class CubicSegments {
+public:
+    static const unsigned int MAX_ITERATIONS = 20;
+
+    size_t GetCount() const { return dx_.size(); }
+    bool IsEmpty() const { return dx_.empty(); }
+    void Clear();
+    // Changes the number of segments. New segments are flat at zero until they are set.
+    void Resize(size_t count);
+
+    // Sets segment i to the cubic Bezier with control points v0, v1, v2, v3.
+    void SetBezier(size_t i, const glm::vec2& v0, const glm::vec2& v1, const glm::vec2& v2, const glm::vec2& v3);
+    // Sets segment i to the straight line from p0 to p1.
+    void SetLine(size_t i, const glm::vec2& p0, const glm::vec2& p1);
+
+    // Time at the start of the first segment and end of the last segment. The curve must not be empty.
+    float GetStartTime() const { return dx_.front(); }
+    float GetEndTime() const { return end_x_.back(); }
+
+    // Evaluates segment i at parameter u in [0, 1].
+    glm::vec2 Evaluate(size_t i, float u) const;
+
+    // Samples the curve value at time t.
+    // Times outside of the curve take the value of the nearest end point.
+    float SampleAt(float t) const;
+
+    // Appends a polyline through the curve to out_pts, using density points per curved segment.
+    // Straight segments only add their end point.
+    void Tessellate(int density, std::vector<glm::vec2>& out_pts) const;
+
+protected:
+    // Returns the first segment that ends at or after time t
+    size_t FindSegment(float t) const;
+    // Returns the parameter u of segment i where x(u) = t
+    float SolveForU(size_t i, float t) const;
+    bool IsLine(size_t i) const;
+
+    // p(u) = ((a*u + b)*u + c)*u + d for each segment
+    std::vector<float> ax_, bx_, cx_, dx_;
+    std::vector<float> ay_, by_, cy_, dy_;
+    // Segment end times, kept in their own array so the binary search only touches one cache line per step
+    std::vector<float> end_x_;
+};
+
+#endif // CUBICSEGMENTS_H
@@ -11,12 +11,21 @@
 #define CURVEEVALUATOR_H
 
 #include <vectors.h>
+#include <animation/cubicsegments.h>
 
 class CurveEvaluator {
 public:
     CurveEvaluator() : wrap_y_(false), extend_x_(false), max_x_(0.f) {}
 	CurveEvaluator(float animation_length, bool wrap) : wrap_y_(wrap), extend_x_(true), max_x_(animation_length) {}
     virtual std::vector<glm::vec2> EvaluateCurve(const std::vector<glm::vec2>& ctrl_pts, int density) const = 0;
+    // Builds the curve for the (time sorted) control points as cubic segments, without the extension
+    // to the ends of the animation. If segments already holds this curve for the same number of control
+    // points, only the segments that depend on control points first_changed through last_changed are rebuilt.
+    // Returns false if the evaluator can only produce a polyline.
+    virtual bool EvaluateSegments(const std::vector<glm::vec2>& ctrl_pts, CubicSegments& segments,
+                                  size_t first_changed = 0, size_t last_changed = ~size_t(0)) const {
+        return false;
+    }
     virtual ~CurveEvaluator() {}
     void Wrap(bool wrap = true) { wrap_y_ = wrap; }
 protected:
@@ -38,6 +47,26 @@ protected:
                 out_pts.insert(out_pts.begin(), glm::vec2(0, in_pts[0].y));
         }
     }
+    // Connects the control points with lines, closing the loop back to the first point when wrapping.
+    void EvaluateLineSegments(const std::vector<glm::vec2>& ctrl_pts, CubicSegments& segments,
+                              size_t first_changed, size_t last_changed) const {
+        if (ctrl_pts.size() == 1) {
+            segments.Resize(1);
+            segments.SetLine(0, ctrl_pts[0], ctrl_pts[0]);
+            return;
+        }
+        size_t num_lines = ctrl_pts.size() - 1;
+        segments.Resize(wrap_y_ ? num_lines + 1 : num_lines);
+        for (size_t i = 0; i < num_lines; i++)
+            if (DependsOn(i, i + 1, first_changed, last_changed)) segments.SetLine(i, ctrl_pts[i], ctrl_pts[i+1]);
+        if (wrap_y_) segments.SetLine(num_lines, ctrl_pts.back(), glm::vec2(ctrl_pts[0].x + max_x_, ctrl_pts[0].y));
+    }
+    // Whether a segment built from control points first through last needs rebuilding after a change
+    // to control points first_changed through last_changed. Wrapped curves tie both ends together, so always rebuild them.
+    bool DependsOn(long first, long last, size_t first_changed, size_t last_changed) const {
+        if (wrap_y_) return true;
+        return last >= (long) first_changed && (first <= 0 || (size_t) first <= last_changed);
+    }
     bool wrap_y_;
     bool extend_x_;
     float max_x_;
@@ -32,6 +32,12 @@ public:
         if (extend_x_) ExtendX(evaluated_pts, ctrl_pts);
         return evaluated_pts;
     }
+
+    virtual bool EvaluateSegments(const std::vector<glm::vec2>& ctrl_pts, CubicSegments& segments,
+                                  size_t first_changed = 0, size_t last_changed = ~size_t(0)) const override {
+        EvaluateLineSegments(ctrl_pts, segments, first_changed, last_changed);
+        return true;
+    }
 };
 
 #endif // LINEARCURVEEVALUATOR_H
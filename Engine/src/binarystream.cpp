@@ -0,0 +1,76 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#include "binarystream.h"
+#include <animator.h>
+
+void BinaryWriter::WriteString(const std::string& value) {
+    WriteUInt32(value.size());
+    Write(value.data(), value.size());
+}
+
+void BinaryWriter::WriteFloats(const std::vector<float>& values) {
+    WriteUInt32(values.size());
+    Write(values.data(), values.size() * sizeof(float));
+}
+
+size_t BinaryWriter::BeginBlock() {
+    WriteUInt32(0);
+    return data_.size();
+}
+
+void BinaryWriter::EndBlock(size_t block) {
+    uint32_t size = data_.size() - block;
+    std::memcpy(&data_[block - sizeof(uint32_t)], &size, sizeof(uint32_t));
+}
+
+void BinaryWriter::Write(const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    data_.insert(data_.end(), bytes, bytes + size);
+}
+
+BinaryReader::BinaryReader(const char* data, size_t size, uint32_t version) :
+    data_(data),
+    size_(size),
+    position_(0),
+    version_(version)
+{
+}
+
+std::string BinaryReader::ReadString() {
+    uint32_t size = ReadUInt32();
+    return std::string(ReadBytes(size), size);
+}
+
+std::vector<float> BinaryReader::ReadFloats() {
+    uint32_t count = ReadUInt32();
+    // Check the count against the data left before allocating anything for it
+    const char* bytes = ReadBytes((size_t) count * sizeof(float));
+    std::vector<float> values(count);
+    if (count > 0) std::memcpy(values.data(), bytes, count * sizeof(float));
+    return values;
+}
+
+const char* BinaryReader::ReadBytes(size_t size) {
+    if (size > size_ - position_) throw FileIOException("Unexpected end of binary data");
+    const char* bytes = data_ + position_;
+    position_ += size;
+    return bytes;
+}
+
+size_t BinaryReader::BeginBlock() {
+    uint32_t size = ReadUInt32();
+    if (size > size_ - position_) throw FileIOException("Unexpected end of binary data");
+    return position_ + size;
+}
+
+void BinaryReader::Seek(size_t position) {
+    if (position > size_) throw FileIOException("Unexpected end of binary data");
+    position_ = position;
+}
@@ -0,0 +1,86 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#ifndef BINARYSTREAM_H
+#define BINARYSTREAM_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Encoding used by binary scene files. Values are stored in host byte order, which is
+// little-endian on every platform we build for. Strings and float arrays are prefixed by their length.
+class BinaryWriter {
+public:
+    void WriteUInt8(uint8_t value) { WriteRaw(value); }
+    void WriteUInt32(uint32_t value) { WriteRaw(value); }
+    void WriteInt32(int32_t value) { WriteRaw(value); }
+    void WriteFloat(float value) { WriteRaw(value); }
+    void WriteDouble(double value) { WriteRaw(value); }
+    void WriteString(const std::string& value);
+    void WriteFloats(const std::vector<float>& values);
+
+    // Starts a block that is prefixed by its size in bytes, so a reader can skip it.
+    // Returns where the block starts, to be passed to EndBlock.
+    size_t BeginBlock();
+    void EndBlock(size_t block);
+
+    const std::vector<char>& GetData() const { return data_; }
+
+private:
+    std::vector<char> data_;
+
+    void Write(const void* data, size_t size);
+    template <typename T>
+    void WriteRaw(const T& value) { Write(&value, sizeof(T)); }
+};
+
+// Reads what a BinaryWriter wrote from memory that is not owned, e.g. a memory-mapped file.
+// Throws a FileIOException when asked to read past the end of the data.
+class BinaryReader {
+public:
+    BinaryReader(const char* data, size_t size, uint32_t version = 0);
+
+    // Version of the file being read, for types whose encoding changed between versions
+    uint32_t GetVersion() const { return version_; }
+    void SetVersion(uint32_t version) { version_ = version; }
+
+    uint8_t ReadUInt8() { return ReadRaw<uint8_t>(); }
+    uint32_t ReadUInt32() { return ReadRaw<uint32_t>(); }
+    int32_t ReadInt32() { return ReadRaw<int32_t>(); }
+    float ReadFloat() { return ReadRaw<float>(); }
+    double ReadDouble() { return ReadRaw<double>(); }
+    std::string ReadString();
+    std::vector<float> ReadFloats();
+    // Reads size bytes as they are, returning a pointer into the data
+    const char* ReadBytes(size_t size);
+
+    // Reads the size of a block written with BeginBlock. Returns the position the block ends at.
+    size_t BeginBlock();
+    size_t GetPosition() const { return position_; }
+    // Moves to a position, such as the end of a block that was only partially understood
+    void Seek(size_t position);
+
+private:
+    const char* data_;
+    size_t size_;
+    size_t position_;
+    uint32_t version_;
+
+    // The data may not be aligned, so values are copied out of it
+    template <typename T>
+    T ReadRaw() {
+        T value;
+        std::memcpy(&value, ReadBytes(sizeof(T)), sizeof(T));
+        return value;
+    }
+};
+
+#endif // BINARYSTREAM_H
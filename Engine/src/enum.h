@@ -26,6 +26,13 @@ enum class MeshType {
     Lines
 };
 
+// How a texture's pixels are stored: plain RGBA, or in 4x4 blocks (BC1 for opaque images, BC3 with alpha)
+enum class TextureFormat {
+    RGBA8,
+    BC1,
+    BC3
+};
+
 enum class ShaderType {
     Vertex,
     Fragment,
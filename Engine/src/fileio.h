@@ -12,6 +12,9 @@
 
 #include <animator.h>
 #include <vectors.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
 
 // Basic disk IO operations
 class FileIO
@@ -55,6 +58,22 @@ public:
         file.close();
     }
 
+    // Writes the bytes into a file (overwrite).
+    // Throws a FileIOException if an error occurred.
+    static void WriteBinaryFile(const std::string& filename, const std::vector<char>& data) {
+        std::ofstream file(filename.c_str(), std::ofstream::out | std::ofstream::binary);
+
+        // Check if the file was actually opened
+        if(!file.is_open()) throw FileIOException("Cannot open file \"" + filename + "\": " + strerror(errno));
+
+        file.write(data.data(), data.size());
+
+        // Check if Badbit is set
+        if(file.bad()) throw FileIOException("Error occurred while writing to file \"" + filename + "\": " + strerror(errno));
+
+        file.close();
+    }
+
     // Reads the Curve file which comprises on each line a pair of decimal numbers X, Y delimited by a whitespace character
     // It may or may not contain lines with a single '-' character indicating that the Curve file contains another version
     // of the curve with different number of points.
@@ -69,32 +88,48 @@ public:
     //      ...
     // Throws a FileIOException if an error occurred.
     static std::vector<std::vector<glm::vec2>> ReadCurveFile(const std::string& filename) {
-        std::vector<std::vector<glm::vec2>> points;
-        points.emplace_back(std::vector<glm::vec2>());
-        int current_list = 0;
-        std::ifstream file(filename.c_str(), std::ifstream::in);
+        std::ifstream file(filename.c_str(), std::ifstream::in | std::ifstream::binary);
 
         // Check if the file was actually opened
         if(!file.is_open()) throw FileIOException("Cannot open file \"" + filename + "\": " + strerror(errno));
 
-        // Read the file line by line
-        std::string line;
-        while(std::getline(file, line)) {
-            if (line == "-") {
-                points.emplace_back(std::vector<glm::vec2>());
-                current_list++;
-            } else {
-                size_t index = line.find(' ');
-                std::string x_str = line.substr(0, index);
-                std::string y_str = line.substr(index + 1, line.size());
-                points.at(current_list).emplace_back(glm::vec2(std::stof(x_str), std::stof(y_str)));
-            }
-        }
+        // Read the whole file in one go and parse it in place, without a string per line or number
+        std::string text;
+        file.seekg(0, std::ifstream::end);
+        text.resize((size_t) std::max<std::streamoff>(file.tellg(), 0));
+        file.seekg(0, std::ifstream::beg);
+        file.read(&text[0], text.size());
 
         // Check if Badbit is set
         if(file.bad()) throw FileIOException("Error occurred while reading file \"" + filename + "\": " + strerror(errno));
-
         file.close();
+
+        std::vector<std::vector<glm::vec2>> points;
+        points.emplace_back(std::vector<glm::vec2>());
+        const char* line = text.c_str();
+        const char* text_end = line + text.size();
+        while (line < text_end) {
+            const char* line_end = std::find(line, text_end, '\n');
+            // Skip blank lines and the '\r' of files with Windows line endings
+            const char* first = line;
+            const char* last = line_end;
+            while (first < last && isspace((unsigned char) *first)) first++;
+            while (last > first && isspace((unsigned char) last[-1])) last--;
+            if (last - first == 1 && *first == '-') {
+                points.emplace_back(std::vector<glm::vec2>());
+            } else if (first < last) {
+                // strtof also skips newlines, so check each number ends on this line
+                char* x_end;
+                char* y_end;
+                float x = strtof(first, &x_end);
+                float y = strtof(x_end, &y_end);
+                if (x_end == first || y_end == x_end || y_end > last) {
+                    throw FileIOException("Invalid point \"" + std::string(first, last) + "\" in curve file \"" + filename + "\"");
+                }
+                points.back().emplace_back(x, y);
+            }
+            line = line_end + 1;
+        }
         return points;
     }
 };
@@ -0,0 +1,52 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#ifndef MAPVALUERANGE_H
+#define MAPVALUERANGE_H
+
+#include <iterator>
+#include <cstddef>
+
+// Read-only view over the values of a map (e.g. a SceneObject's children or components)
+// that can be used in range-based for loops without copying the values out into a vector.
+// Like any iterator it is invalidated if elements are erased from the map while iterating,
+// so copy it into a vector first when the loop removes entries.
+template<typename Map>
+class MapValueRange {
+public:
+    class iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename Map::mapped_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const value_type* pointer;
+        typedef const value_type& reference;
+
+        iterator(typename Map::const_iterator it) : it_(it) { }
+        reference operator*() const { return it_->second; }
+        pointer operator->() const { return &it_->second; }
+        iterator& operator++() { ++it_; return *this; }
+        iterator operator++(int) { iterator prev(*this); ++it_; return prev; }
+        bool operator==(const iterator& other) const { return it_ == other.it_; }
+        bool operator!=(const iterator& other) const { return it_ != other.it_; }
+    private:
+        typename Map::const_iterator it_;
+    };
+
+    MapValueRange(const Map& map) : map_(&map) { }
+    iterator begin() const { return iterator(map_->begin()); }
+    iterator end() const { return iterator(map_->end()); }
+    size_t size() const { return map_->size(); }
+    bool empty() const { return map_->empty(); }
+
+protected:
+    const Map* map_;
+};
+
+#endif // MAPVALUERANGE_H
@@ -0,0 +1,138 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#include "meshadjacency.h"
+#include <parallelfor.h>
+#include <algorithm>
+#include <numeric>
+
+const unsigned int MeshAdjacency::NONE;
+
+MeshAdjacency::MeshAdjacency(const std::vector<unsigned int>& triangles, size_t num_vertices) {
+    size_t num_triangles = triangles.size() / 3;
+    // Triangles pointing past the last vertex are left out of the connectivity
+    auto is_valid = [&](size_t t) {
+        return triangles[3 * t] < num_vertices && triangles[3 * t + 1] < num_vertices && triangles[3 * t + 2] < num_vertices;
+    };
+
+    // Triangles around each vertex, in increasing order (a counting sort by vertex)
+    triangle_offsets_.assign(num_vertices + 1, 0);
+    for (size_t t = 0; t < num_triangles; t++) {
+        if (!is_valid(t)) continue;
+        for (int k = 0; k < 3; k++) triangle_offsets_[triangles[3 * t + k] + 1]++;
+    }
+    std::partial_sum(triangle_offsets_.begin(), triangle_offsets_.end(), triangle_offsets_.begin());
+    vertex_triangles_.resize(triangle_offsets_.back());
+    {
+        std::vector<size_t> next(triangle_offsets_.begin(), triangle_offsets_.end() - 1);
+        for (size_t t = 0; t < num_triangles; t++) {
+            if (!is_valid(t)) continue;
+            for (int k = 0; k < 3; k++) vertex_triangles_[next[triangles[3 * t + k]]++] = t;
+        }
+    }
+
+    // Collects the sorted, distinct neighbors of v from the triangles around it
+    auto gather_neighbors = [&](unsigned int v, std::vector<unsigned int>& neighbors) {
+        neighbors.clear();
+        for (size_t i = TrianglesBegin(v); i < TrianglesEnd(v); i++) {
+            const unsigned int* corners = &triangles[3 * vertex_triangles_[i]];
+            for (int k = 0; k < 3; k++) {
+                if (corners[k] != v) neighbors.push_back(corners[k]);
+            }
+        }
+        std::sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+    };
+
+    // Count every vertex's neighbors, and the edges it owns (those to higher neighbors), then lay them out
+    neighbor_offsets_.assign(num_vertices + 1, 0);
+    edge_offsets_.assign(num_vertices + 1, 0);
+    ParallelFor(num_vertices, VERTICES_PER_TASK, [&](size_t begin, size_t end) {
+        std::vector<unsigned int> neighbors;
+        for (size_t v = begin; v < end; v++) {
+            gather_neighbors(v, neighbors);
+            neighbor_offsets_[v + 1] = neighbors.size();
+            edge_offsets_[v + 1] = neighbors.end() - std::upper_bound(neighbors.begin(), neighbors.end(), (unsigned int) v);
+        }
+    });
+    std::partial_sum(neighbor_offsets_.begin(), neighbor_offsets_.end(), neighbor_offsets_.begin());
+    std::partial_sum(edge_offsets_.begin(), edge_offsets_.end(), edge_offsets_.begin());
+
+    neighbors_.resize(neighbor_offsets_.back());
+    edges_.resize(2 * edge_offsets_.back());
+    ParallelFor(num_vertices, VERTICES_PER_TASK, [&](size_t begin, size_t end) {
+        std::vector<unsigned int> neighbors;
+        for (size_t v = begin; v < end; v++) {
+            gather_neighbors(v, neighbors);
+            std::copy(neighbors.begin(), neighbors.end(), neighbors_.begin() + neighbor_offsets_[v]);
+            unsigned int e = edge_offsets_[v];
+            for (auto it = std::upper_bound(neighbors.begin(), neighbors.end(), (unsigned int) v); it != neighbors.end(); ++it, ++e) {
+                edges_[2 * e] = v;
+                edges_[2 * e + 1] = *it;
+            }
+        }
+    });
+
+    // Each vertex fills in the opposite vertices of the edges it owns, so no two tasks write the same edge.
+    // Edges shared by more than two triangles keep the first two.
+    edge_opposites_.assign(edges_.size(), NONE);
+    ParallelFor(num_vertices, VERTICES_PER_TASK, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; v++) {
+            for (size_t i = TrianglesBegin(v); i < TrianglesEnd(v); i++) {
+                const unsigned int* corners = &triangles[3 * vertex_triangles_[i]];
+                for (int k = 0; k < 3; k++) {
+                    if (corners[k] != v) continue;
+                    unsigned int b = corners[(k + 1) % 3];
+                    unsigned int c = corners[(k + 2) % 3];
+                    unsigned int edge_opposite[2][2] = {{b, c}, {c, b}};
+                    for (auto& pair : edge_opposite) {
+                        if (pair[0] <= v) continue;
+                        unsigned int e = FindEdge(v, pair[0]);
+                        if (edge_opposites_[2 * e] == NONE) edge_opposites_[2 * e] = pair[1];
+                        else if (edge_opposites_[2 * e + 1] == NONE) edge_opposites_[2 * e + 1] = pair[1];
+                    }
+                }
+            }
+        }
+    });
+
+    triangle_edges_.resize(3 * num_triangles);
+    ParallelFor(num_triangles, VERTICES_PER_TASK, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; t++) {
+            bool valid = is_valid(t);
+            for (int k = 0; k < 3; k++) {
+                triangle_edges_[3 * t + k] = valid ? FindEdge(triangles[3 * t + k], triangles[3 * t + (k + 1) % 3]) : NONE;
+            }
+        }
+    });
+
+    boundary_neighbors_.assign(2 * num_vertices, NONE);
+    ParallelFor(num_vertices, VERTICES_PER_TASK, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; v++) {
+            int count = 0;
+            for (size_t i = NeighborsBegin(v); i < NeighborsEnd(v); i++) {
+                if (!IsBoundaryEdge(FindEdge(v, neighbors_[i]))) continue;
+                if (count < 2) boundary_neighbors_[2 * v + count] = neighbors_[i];
+                count++;
+            }
+            if (count != 2) boundary_neighbors_[2 * v + 1] = NONE;
+        }
+    });
+}
+
+unsigned int MeshAdjacency::FindEdge(unsigned int a, unsigned int b) const {
+    if (a == b) return NONE;
+    if (a > b) std::swap(a, b);
+    auto first = neighbors_.begin() + NeighborsBegin(a);
+    auto last = neighbors_.begin() + NeighborsEnd(a);
+    auto upper = std::upper_bound(first, last, a);
+    auto it = std::lower_bound(upper, last, b);
+    if (it == last || *it != b) return NONE;
+    return edge_offsets_[a] + (it - upper);
+}
@@ -0,0 +1,73 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#ifndef MESHADJACENCY_H
+#define MESHADJACENCY_H
+
+#include <vector>
+#include <cstddef>
+#include <limits>
+
+// Connectivity of a triangle mesh in compressed (CSR) form: for each vertex, its neighboring vertices and the
+// triangles around it, and for each undirected edge, its endpoints and the vertices opposite it.
+// Edge k of triangle t runs from corner k to corner (k + 1) % 3, and every edge is numbered once, so per-edge data
+// (like Loop subdivision's edge vertices) can live in flat arrays instead of maps keyed by vertex pairs.
+// Building it is parallel and linear in the size of the mesh; Mesh::GetAdjacency keeps one per topology.
+class MeshAdjacency {
+public:
+    static const unsigned int NONE = std::numeric_limits<unsigned int>::max();
+
+    MeshAdjacency(const std::vector<unsigned int>& triangles, size_t num_vertices);
+
+    size_t VertexCount() const { return neighbor_offsets_.size() - 1; }
+    size_t EdgeCount() const { return edges_.size() / 2; }
+    size_t TriangleCount() const { return triangle_edges_.size() / 3; }
+
+    // Sorted neighbors of vertex v are neighbors_[NeighborsBegin(v), NeighborsEnd(v))
+    size_t NeighborsBegin(unsigned int v) const { return neighbor_offsets_[v]; }
+    size_t NeighborsEnd(unsigned int v) const { return neighbor_offsets_[v + 1]; }
+    unsigned int Neighbor(size_t i) const { return neighbors_[i]; }
+    size_t Valence(unsigned int v) const { return NeighborsEnd(v) - NeighborsBegin(v); }
+
+    // Triangles around vertex v are vertex_triangles_[TrianglesBegin(v), TrianglesEnd(v))
+    size_t TrianglesBegin(unsigned int v) const { return triangle_offsets_[v]; }
+    size_t TrianglesEnd(unsigned int v) const { return triangle_offsets_[v + 1]; }
+    unsigned int VertexTriangle(size_t i) const { return vertex_triangles_[i]; }
+
+    // Edge e joins EdgeVertex(e, 0) < EdgeVertex(e, 1)
+    unsigned int EdgeVertex(size_t e, int end) const { return edges_[2 * e + end]; }
+    // Vertex opposite edge e in each of its (up to two) triangles, NONE for a boundary edge's missing side
+    unsigned int EdgeOpposite(size_t e, int side) const { return edge_opposites_[2 * e + side]; }
+    bool IsBoundaryEdge(size_t e) const { return edge_opposites_[2 * e + 1] == NONE; }
+    // Edge k of triangle t
+    unsigned int TriangleEdge(size_t t, int k) const { return triangle_edges_[3 * t + k]; }
+    // Edge between vertices a and b, or NONE if they aren't neighbors
+    unsigned int FindEdge(unsigned int a, unsigned int b) const;
+
+    // The neighbors of a boundary vertex along the boundary, or NONE for interior vertices.
+    // Vertices where the boundary isn't a simple curve get NONE for their second neighbor too.
+    unsigned int BoundaryNeighbor(unsigned int v, int side) const { return boundary_neighbors_[2 * v + side]; }
+    bool IsBoundaryVertex(unsigned int v) const { return boundary_neighbors_[2 * v] != NONE; }
+
+private:
+    std::vector<size_t> neighbor_offsets_;
+    std::vector<unsigned int> neighbors_;
+    std::vector<size_t> triangle_offsets_;
+    std::vector<unsigned int> vertex_triangles_;
+    // Number of each vertex's first edge; edges are owned by their lower vertex
+    std::vector<unsigned int> edge_offsets_;
+    std::vector<unsigned int> edges_;
+    std::vector<unsigned int> edge_opposites_;
+    std::vector<unsigned int> triangle_edges_;
+    std::vector<unsigned int> boundary_neighbors_;
+
+    static const size_t VERTICES_PER_TASK = 16384;
+};
+
+#endif // MESHADJACENCY_H
@@ -8,48 +8,231 @@
  * should contact the author.
  ****************************************************************************/
 #include "meshprocessing.h"
+#include <meshadjacency.h>
+#include <parallelfor.h>
 #include <algorithm>
+#include <cmath>
+#include <glm/gtc/constants.hpp>
+
+std::vector<float> MeshProcessing::VertexNormals(const std::vector<float>& positions, const std::vector<unsigned int>& triangles,
+                                                 const MeshAdjacency& adjacency, const std::vector<float>& fallback) {
+    size_t num_vertices = adjacency.VertexCount();
+    size_t num_triangles = triangles.size() / 3;
+
+    // The cross product of two sides is normal to the triangle, with a length proportional to its area
+    std::vector<glm::vec3> face_normals(num_triangles);
+    ParallelFor(num_triangles, TRIANGLES_PER_TASK, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; t++) {
+            const unsigned int* corners = &triangles[3 * t];
+            if (corners[0] >= num_vertices || corners[1] >= num_vertices || corners[2] >= num_vertices) continue;
+            glm::vec3 p0(positions[3 * corners[0]], positions[3 * corners[0] + 1], positions[3 * corners[0] + 2]);
+            glm::vec3 p1(positions[3 * corners[1]], positions[3 * corners[1] + 1], positions[3 * corners[1] + 2]);
+            glm::vec3 p2(positions[3 * corners[2]], positions[3 * corners[2] + 1], positions[3 * corners[2] + 2]);
+            face_normals[t] = glm::cross(p1 - p0, p2 - p0);
+        }
+    });
+
+    // Each vertex sums the normals of the triangles around it, so the weighting by area comes for free
+    std::vector<float> normals(3 * num_vertices, 0.0f);
+    bool has_fallback = fallback.size() >= 3 * num_vertices;
+    ParallelFor(num_vertices, VERTICES_PER_TASK, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; v++) {
+            glm::vec3 sum(0.0f);
+            for (size_t i = adjacency.TrianglesBegin(v); i < adjacency.TrianglesEnd(v); i++) {
+                sum += face_normals[adjacency.VertexTriangle(i)];
+            }
+            float length = glm::length(sum);
+            if (length > 0.0f) {
+                sum /= length;
+            } else if (has_fallback) {
+                sum = glm::vec3(fallback[3 * v], fallback[3 * v + 1], fallback[3 * v + 2]);
+            }
+            normals[3 * v] = sum.x;
+            normals[3 * v + 1] = sum.y;
+            normals[3 * v + 2] = sum.z;
+        }
+    });
+    return normals;
+}
 
 void MeshProcessing::ComputeNormals(Mesh& mesh) {
-    // MODELER: Recompute the normals for a mesh by taking a weighted
-    // average of the normals of the adjacent faces
+    std::shared_ptr<const MeshAdjacency> adjacency = mesh.GetAdjacency();
+    mesh.SetNormals(VertexNormals(mesh.GetPositions(), mesh.GetTriangles(), *adjacency, mesh.GetNormals()));
 }
 
+// Each vertex moves to a weighted sum of itself and its neighbors (vertices it shares an edge with): the vertex
+// weighs 1, and each of its N neighbors a / N, normalized. Positive "a" smooths the mesh, negative "a" sharpens it.
 void MeshProcessing::FilterMesh(const Mesh& input_mesh, Mesh& filtered_mesh, double a) {
     const std::vector<float>& input_positions = input_mesh.GetPositions();
     const std::vector<float>& input_normals = input_mesh.GetNormals();
     const std::vector<float>& input_UVs = input_mesh.GetUVs();
     const std::vector<unsigned int>& input_faces = input_mesh.GetTriangles();
+    std::shared_ptr<const MeshAdjacency> adjacency = input_mesh.GetAdjacency();
 
-    // MODELER: Take a weighted sum of the vertex and its neighbors to produce a new mesh
-    // with the same connectivity as the original mesh, but with updated vertex positions.
-    // Vertices are neighbors if they share an edge. Filter weights will be 1 for the vertex,
-    // and a / N for each neighboring vertex. The weights will then be normalized.
-    // "a" controls smoothing or sharpening, and N is the number of neighboring vertices.
-
-    filtered_mesh.SetPositions(input_positions);
-    filtered_mesh.SetNormals(input_normals);
-    filtered_mesh.SetUVs(input_UVs);
-    filtered_mesh.SetTriangles(input_faces);
-    ComputeNormals(filtered_mesh);
+    size_t num_vertices = adjacency->VertexCount();
+    std::vector<float> positions(input_positions);
+    ParallelFor(num_vertices, VERTICES_PER_TASK, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; v++) {
+            size_t valence = adjacency->Valence(v);
+            double total_weight = 1.0 + a;
+            if (valence == 0 || total_weight == 0.0) continue;
+            glm::vec3 sum(0.0f);
+            for (size_t i = adjacency->NeighborsBegin(v); i < adjacency->NeighborsEnd(v); i++) {
+                unsigned int w = adjacency->Neighbor(i);
+                sum += glm::vec3(input_positions[3 * w], input_positions[3 * w + 1], input_positions[3 * w + 2]);
+            }
+            glm::vec3 p(input_positions[3 * v], input_positions[3 * v + 1], input_positions[3 * v + 2]);
+            p = (p + sum * float(a / valence)) / float(total_weight);
+            positions[3 * v] = p.x;
+            positions[3 * v + 1] = p.y;
+            positions[3 * v + 2] = p.z;
+        }
+    });
+
+    // The filtered mesh has the same connectivity, so it shares the adjacency
+    std::vector<float> normals = VertexNormals(positions, input_faces, *adjacency, input_normals);
+    MeshEdit edit(filtered_mesh);
+    edit.SetPositions(std::move(positions));
+    edit.SetNormals(std::move(normals));
+    edit.SetUVs(std::vector<float>(input_UVs));
+    edit.SetTriangles(std::vector<unsigned int>(input_faces), adjacency);
+}
+
+float MeshProcessing::LoopBeta(size_t k) {
+    float c = 3.0f / 8.0f + 0.25f * std::cos(glm::two_pi<float>() / k);
+    return (5.0f / 8.0f - c * c) / k;
 }
 
+// Interior vertices go to (w v + sum of neighbors) / (w + k) with w = 3 / (8 beta); boundary vertices follow the
+// limit of the cubic B-spline along the boundary. Corners, where the boundary isn't a simple curve, stay put.
+std::vector<float> MeshProcessing::LimitPositions(const std::vector<float>& positions, const MeshAdjacency& adjacency) {
+    size_t num_vertices = adjacency.VertexCount();
+    std::vector<float> limit(positions);
+    ParallelFor(num_vertices, VERTICES_PER_TASK, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; v++) {
+            size_t valence = adjacency.Valence(v);
+            if (valence == 0) continue;
+            auto position = [&](unsigned int i) { return glm::vec3(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2]); };
+            glm::vec3 p;
+            if (adjacency.IsBoundaryVertex(v)) {
+                if (adjacency.BoundaryNeighbor(v, 1) == MeshAdjacency::NONE) continue;
+                p = (position(adjacency.BoundaryNeighbor(v, 0)) + 4.0f * position(v) + position(adjacency.BoundaryNeighbor(v, 1))) / 6.0f;
+            } else {
+                glm::vec3 sum(0.0f);
+                for (size_t i = adjacency.NeighborsBegin(v); i < adjacency.NeighborsEnd(v); i++) sum += position(adjacency.Neighbor(i));
+                float w = 3.0f / (8.0f * LoopBeta(valence));
+                p = (w * position(v) + sum) / (w + valence);
+            }
+            limit[3 * v] = p.x;
+            limit[3 * v + 1] = p.y;
+            limit[3 * v + 2] = p.z;
+        }
+    });
+    return limit;
+}
+
+// One iteration of Loop subdivision. The input's vertices come first in the output ("even" vertices), followed by
+// one new ("odd") vertex per edge, numbered like the edges, so no lookups by vertex pair are needed. Boundary edges
+// and vertices follow the cubic B-spline rules. UVs are interpolated linearly.
 void MeshProcessing::SubdivideMesh(const Mesh& input_mesh, Mesh& filtered_mesh, bool limit) {
     const std::vector<float>& input_positions = input_mesh.GetPositions();
-    const std::vector<float>& input_normals = input_mesh.GetNormals();
     const std::vector<float>& input_UVs = input_mesh.GetUVs();
     const std::vector<unsigned int>& input_faces = input_mesh.GetTriangles();
+    std::shared_ptr<const MeshAdjacency> adjacency = input_mesh.GetAdjacency();
+
+    size_t num_vertices = adjacency->VertexCount();
+    size_t num_edges = adjacency->EdgeCount();
+    size_t num_triangles = adjacency->TriangleCount();
+    bool has_UVs = input_UVs.size() >= 2 * num_vertices;
+    auto position = [&](unsigned int i) { return glm::vec3(input_positions[3 * i], input_positions[3 * i + 1], input_positions[3 * i + 2]); };
+
+    std::vector<float> positions(3 * (num_vertices + num_edges));
+    std::vector<float> UVs(has_UVs ? 2 * (num_vertices + num_edges) : 0);
 
-    // MODELER - EXTRA CREDIT (457): Perform one iteration of Loop subdivision on the mesh, assuming
-    // the mesh is watertight (has no boundary vertices or edges).
-    // For an extra bell, also detect and subdivide boundary vertices and edges
+    // Even vertices
+    ParallelFor(num_vertices, VERTICES_PER_TASK, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; v++) {
+            size_t valence = adjacency->Valence(v);
+            glm::vec3 p = position(v);
+            if (adjacency->IsBoundaryVertex(v)) {
+                if (adjacency->BoundaryNeighbor(v, 1) != MeshAdjacency::NONE) {
+                    p = 0.75f * p + 0.125f * (position(adjacency->BoundaryNeighbor(v, 0)) + position(adjacency->BoundaryNeighbor(v, 1)));
+                }
+            } else if (valence > 0) {
+                glm::vec3 sum(0.0f);
+                for (size_t i = adjacency->NeighborsBegin(v); i < adjacency->NeighborsEnd(v); i++) sum += position(adjacency->Neighbor(i));
+                float beta = LoopBeta(valence);
+                p = (1.0f - valence * beta) * p + beta * sum;
+            }
+            positions[3 * v] = p.x;
+            positions[3 * v + 1] = p.y;
+            positions[3 * v + 2] = p.z;
+            if (has_UVs) {
+                UVs[2 * v] = input_UVs[2 * v];
+                UVs[2 * v + 1] = input_UVs[2 * v + 1];
+            }
+        }
+    });
+
+    // Odd vertices
+    ParallelFor(num_edges, VERTICES_PER_TASK, [&](size_t begin, size_t end) {
+        for (size_t e = begin; e < end; e++) {
+            unsigned int a = adjacency->EdgeVertex(e, 0);
+            unsigned int b = adjacency->EdgeVertex(e, 1);
+            glm::vec3 p;
+            if (adjacency->IsBoundaryEdge(e)) {
+                p = 0.5f * (position(a) + position(b));
+            } else {
+                p = 0.375f * (position(a) + position(b)) +
+                    0.125f * (position(adjacency->EdgeOpposite(e, 0)) + position(adjacency->EdgeOpposite(e, 1)));
+            }
+            size_t v = num_vertices + e;
+            positions[3 * v] = p.x;
+            positions[3 * v + 1] = p.y;
+            positions[3 * v + 2] = p.z;
+            if (has_UVs) {
+                UVs[2 * v] = 0.5f * (input_UVs[2 * a] + input_UVs[2 * b]);
+                UVs[2 * v + 1] = 0.5f * (input_UVs[2 * a + 1] + input_UVs[2 * b + 1]);
+            }
+        }
+    });
+
+    // Every triangle splits into four. Triangles referring to missing vertices are dropped.
+    std::vector<size_t> first_face(num_triangles + 1, 0);
+    for (size_t t = 0; t < num_triangles; t++) {
+        const unsigned int* corners = &input_faces[3 * t];
+        bool valid = corners[0] < num_vertices && corners[1] < num_vertices && corners[2] < num_vertices;
+        first_face[t + 1] = first_face[t] + (valid ? 4 : 0);
+    }
+    std::vector<unsigned int> faces(3 * first_face.back());
+    ParallelFor(num_triangles, TRIANGLES_PER_TASK, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; t++) {
+            if (first_face[t + 1] == first_face[t]) continue;
+            const unsigned int* c = &input_faces[3 * t];
+            unsigned int m[3];
+            for (int k = 0; k < 3; k++) {
+                // A degenerate edge has no vertex of its own; its corners coincide anyway
+                unsigned int e = adjacency->TriangleEdge(t, k);
+                m[k] = e == MeshAdjacency::NONE ? c[k] : num_vertices + e;
+            }
+            unsigned int split[12] = {c[0], m[0], m[2],
+                                      c[1], m[1], m[0],
+                                      c[2], m[2], m[1],
+                                      m[0], m[1], m[2]};
+            std::copy(split, split + 12, faces.begin() + 3 * first_face[t]);
+        }
+    });
 
-    filtered_mesh.SetPositions(input_positions);
-    filtered_mesh.SetNormals(input_normals);
-    filtered_mesh.SetUVs(input_UVs);
-    filtered_mesh.SetTriangles(input_faces);
+    // The output's adjacency is needed for its normals (and limit positions), and is kept with it
+    std::shared_ptr<const MeshAdjacency> subdivided_adjacency = std::make_shared<MeshAdjacency>(faces, num_vertices + num_edges);
+    if (limit) positions = LimitPositions(positions, *subdivided_adjacency);
+    std::vector<float> normals = VertexNormals(positions, faces, *subdivided_adjacency, std::vector<float>());
 
-    ComputeNormals(filtered_mesh);
+    MeshEdit edit(filtered_mesh);
+    edit.SetPositions(std::move(positions));
+    edit.SetNormals(std::move(normals));
+    edit.SetUVs(std::move(UVs));
+    edit.SetTriangles(std::move(faces), subdivided_adjacency);
 }
 
 void MeshProcessing::FlipNormals(const Mesh& input_mesh, Mesh& filtered_mesh) {
@@ -69,8 +252,9 @@ void MeshProcessing::FlipNormals(const Mesh& input_mesh, Mesh& filtered_mesh) {
         output_faces.push_back(input_faces[i+1]);
     }
 
-    filtered_mesh.SetPositions(input_mesh.GetPositions());
-    filtered_mesh.SetNormals(output_normals);
-    filtered_mesh.SetUVs(input_mesh.GetUVs());
-    filtered_mesh.SetTriangles(output_faces);
+    MeshEdit edit(filtered_mesh);
+    edit.SetPositions(std::vector<float>(input_mesh.GetPositions()));
+    edit.SetNormals(std::move(output_normals));
+    edit.SetUVs(std::vector<float>(input_mesh.GetUVs()));
+    edit.SetTriangles(std::move(output_faces));
 }
@@ -12,6 +12,9 @@
 #include <resource/mesh.h>
 #include <utility>
 
+class MeshAdjacency;
+
+// Mesh kernels run in parallel over vertices, edges, or triangles, using the mesh's cached adjacency
 class MeshProcessing {
 public:
     static void ComputeNormals(Mesh& mesh);
@@ -20,6 +23,17 @@ public:
     static void SubdivideMesh(const Mesh& input_mesh, Mesh& filtered_mesh, bool limit=false);
 
 private:
+    static const size_t VERTICES_PER_TASK = 16384;
+    static const size_t TRIANGLES_PER_TASK = 16384;
+
+    // Area weighted vertex normals. Vertices without any area around them keep their normal from fallback, if it has one.
+    static std::vector<float> VertexNormals(const std::vector<float>& positions, const std::vector<unsigned int>& triangles,
+                                            const MeshAdjacency& adjacency, const std::vector<float>& fallback);
+    // Moves the vertices of a Loop subdivision surface to their limit positions
+    static std::vector<float> LimitPositions(const std::vector<float>& positions, const MeshAdjacency& adjacency);
+    // Weight of each neighbor of an interior vertex of valence k in Loop subdivision
+    static float LoopBeta(size_t k);
+
     typedef std::pair<unsigned int, unsigned int> mesh_edge;
     static mesh_edge make_edge(unsigned int v1, unsigned int v2) {
         return v1 < v2 ? std::make_pair(v1, v2) : std::make_pair(v2, v1);
@@ -10,119 +10,160 @@
 #include <glextinclude.h>
 #include "glmesh.h"
 #include <opengl/glshaderprogram.h>
+#include <parallelfor.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
 
 GLMesh::GLMesh(const Mesh& mesh) :
-    Cacheable(&mesh)
+    Cacheable(&mesh),
+    instance_vbo_(0),
+    index_type_(GL_UNSIGNED_INT),
+    uploads_(0),
+    vertex_capacity_(0),
+    index_capacity_(0)
 {
     // Allocate a Vertex Array Object for this mesh
     glGenVertexArrays(1, &vertex_array_);
 
-    // Allocate Vertex Buffer Objects for each vertex attribute and the triangle indices
+    // Allocate Vertex Buffer Objects for the vertex attributes and the triangle indices
     glGenBuffers(1, &elements_vbo_);
-    glGenBuffers(1, &position_vbo_);
-    glGenBuffers(1, &normal_vbo_);
-    glGenBuffers(1, &color_vbo_);
-    glGenBuffers(1, &UV_vbo_);
-    glGenBuffers(1, &binormal_vbo_);
-    glGenBuffers(1, &tangent_vbo_);
+    glGenBuffers(1, &vertex_vbo_);
 
     SetMeshData(mesh);
 }
 
-void GLMesh::SetMeshData(const Mesh& mesh) {
-    mesh_type_ = mesh.GetMeshType();
-    glBindVertexArray(vertex_array_);
-    auto attributes = GLShaderProgram::AttributeLocations();
+// Packs a direction into 10 bits per component, read back by GL_INT_2_10_10_10_REV. It is normalized first, since
+// Snorm packing clamps longer vectors and loses precision on shorter ones (Mesh::Append scales them). Zero-length
+// and non-finite vectors, like tangents from degenerate UVs, are packed as zero.
+static uint32_t PackUnitVector(const float* v) {
+    glm::vec3 direction(v[0], v[1], v[2]);
+    float length = glm::length(direction);
+    if (!std::isfinite(length) || length == 0.0f) return glm::packSnorm3x10_1x2(glm::vec4(0.0f));
+    return glm::packSnorm3x10_1x2(glm::vec4(direction / length, 0.0f));
+}
 
-    // Positions
-    auto positions = mesh.GetPositions();
-    GLint posAttrib = attributes["position"];
-    if (positions.size() > 0) {
-        num_vertices_ = positions.size()/3;
-        glEnableVertexAttribArray(posAttrib);
-        glBindBuffer(GL_ARRAY_BUFFER, position_vbo_);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * positions.size(), positions.data(), GL_STATIC_DRAW); // Static, Dynamic, or Stream
-        glVertexAttribPointer(posAttrib, 3, GL_FLOAT, GL_FALSE, 3*sizeof(float), 0);
+static void SetAttribute(GLint location, bool present, GLint size, GLenum type, GLboolean normalized, GLsizei stride, size_t offset) {
+    if (present) {
+        glEnableVertexAttribArray(location);
+        glVertexAttribPointer(location, size, type, normalized, stride, (const GLvoid*) offset);
     } else {
-        glDisableVertexAttribArray(posAttrib);
+        glDisableVertexAttribArray(location);
     }
+}
 
-    // Normals
-    auto normals = mesh.GetNormals();
-    GLint nmlAttrib = attributes["normal"];
-    if (normals.size() > 0) {
-        glEnableVertexAttribArray(nmlAttrib);
-        glBindBuffer(GL_ARRAY_BUFFER, normal_vbo_);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * normals.size(), normals.data(), GL_STATIC_DRAW); // Static, Dynamic, or Stream
-        glVertexAttribPointer(nmlAttrib, 3, GL_FLOAT, GL_FALSE, 3*sizeof(float), 0);
-    } else {
-        glDisableVertexAttribArray(nmlAttrib);
-    }
+// Vertices are interleaved in a single buffer, with their attributes packed where that doesn't lose visible precision:
+// normals, binormals and tangents get 10 bits per component, colors 8 bits, and UVs half floats when they all lie
+// within [-1, 1]. Positions stay full floats. Indices are 16 bits when the mesh has few enough vertices.
+void GLMesh::SetMeshData(const Mesh& mesh) {
+    mesh_type_ = mesh.GetMeshType();
+    const std::vector<float>& positions = mesh.GetPositions();
+    const std::vector<float>& normals = mesh.GetNormals();
+    const std::vector<float>& colors = mesh.GetColors();
+    const std::vector<float>& UVs = mesh.GetUVs();
+    const std::vector<float>& binormals = mesh.GetBinormals();
+    const std::vector<float>& tangents = mesh.GetTangents();
+    const std::vector<unsigned int>& triangles = mesh.GetTriangles();
 
-    // Colors
-    auto colors = mesh.GetColors();
-    GLint colAttrib = attributes["color"];
-    if (colors.size() > 0) {
-        glEnableVertexAttribArray(colAttrib);
-        glBindBuffer(GL_ARRAY_BUFFER, color_vbo_);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * colors.size(), colors.data(), GL_STATIC_DRAW); // Static, Dynamic, or Stream
-        glVertexAttribPointer(colAttrib, 3, GL_FLOAT, GL_FALSE, 3*sizeof(float), 0);
-    } else {
-        glDisableVertexAttribArray(colAttrib);
-    }
+    // Attributes that don't cover every vertex are left out
+    size_t num_vertices = positions.size() / 3;
+    num_vertices_ = num_vertices;
+    bool has_normals = num_vertices > 0 && normals.size() >= 3 * num_vertices;
+    bool has_colors = num_vertices > 0 && colors.size() >= 3 * num_vertices;
+    bool has_UVs = num_vertices > 0 && UVs.size() >= 2 * num_vertices;
+    bool has_binormals = num_vertices > 0 && binormals.size() >= 3 * num_vertices;
+    bool has_tangents = num_vertices > 0 && tangents.size() >= 3 * num_vertices;
+    bool half_UVs = has_UVs && std::all_of(UVs.begin(), UVs.begin() + 2 * num_vertices, [](float uv) { return std::abs(uv) <= 1.0f; });
 
-    // Texture Coords
-    auto UVs = mesh.GetUVs();
-    GLint texAttrib = attributes["texcoord"];
-    if (UVs.size() > 0) {
-        glEnableVertexAttribArray(texAttrib);
-        glBindBuffer(GL_ARRAY_BUFFER, UV_vbo_);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * UVs.size(), UVs.data(), GL_STATIC_DRAW); // Static, Dynamic, or Stream
-        glVertexAttribPointer(texAttrib, 2, GL_FLOAT, GL_FALSE, 2*sizeof(float), 0);
-    } else {
-        glDisableVertexAttribArray(texAttrib);
-    }
+    // Byte offset of each attribute within a vertex
+    size_t stride = 0;
+    size_t position_offset = stride; stride += 3 * sizeof(float);
+    size_t normal_offset = stride; if (has_normals) stride += sizeof(uint32_t);
+    size_t color_offset = stride; if (has_colors) stride += sizeof(uint32_t);
+    size_t UV_offset = stride; if (has_UVs) stride += half_UVs ? sizeof(uint32_t) : 2 * sizeof(float);
+    size_t binormal_offset = stride; if (has_binormals) stride += sizeof(uint32_t);
+    size_t tangent_offset = stride; if (has_tangents) stride += sizeof(uint32_t);
 
-    // Binormals
-    auto binormals = mesh.GetBinormals();
-    GLint binmlAttrib = attributes["binormal"];
-    if (binormals.size() > 0) {
-        glEnableVertexAttribArray(binmlAttrib);
-        glBindBuffer(GL_ARRAY_BUFFER, binormal_vbo_);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * binormals.size(), binormals.data(), GL_STATIC_DRAW); // Static, Dynamic, or Stream
-        glVertexAttribPointer(binmlAttrib, 3, GL_FLOAT, GL_FALSE, 3*sizeof(float), 0);
-    } else {
-        glDisableVertexAttribArray(binmlAttrib);
-    }
+    std::vector<unsigned char> vertices(stride * num_vertices);
+    ParallelFor(num_vertices, VERTICES_PER_TASK, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            unsigned char* vertex = &vertices[i * stride];
+            memcpy(vertex + position_offset, &positions[3 * i], 3 * sizeof(float));
+            uint32_t packed;
+            if (has_normals) {
+                packed = PackUnitVector(&normals[3 * i]);
+                memcpy(vertex + normal_offset, &packed, sizeof(packed));
+            }
+            if (has_colors) {
+                packed = glm::packUnorm4x8(glm::vec4(colors[3 * i], colors[3 * i + 1], colors[3 * i + 2], 1.0f));
+                memcpy(vertex + color_offset, &packed, sizeof(packed));
+            }
+            if (has_UVs && half_UVs) {
+                packed = glm::packHalf2x16(glm::vec2(UVs[2 * i], UVs[2 * i + 1]));
+                memcpy(vertex + UV_offset, &packed, sizeof(packed));
+            } else if (has_UVs) {
+                memcpy(vertex + UV_offset, &UVs[2 * i], 2 * sizeof(float));
+            }
+            if (has_binormals) {
+                packed = PackUnitVector(&binormals[3 * i]);
+                memcpy(vertex + binormal_offset, &packed, sizeof(packed));
+            }
+            if (has_tangents) {
+                packed = PackUnitVector(&tangents[3 * i]);
+                memcpy(vertex + tangent_offset, &packed, sizeof(packed));
+            }
+        }
+    });
 
-    // Tangents
-    auto tangents = mesh.GetTangents();
-    GLint tngtAttrib = attributes["tangent"];
-    if (tangents.size() > 0) {
-        glEnableVertexAttribArray(tngtAttrib);
-        glBindBuffer(GL_ARRAY_BUFFER, tangent_vbo_);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * tangents.size(), tangents.data(), GL_STATIC_DRAW); // Static, Dynamic, or Stream
-        glVertexAttribPointer(tngtAttrib, 3, GL_FLOAT, GL_FALSE, 3*sizeof(float), 0);
-    } else {
-        glDisableVertexAttribArray(tngtAttrib);
-    }
+    glBindVertexArray(vertex_array_);
+    Upload(GL_ARRAY_BUFFER, vertex_vbo_, vertices.data(), vertices.size(), vertex_capacity_);
+    auto attributes = GLShaderProgram::AttributeLocations();
+    SetAttribute(attributes["position"], num_vertices > 0, 3, GL_FLOAT, GL_FALSE, stride, position_offset);
+    SetAttribute(attributes["normal"], has_normals, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, normal_offset);
+    SetAttribute(attributes["color"], has_colors, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, color_offset);
+    SetAttribute(attributes["texcoord"], has_UVs, 2, half_UVs ? GL_HALF_FLOAT : GL_FLOAT, GL_FALSE, stride, UV_offset);
+    SetAttribute(attributes["binormal"], has_binormals, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, binormal_offset);
+    SetAttribute(attributes["tangent"], has_tangents, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, tangent_offset);
 
     // Triangles
-    auto triangles = mesh.GetTriangles();
-    // TODO: Watch out for meshes that have too many triangles or vertices.
     num_indices_ = triangles.size();
     if (num_indices_ > 0) {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elements_vbo_);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * triangles.size(), triangles.data(), GL_STATIC_DRAW);
+        if (num_vertices <= std::numeric_limits<unsigned short>::max() + 1) {
+            index_type_ = GL_UNSIGNED_SHORT;
+            std::vector<unsigned short> short_triangles(triangles.begin(), triangles.end());
+            Upload(GL_ELEMENT_ARRAY_BUFFER, elements_vbo_, short_triangles.data(), sizeof(unsigned short) * num_indices_, index_capacity_);
+        } else {
+            index_type_ = GL_UNSIGNED_INT;
+            Upload(GL_ELEMENT_ARRAY_BUFFER, elements_vbo_, triangles.data(), sizeof(unsigned int) * num_indices_, index_capacity_);
+        }
     }
     glBindVertexArray(0);
+    uploads_++;
+}
+
+// The first upload is static. A mesh that is uploaded again is probably rewritten every frame (like a deformed mesh),
+// so from then on its buffer is orphaned before writing: the driver hands back fresh storage rather than waiting for
+// draws still reading the old contents.
+void GLMesh::Upload(GLenum target, GLuint buffer, const void* data, size_t size, size_t& capacity) {
+    glBindBuffer(target, buffer);
+    if (uploads_ == 0) {
+        glBufferData(target, size, data, GL_STATIC_DRAW);
+        capacity = size;
+        return;
+    }
+    capacity = std::max(capacity, size);
+    glBufferData(target, capacity, NULL, GL_STREAM_DRAW);
+    glBufferSubData(target, 0, size, data);
 }
 
 void GLMesh::Render() const {
     if (IndicesCount() > 0) {
         glBindVertexArray(vertex_array_);
         // Last parameter is a byte offset.
-        if (mesh_type_ == MeshType::Triangles) glDrawElements(GL_TRIANGLES, IndicesCount(), GL_UNSIGNED_INT, 0);
+        if (mesh_type_ == MeshType::Triangles) glDrawElements(GL_TRIANGLES, IndicesCount(), index_type_, 0);
         glBindVertexArray(0);
     } else {
         // TODO: Non-indexed rendering
@@ -132,13 +173,42 @@ void GLMesh::Render() const {
     }
 }
 
+void GLMesh::SetInstanceTransforms(const std::vector<glm::mat4>& transforms) {
+    if (transforms.empty()) return;
+    glBindVertexArray(vertex_array_);
+    if (instance_vbo_ == 0) {
+        // Only meshes that get instanced pay for the buffer
+        glGenBuffers(1, &instance_vbo_);
+        glBindBuffer(GL_ARRAY_BUFFER, instance_vbo_);
+        // A mat4 attribute takes four consecutive locations, one per column, advancing once per instance
+        GLint matAttrib = GLShaderProgram::AttributeLocations().at("instance_matrix");
+        for (GLint col = 0; col < 4; col++) {
+            glEnableVertexAttribArray(matAttrib + col);
+            glVertexAttribPointer(matAttrib + col, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (const GLvoid*)(sizeof(glm::vec4) * col));
+            glVertexAttribDivisor(matAttrib + col, 1);
+        }
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, instance_vbo_);
+    // Orphan the previous contents so we don't stall on draws that are still reading them
+    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::mat4) * transforms.size(), NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(glm::mat4) * transforms.size(), transforms.data());
+    glBindVertexArray(0);
+}
+
+void GLMesh::RenderInstanced(unsigned int instance_count) const {
+    if (instance_count == 0) return;
+    glBindVertexArray(vertex_array_);
+    if (IndicesCount() > 0) {
+        if (mesh_type_ == MeshType::Triangles) glDrawElementsInstanced(GL_TRIANGLES, IndicesCount(), index_type_, 0, instance_count);
+    } else {
+        if (mesh_type_ == MeshType::Lines) glDrawArraysInstanced(GL_LINES, 0, VerticesCount(), instance_count);
+    }
+    glBindVertexArray(0);
+}
+
 GLMesh::~GLMesh() {
     glDeleteVertexArrays(1, &vertex_array_);
     glDeleteBuffers(1, &elements_vbo_);
-    glDeleteBuffers(1, &position_vbo_);
-    glDeleteBuffers(1, &normal_vbo_);
-    glDeleteBuffers(1, &color_vbo_);
-    glDeleteBuffers(1, &UV_vbo_);
-    glDeleteBuffers(1, &binormal_vbo_);
-    glDeleteBuffers(1, &tangent_vbo_);
+    glDeleteBuffers(1, &vertex_vbo_);
+    if (instance_vbo_ != 0) glDeleteBuffers(1, &instance_vbo_);
 }
@@ -18,22 +18,32 @@ public:
     GLMesh(const Mesh& mesh);
     ~GLMesh();
     virtual void Render() const;
+    // Streams one model matrix per instance into the instance buffer read by RenderInstanced
+    void SetInstanceTransforms(const std::vector<glm::mat4>& transforms);
+    void RenderInstanced(unsigned int instance_count) const;
     void SetMeshData(const Mesh& mesh);
     unsigned int IndicesCount() const { return num_indices_; }
     unsigned int VerticesCount() const { return num_vertices_; }
 protected:
     GLuint vertex_array_;
     GLuint elements_vbo_;
-    GLuint position_vbo_;
-    GLuint normal_vbo_;
-    GLuint color_vbo_;
-    GLuint UV_vbo_;
-    GLuint binormal_vbo_;
-    GLuint tangent_vbo_;
+    // All the vertex attributes, interleaved
+    GLuint vertex_vbo_;
+    GLuint instance_vbo_;
     unsigned int num_vertices_;
     unsigned int num_indices_;
+    // GL_UNSIGNED_SHORT when every index fits, otherwise GL_UNSIGNED_INT
+    GLenum index_type_;
+
+    // Meshes uploaded more than once are treated as streaming, and keep their buffers' sizes to reuse them
+    unsigned int uploads_;
+    size_t vertex_capacity_;
+    size_t index_capacity_;
+    void Upload(GLenum target, GLuint buffer, const void* data, size_t size, size_t& capacity);
 
     MeshType mesh_type_;
+
+    static const size_t VERTICES_PER_TASK = 65536;
 };
 
 #endif // GLMESH_H
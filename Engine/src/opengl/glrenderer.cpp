@@ -81,7 +81,7 @@ void GLRenderer::Setup(Scene& scene) {
     dir_lights_.clear();
     area_lights_.clear();
     // Split lights by type
-    std::vector<std::pair<SceneObject*, glm::mat4>> lights = scene.GetLights();
+    const std::vector<std::pair<SceneObject*, glm::mat4>>& lights = scene.GetLights();
     for (auto& kv : lights) {
         auto scene_object = kv.first;
         Light* light = scene_object->GetComponent<Light>();
@@ -146,9 +146,9 @@ void GLRenderer::Render(SceneObject& node) {
     // Push onto the matrix stack
     matrix_stack_.push(model_matrix_);
 
-    // Perform the transformation
+    // Perform the transformation, which the node keeps cached until it or an ancestor moves
     // NOTE: GLM uses column major ordering which is OpenGL's traditional layout
-    model_matrix_ = model_matrix_ * node.GetTransform().GetMatrix();
+    model_matrix_ = node.GetModelMatrix();
 
     if (node_prefix_.empty() || node.GetName().compare(0, node_prefix_.length(), node_prefix_) == 0) {
         try {
@@ -199,8 +199,7 @@ void GLRenderer::Render(SceneObject& node) {
     }
 
     // Render each child
-    auto children = node.GetChildren();
-    for (auto& child : children) {
+    for (auto& child : node.GetChildren()) {
         if (child->IsEnabled()) Render(*child);
     }
 
@@ -245,7 +244,7 @@ void GLRenderer::Render(SceneObject& node, PlaneCollider& collider) {
     // Normal
     points.push_back(0); points.push_back(0); points.push_back(0);
     points.push_back(0); points.push_back(0); points.push_back(0.25f);
-    collider_mesh->SetPositions(points);
+    collider_mesh->SetPositions(std::move(points));
 
     // Use Unlit Material to render with
     static const std::string COLLIDER_MATERIAL = "_internal Unlit Material";
@@ -300,7 +299,7 @@ void GLRenderer::Render(SceneObject& node, SphereCollider& collider) {
         points.push_back(curr_point.x); points.push_back(0); points.push_back(curr_point.y);
         prev_point = curr_point;
     }
-    collider_mesh->SetPositions(points);
+    collider_mesh->SetPositions(std::move(points));
 
     // Use Unlit Material to render with
     static const std::string COLLIDER_MATERIAL = "_internal Unlit Material";
@@ -327,7 +326,7 @@ void GLRenderer::Render(SceneObject& node, SphereCollider& collider) {
         points.push_back(curr_point.x); points.push_back(curr_point.y); points.push_back(0);
         prev_point = curr_point;
     }
-    collider_mesh->SetPositions(points);
+    collider_mesh->SetPositions(std::move(points));
     // Use the same rotation as the camera (get from the view_matrix)
     model_matrix_ = glm::translate(glm::mat4(), translation);
     glm::decompose(view_matrix_, scale, orientation, translation, skew, perspective);
@@ -392,7 +391,7 @@ void GLRenderer::Render(SceneObject& node, CylinderCollider& collider) {
         angle += angle_step;
     }
 
-    collider_mesh->SetPositions(points);
+    collider_mesh->SetPositions(std::move(points));
 
     // Use Unlit Material to render with
     static const std::string COLLIDER_MATERIAL = "_internal Unlit Material";
@@ -492,7 +491,7 @@ void GLRenderer::Render(SceneObject& node, PointLight& light) {
     points.push_back(-cosf(glm::radians(45.0f)) * smaller_outer_radius); points.push_back(0); points.push_back(sinf(glm::radians(45.0f)) * smaller_outer_radius);
     points.push_back(-cosf(glm::radians(45.0f)) * (inner_radius + gap)); points.push_back(0); points.push_back(-sinf(glm::radians(45.0f)) * (inner_radius + gap));
     points.push_back(-cosf(glm::radians(45.0f)) * smaller_outer_radius); points.push_back(0); points.push_back(-sinf(glm::radians(45.0f)) * smaller_outer_radius);
-    light_mesh->SetPositions(points);
+    light_mesh->SetPositions(std::move(points));
 
     // Use Unlit Material to render with
     static const std::string LIGHT_MATERIAL = "_internal Unlit Material";
@@ -531,7 +530,7 @@ void GLRenderer::Render(SceneObject& node, DirectionalLight& light) {
     points.push_back(-0.1f); points.push_back(-0.25f); points.push_back(0);
     points.push_back(0.1f); points.push_back(-0.25f); points.push_back(0);
     points.push_back(-0.1f); points.push_back(-0.25f); points.push_back(0);
-    light_mesh->SetPositions(points);
+    light_mesh->SetPositions(std::move(points));
 
     // Use Unlit Material to render with
     static const std::string LIGHT_MATERIAL = "_internal Unlit Material";
@@ -594,7 +593,7 @@ void GLRenderer::Render(SceneObject& node, AreaLight& light) {
         // Normal
         points.push_back(0); points.push_back(0); points.push_back(0);
         points.push_back(0); points.push_back(0.25f); points.push_back(0);
-        arealight_mesh->SetPositions(points);
+        arealight_mesh->SetPositions(std::move(points));
     }
 
     // Use Unlit Material to render with
@@ -665,7 +664,7 @@ void GLRenderer::Render(SceneObject& node, Camera& rendercam) {
     // Right Edge
     points.push_back(look.x + half_width); points.push_back(look.y + half_height); points.push_back(look.z);
     points.push_back(look.x + half_width); points.push_back(look.y - half_height); points.push_back(look.z);
-    camera_mesh->SetPositions(points);
+    camera_mesh->SetPositions(std::move(points));
 
     // Use Unlit Material to render with
     static const std::string CAMERA_MATERIAL = "_internal Unlit Material";
@@ -734,8 +733,11 @@ void GLRenderer::Render(SceneObject& node, Camera& rendercam) {
 
                 }
             }
-            rays_mesh->SetPositions(points);
-            rays_mesh->SetTriangles(ids);
+            {
+                MeshEdit edit(*rays_mesh);
+                edit.SetPositions(std::move(points));
+                edit.SetTriangles(std::move(ids));
+            }
 
             // Use Unlit Material to render with
             static const std::string RAYS_MATERIAL = "_internal Unlit Material";
@@ -761,7 +763,8 @@ void GLRenderer::Render(SceneObject& node, Camera& rendercam) {
 void GLRenderer::Render(SceneObject& node, Geometry &geo) {
 
     // Get the mesh to render
-    Mesh* mesh = rendering_selection_ ? geo.GetEditorMesh() : geo.GetRenderMesh();
+    Mesh* mesh = rendering_selection_ ? geo.GetEditorMesh() :
+                 wait_for_complete_meshes_ ? geo.GetCompleteRenderMesh() : geo.GetRenderMesh();
     if (mesh == nullptr) throw RenderingException(node.GetName() + "'s Geometry does not have a Mesh");
     // Get the material of the mesh
     Material* material = geo.RenderMaterial.Get();
@@ -799,7 +802,7 @@ void GLRenderer::Render(SceneObject& node, ParticleSystem& particles) {
     // Get the mesh to render as a Particle
     Geometry* geo = node.GetComponent<Geometry>();
     if (geo == nullptr) throw RenderingException(node.GetName() + " does not have a Geometry component to render");
-    Mesh* mesh = geo->GetRenderMesh();
+    Mesh* mesh = wait_for_complete_meshes_ ? geo->GetCompleteRenderMesh() : geo->GetRenderMesh();
     if (mesh == nullptr) throw RenderingException(node.GetName() + "'s Geometry does not have a Mesh");
 
     // Get the material of the mesh
@@ -817,26 +820,44 @@ void GLRenderer::Render(SceneObject& node, ParticleSystem& particles) {
     glm::quat orientation; // Decompose returns the conjugate of the quaternion for some reason
     glm::decompose(model_matrix_, s, orientation, t, skew, perspective);
     glm::mat4 parent_rot = glm::toMat4(glm::conjugate(orientation));
-    //
-    // EXTRA CREDIT:
-    // Billboard the particles when billboarding is enabled (rotate so they always face the camera)
-    // view_matrix_ will be useful for this
 
-    // For each particle:
+    // Pack every particle's model matrix into one buffer
+    instance_transforms_.clear();
     for (auto& particle : particles.GetParticles()) {
         // Set the model_matrix to reflect the particle's world position and rotation
-        glm::mat4 translation = glm::translate(glm::mat4(), particle->Position);
+        glm::mat4 translation = glm::translate(glm::mat4(), particle->RenderPosition);
         // ZXY Rotation
         glm::quat QuatAroundX = glm::angleAxis( glm::radians(particle->Rotation.x), glm::vec3(1.0, 0.0, 0.0) );
         glm::quat QuatAroundY = glm::angleAxis( glm::radians(particle->Rotation.y), glm::vec3(0.0, 1.0, 0.0) );
         glm::quat QuatAroundZ = glm::angleAxis( glm::radians(particle->Rotation.z), glm::vec3(0.0, 0.0, 1.0) );
         glm::mat4 rotation = glm::toMat4(QuatAroundZ * QuatAroundY * QuatAroundX);
-        model_matrix_ = translation * parent_rot * rotation;
+        instance_transforms_.push_back(translation * parent_rot * rotation);
+    }
 
-        // Pass the model_matrix and other uniforms to the shader
+    GLMesh& gl_mesh = resource_manager_.GetGLMesh(*mesh);
+    bool billboards = particles.Billboards.Get();
+    if (GLShaderProgram* instanced = shader.GetInstancedVariant()) {
+        // Uniforms are shared by every particle, so set them once and draw them all in one call.
+        // Billboarding (facing the camera) is done in the vertex shader.
+        SetUniforms(*instanced, *material, node);
+        GLint billboard_loc = instanced->GetUniformLocation("instance_billboard");
+        if (billboard_loc >= 0) glUniform1i(billboard_loc, billboards);
+        gl_mesh.SetInstanceTransforms(instance_transforms_);
+        gl_mesh.RenderInstanced(instance_transforms_.size());
+    } else {
+        // The shader can't be instanced, so set the uniforms once and only swap model_matrix per particle
         SetUniforms(shader, *material, node);
-        // TODO: Instanced rendering, for now just draw glDrawElements once for each particle
-        resource_manager_.GetGLMesh(*mesh).Render();
+        GLint model_loc = shader.GetUniformLocation("model_matrix");
+        glm::mat4 to_camera = glm::mat4(glm::transpose(glm::mat3(view_matrix_)));
+        for (auto& transform : instance_transforms_) {
+            glm::mat4 particle_model = transform;
+            if (billboards) {
+                // Like the instanced shader: keep position and scale, but face the camera
+                for (int k = 0; k < 3; k++) particle_model[k] = to_camera[k] * glm::length(glm::vec3(transform[k]));
+            }
+            if (model_loc >= 0) glUniformMatrix4fv(model_loc, 1, GL_FALSE, glm::value_ptr(particle_model));
+            gl_mesh.Render();
+        }
     }
 
     // Pop from the matrix stack
@@ -868,7 +889,7 @@ void GLRenderer::RenderDeformedMesh(SceneObject& node, std::vector<glm::vec3> ve
     Mesh* deformed_mesh = asset_manager_->CreateMesh("__DeformedCube__", MeshType::Lines);
     if (deformed_mesh == nullptr) deformed_mesh = asset_manager_->GetMesh("__DeformedCube__");
 
-    deformed_mesh->SetPositions(points);
+    deformed_mesh->SetPositions(std::move(points));
 
     // Use Unlit Material to render with
     static const std::string DEFORMED_MATERIAL = "_internal Unlit Material";
@@ -41,6 +41,8 @@ protected:
     std::vector<std::pair<SceneObject*, glm::mat4>> dir_lights_;
     std::vector<std::pair<SceneObject*, glm::mat4>> area_lights_;
     std::vector<std::pair<SceneObject*, glm::mat4>> env_maps_;
+    // Scratch space for per-particle model matrices, reused across emitters and frames
+    std::vector<glm::mat4> instance_transforms_;
 
     virtual void RenderEnvMaps(SceneObject& root);
 
@@ -12,12 +12,26 @@
 #include <opengl/glrenderablecubemap.h>
 #include <opengl/gltexture2d.h>
 #include <opengl/glrenderabletexture.h>
+#include <resource/revolutioncache.h>
+#include <resource/subdivisioncache.h>
 
 GLResourceManager::GLResourceManager() {
+    SubdivisionCache::Instance().MeshEvicted.Connect(this, &GLResourceManager::ReleaseGLMesh);
+    RevolutionCache::Instance().MeshEvicted.Connect(this, &GLResourceManager::ReleaseGLMesh);
+}
+
+GLResourceManager::~GLResourceManager() {
+    SubdivisionCache::Instance().MeshEvicted.Disconnect(this, &GLResourceManager::ReleaseGLMesh);
+    RevolutionCache::Instance().MeshEvicted.Disconnect(this, &GLResourceManager::ReleaseGLMesh);
+}
 
+void GLResourceManager::ReleaseGLMesh(uint64_t uid) {
+    released_meshes_.push_back(uid);
 }
 
 GLMesh& GLResourceManager::GetGLMesh(Mesh &mesh) {
+    for (uint64_t released : released_meshes_) meshes_.erase(released);
+    released_meshes_.clear();
     uint64_t uid = mesh.GetUID();
     if (meshes_.count(uid) < 1) {
         meshes_[uid] = std::make_unique<GLMesh>(mesh);
@@ -31,7 +45,6 @@ GLMesh& GLResourceManager::GetGLMesh(Mesh &mesh) {
 
 GLTextureBase& GLResourceManager::GetGLTexture(Asset &asset) {
     uint64_t uid = asset.GetUID();
-    // TODO: Check if the texture is dirty (not possible atm)
     if (textures_.count(uid) < 1) {
         switch (asset.GetType()) {
             case AssetType::Texture:
@@ -80,7 +93,6 @@ GLTextureBase& GLResourceManager::GetGLTexture(Asset &asset) {
 
 GLShaderProgram& GLResourceManager::GetGLShaderProgram(ShaderProgram& program) {
     uint64_t uid = program.GetUID();
-    // TODO: Check if the texture is dirty (not possible atm)
     if (shader_programs_.count(uid) < 1) {
         shader_programs_[uid] = std::make_unique<GLShaderProgram>(program);
         shader_programs_[uid]->MarkUpdated();
@@ -20,8 +20,11 @@
 class GLResourceManager {
 public:
     GLResourceManager();
+    ~GLResourceManager();
 
     GLMesh& GetGLMesh(Mesh& mesh);
+    // Frees the GL copy of a mesh that's going away. That happens on the next GetGLMesh, when a context is current.
+    void ReleaseGLMesh(uint64_t uid);
     GLShaderProgram& GetGLShaderProgram(ShaderProgram& program);
     GLTextureBase& GetGLTexture(Asset& asset);
 
@@ -31,6 +34,7 @@ protected:
     std::unordered_map<uint64_t, std::unique_ptr<GLMesh>> meshes_;
     std::unordered_map<uint64_t, std::unique_ptr<GLShaderProgram>> shader_programs_;
     std::unordered_map<uint64_t, std::unique_ptr<GLTextureBase>> textures_;
+    std::vector<uint64_t> released_meshes_;
 };
 
 #endif // GLRESOURCEMANAGER_H
@@ -12,6 +12,7 @@
 #include <assert.h>
 #include <fileio.h>
 #include <algorithm>
+#include <regex>
 #include <opengl/glerror.h>
 
 GLSLShader::GLSLShader(const std::string &source, GLenum GL_shader_type) {
@@ -27,7 +28,8 @@ GLSLShader::~GLSLShader() { glDeleteShader(shader_); }
 GLint GLSLShader::GetID() { return shader_; }
 
 GLShaderProgram::GLShaderProgram(const std::string& name) :
-    ShaderProgram(name)
+    ShaderProgram(name),
+    instanced_variant_built_(false)
 {
     program_ = glCreateProgram();
 
@@ -38,7 +40,8 @@ GLShaderProgram::GLShaderProgram(const std::string& name) :
 }
 
 GLShaderProgram::GLShaderProgram(const ShaderProgram& program) :
-    ShaderProgram(program.GetName(), &program)
+    ShaderProgram(program.GetName(), &program),
+    instanced_variant_built_(false)
 {
     program_ = glCreateProgram();
     VertexShader.ValueSet.Connect(this, &GLShaderProgram::OnSetVertexShader);
@@ -60,6 +63,10 @@ GLShaderProgram::GLShaderProgram(const ShaderProgram& program) :
 
 }
 
+GLShaderProgram::~GLShaderProgram() {
+    glDeleteProgram(program_);
+}
+
 bool GLShaderProgram::ValidateShaderProgram(GLuint shader_program) const {
     glValidateProgram(shader_program);
     GLint validate_status;
@@ -68,8 +75,6 @@ bool GLShaderProgram::ValidateShaderProgram(GLuint shader_program) const {
     return validate_status == GL_TRUE;
 }
 
-// TODO: Destructor?
-
 void CompileShader(GLuint shader) {
     // Compile the shader
     glCompileShader(shader);
@@ -234,9 +239,68 @@ void GLShaderProgram::OnSetShader(const std::string& name, const std::string& so
     else if (GL_shader_type == GL_FRAGMENT_SHADER) type = ShaderType::Fragment;
     else if (GL_shader_type == GL_GEOMETRY_SHADER) type = ShaderType::Geometry;
     shader_texts_[type] = source;
+    // The instanced variant was built from the old sources
+    instanced_variant_.reset();
+    instanced_variant_built_ = false;
     Changed.Emit();
 }
 
+// Spliced in right after the #version line of an instanced vertex shader, so that everything after it,
+// helper functions included, sees model_matrix as the instance's. The shader's own model_matrix and
+// view_matrix declarations are removed, since these take their place.
+static const std::string INSTANCE_MODEL_MATRIX =
+    "in mat4 instance_matrix;\n"
+    "uniform bool instance_billboard;\n"
+    "uniform mat4 view_matrix;\n"
+    "mat4 InstanceModelMatrix() {\n"
+    "    if (!instance_billboard) return instance_matrix;\n"
+    "    // Keep position and scale but swap the rotation for the inverse of the camera's to face it\n"
+    "    mat3 to_camera = transpose(mat3(view_matrix));\n"
+    "    return mat4(vec4(to_camera[0] * length(instance_matrix[0].xyz), 0.0),\n"
+    "                vec4(to_camera[1] * length(instance_matrix[1].xyz), 0.0),\n"
+    "                vec4(to_camera[2] * length(instance_matrix[2].xyz), 0.0),\n"
+    "                instance_matrix[3]);\n"
+    "}\n"
+    "#define model_matrix InstanceModelMatrix()\n";
+
+GLShaderProgram* GLShaderProgram::GetInstancedVariant() {
+    if (instanced_variant_built_) return instanced_variant_.get();
+    instanced_variant_built_ = true;
+
+    // Swap the model_matrix uniform for a per-instance attribute
+    static const std::regex model_matrix_decl("uniform\\s+mat4\\s+model_matrix\\s*;");
+    static const std::regex view_matrix_decl("uniform\\s+mat4\\s+view_matrix\\s*;");
+    static const std::regex version_decl("#version[^\\n]*\\n");
+    std::string source = GetShaderText(ShaderType::Vertex);
+    std::smatch match;
+    if (!std::regex_search(source, match, model_matrix_decl)) {
+        Debug::Log.WriteLine("\"" + GetName() + "\" has no model_matrix uniform to instance, falling back to one draw per instance", Priority::Warning);
+        return nullptr;
+    }
+    source = match.prefix().str() + match.suffix().str();
+    if (std::regex_search(source, match, view_matrix_decl)) source = match.prefix().str() + match.suffix().str();
+    if (std::regex_search(source, match, version_decl)) {
+        source = match.prefix().str() + match.str() + INSTANCE_MODEL_MATRIX + match.suffix().str();
+    } else {
+        source = INSTANCE_MODEL_MATRIX + source;
+    }
+
+    std::unique_ptr<GLShaderProgram> variant = std::make_unique<GLShaderProgram>(GetName() + " (Instanced)");
+    variant->SetShader("Instanced Vertex", source, ShaderType::Vertex);
+    if (!GetShaderText(ShaderType::Geometry).empty())
+        variant->SetShader("Geometry", GetShaderText(ShaderType::Geometry), ShaderType::Geometry);
+    if (!GetShaderText(ShaderType::Fragment).empty())
+        variant->SetShader("Fragment", GetShaderText(ShaderType::Fragment), ShaderType::Fragment);
+
+    // If anything failed to compile or link, the attribute won't be where we bound it
+    if (glGetAttribLocation(variant->GetProgram(), "instance_matrix") != AttributeLocations().at("instance_matrix")) {
+        Debug::Log.WriteLine("\"" + GetName() + "\" could not be instanced, falling back to one draw per instance", Priority::Warning);
+        return nullptr;
+    }
+    instanced_variant_ = std::move(variant);
+    return instanced_variant_.get();
+}
+
 std::vector<std::pair<std::string, DataType>> GLShaderProgram::GetShaderInputs() const {
     return std::vector<std::pair<std::string, DataType>>(uniforms_list_);
 }
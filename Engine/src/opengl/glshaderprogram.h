@@ -32,13 +32,16 @@ public:
             {"color", 2},
             {"texcoord", 3},
             {"binormal", 4},
-            {"tangent", 5}
+            {"tangent", 5},
+            // Per-instance model matrix, occupies locations 6 through 9 (one per column)
+            {"instance_matrix", 6}
         };
         return attribute_locations;
     }
 
     GLShaderProgram(const std::string& name);
     GLShaderProgram(const ShaderProgram& program);
+    ~GLShaderProgram();
 
     GLuint GetProgram() { return program_; }
     virtual bool IsValidShaderProgram() const override { return ValidateShaderProgram(program_); }
@@ -46,6 +49,10 @@ public:
     virtual std::vector<std::pair<std::string, DataType>> GetShaderInputs() const override;
     std::map<std::string, std::pair<GLint, DataType>> GetUniformLocations() const;
     GLint GetUniformLocation(const std::string& name);
+    // Returns this program with model_matrix replaced by the per-instance "instance_matrix" attribute,
+    // for drawing many copies of a mesh in one instanced draw call. Built on first use. Returns nullptr
+    // if the vertex shader doesn't declare a model_matrix uniform or the variant fails to build.
+    GLShaderProgram* GetInstancedVariant();
 protected:
     const std::string vert_source_ =
         "#version 150\n"
@@ -71,6 +78,8 @@ protected:
     std::map<std::string, std::pair<GLint, DataType>> uniform_locations_;
     std::vector<std::pair<std::string, DataType>> uniforms_list_;
     std::map<GLenum, std::unique_ptr<GLSLShader>> attached_shaders_;
+    std::unique_ptr<GLShaderProgram> instanced_variant_;
+    bool instanced_variant_built_;
     // Internal calls that actually do the work
     void OnSetVertexShader(std::string path);
     void OnSetFragmentShader(std::string path);
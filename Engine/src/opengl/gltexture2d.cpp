@@ -9,8 +9,17 @@
  ****************************************************************************/
 #include <glextinclude.h>
 #include "gltexture2d.h"
+#include <cstring>
 #include <opengl/glerror.h>
 
+// From EXT_texture_compression_s3tc, which not every GL header defines
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
 GLTexture2D::GLTexture2D(const Texture& tex) :
     GLTextureBase(tex, GL_TEXTURE_2D)
 {
@@ -18,30 +27,36 @@ GLTexture2D::GLTexture2D(const Texture& tex) :
 }
 
 void GLTexture2D::SetTextureData(const Texture& tex) {
-    unsigned int width = tex.GetWidth();
-    unsigned int height = tex.GetHeight();
-    const unsigned char* image = tex.GetImage();
-    // Flip vertically due to how OpenGL has the image origin in the bottom-left corner as opposed to the top-left
-    const unsigned int CHANNELS = 4; // RGBA
-    unsigned int bytes_width = width * CHANNELS;
-    unsigned int bytes_height = height * CHANNELS;
-    unsigned char* flipped = new unsigned char[bytes_width * bytes_height];
-    for (unsigned int y = 0; y < height; y++) {
-        for (unsigned int x = 0; x < width; x++) {
-            unsigned int j = height - 1 - y;
-            unsigned int i = x * 4;
-            // Copy over a pixel
-            for (unsigned int ch = 0; ch < CHANNELS; ch++)
-                flipped[y * bytes_width + i + ch] = image[j * bytes_width + i + ch];
-        }
-    }
-
     // Create reference to the texture object and bind it
     Bind(0);
 
-    // Load the data from the image buffer to define the GLTexture
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, flipped);
-    delete[] flipped;
+    // Compressed textures come with their mip chain, already flipped, and upload as they are
+    const std::vector<TextureLevel>* levels = tex.GetLevels();
+    if (levels != nullptr) {
+        GLenum internal_format = tex.GetFormat() == TextureFormat::BC1 ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        for (size_t i = 0; i < levels->size(); i++) {
+            const TextureLevel& level = (*levels)[i];
+            glCompressedTexImage2D(GL_TEXTURE_2D, i, internal_format, level.width, level.height, 0, level.blocks.size(), level.blocks.data());
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels->size() - 1);
+    } else {
+        unsigned int width = tex.GetWidth();
+        unsigned int height = tex.GetHeight();
+        const unsigned char* image = tex.GetImage();
+        // Flip vertically due to how OpenGL has the image origin in the bottom-left corner as opposed to the top-left
+        const size_t CHANNELS = 4; // RGBA
+        size_t bytes_width = width * CHANNELS;
+        unsigned char* flipped = new unsigned char[bytes_width * height];
+        for (unsigned int y = 0; y < height; y++) {
+            memcpy(flipped + y * bytes_width, image + (height - 1 - y) * bytes_width, bytes_width);
+        }
+
+        // Load the data from the image buffer to define the GLTexture
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, flipped);
+        delete[] flipped;
+        // Back to the default, in case the texture was compressed before it was reloaded
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000);
+    }
 
     // Set texture additional properties
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -54,7 +69,7 @@ void GLTexture2D::SetTextureData(const Texture& tex) {
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     }
-    glGenerateMipmap(GL_TEXTURE_2D);
+    if (levels == nullptr) glGenerateMipmap(GL_TEXTURE_2D);
 
     Unbind(0);
 }
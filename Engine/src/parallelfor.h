@@ -0,0 +1,62 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#ifndef PARALLELFOR_H
+#define PARALLELFOR_H
+
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+
+// One range of a ParallelFor, run on the global thread pool
+template <typename F>
+class ParallelForRange : public QRunnable {
+public:
+    ParallelForRange(F& fn, size_t begin, size_t end, QSemaphore& done) :
+        fn_(fn), begin_(begin), end_(end), done_(done) { }
+
+    void run() override {
+        fn_(begin_, end_);
+        done_.release();
+    }
+
+private:
+    F& fn_;
+    size_t begin_;
+    size_t end_;
+    QSemaphore& done_;
+};
+
+// Calls fn(begin, end) over consecutive ranges that cover [0, count), spread over the global thread pool and
+// the calling thread, and returns once every range is done. Ranges hold at least min_chunk items, so small
+// counts run on the calling thread alone. fn is called concurrently, so it may only write to its own range.
+// Don't call this from a task running on the global thread pool, since it waits for tasks queued there.
+template <typename F>
+void ParallelFor(size_t count, size_t min_chunk, F fn) {
+    size_t threads = std::max(QThread::idealThreadCount(), 1);
+    size_t ranges = std::min(threads, count / std::max(min_chunk, (size_t) 1));
+    if (ranges <= 1) {
+        fn((size_t) 0, count);
+        return;
+    }
+
+    QSemaphore done;
+    size_t chunk = (count + ranges - 1) / ranges;
+    size_t begin = 0;
+    size_t started = 0;
+    for (; begin + chunk < count; begin += chunk, started++) {
+        QThreadPool::globalInstance()->start(new ParallelForRange<F>(fn, begin, begin + chunk, done));
+    }
+    fn(begin, count);
+    done.acquire(started);
+}
+
+#endif // PARALLELFOR_H
@@ -21,7 +21,7 @@ bool BooleanProperty::Get() const {
 
 void BooleanProperty::Set(bool value) {
     value_ = value;
-    if (allow_signals_) ValueSet.Emit(value);
+    NotifyChanged();
 }
 
 void BooleanProperty::SaveToYAML(YAML::Emitter& out) const {
@@ -31,3 +31,15 @@ void BooleanProperty::SaveToYAML(YAML::Emitter& out) const {
 void BooleanProperty::LoadFromYAML(const YAML::Node& node) {
     Set(node.as<bool>());
 }
+
+void BooleanProperty::SaveToBinary(BinaryWriter& out) const {
+    out.WriteUInt8(value_);
+}
+
+void BooleanProperty::LoadFromBinary(BinaryReader& in) {
+    Set(in.ReadUInt8() != 0);
+}
+
+void BooleanProperty::CopyValueFrom(const Property& other) {
+    if (auto source = dynamic_cast<const BooleanProperty*>(&other)) Set(source->Get());
+}
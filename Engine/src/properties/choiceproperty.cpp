@@ -31,7 +31,7 @@ void ChoiceProperty::Set(int index) {
     current_index_ = index;
     if (current_index_ >= choices_.size()) current_index_ = choices_.size() - 1;
 
-    if (allow_signals_) ValueSet.Emit(current_index_);
+    NotifyChanged();
 }
 
 std::vector<std::string> ChoiceProperty::GetChoices() const {
@@ -45,3 +45,15 @@ void ChoiceProperty::SaveToYAML(YAML::Emitter& out) const {
 void ChoiceProperty::LoadFromYAML(const YAML::Node& node) {
     Set(node.as<int>());
 }
+
+void ChoiceProperty::SaveToBinary(BinaryWriter& out) const {
+    out.WriteInt32(current_index_);
+}
+
+void ChoiceProperty::LoadFromBinary(BinaryReader& in) {
+    Set(in.ReadInt32());
+}
+
+void ChoiceProperty::CopyValueFrom(const Property& other) {
+    if (auto source = dynamic_cast<const ChoiceProperty*>(&other)) Set(source->Get());
+}
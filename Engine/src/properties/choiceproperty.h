@@ -25,8 +25,14 @@ public:
 
     virtual void SaveToYAML(YAML::Emitter& out) const override;
     virtual void LoadFromYAML(const YAML::Node& node) override;
+    virtual void SaveToBinary(BinaryWriter& out) const override;
+    virtual void LoadFromBinary(BinaryReader& in) override;
+    virtual void CopyValueFrom(const Property& other) override;
 
     std::vector<std::string> GetChoices() const;
+protected:
+    virtual void EmitChanged() override { ValueSet.Emit(current_index_); }
+
 private:
     std::vector<std::string> choices_;
     size_t current_index_;
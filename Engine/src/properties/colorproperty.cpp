@@ -58,11 +58,17 @@ void ColorProperty::Set(glm::vec4 value) {
     B.UnblockSignals();
     A.UnblockSignals();
 
-    if (allow_signals_) ValueSet.Emit(value_);
+    NotifyChanged();
 }
 
 bool ColorProperty::UsesAlpha() const { return use_alpha_; }
 
+bool ColorProperty::UpdateFromChildren() {
+    value_ = glm::vec4(R.Get(), G.Get(), B.Get(), use_alpha_ ? A.Get() : 1.0);
+    NotifyChanged();
+    return true;
+}
+
 void ColorProperty::OnRChanged(double r) {
     glm::vec4 value = Get();
     value.r = r;
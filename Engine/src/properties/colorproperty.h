@@ -25,6 +25,11 @@ public:
     void Set(glm::vec3 value);
 
     bool UsesAlpha() const;
+
+    virtual bool UpdateFromChildren() override;
+protected:
+    virtual void EmitChanged() override { ValueSet.Emit(value_); }
+
 private:
     bool use_alpha_;
     glm::vec4 value_;
@@ -12,6 +12,8 @@
 #include <scene/scenemanager.h>
 #include <QDebug>
 
+float DoubleProperty::scene_time_ = 0.0f;
+
 DoubleProperty::DoubleProperty(double value) :
     Property(),
     value_(value)
@@ -46,22 +48,24 @@ void DoubleProperty::Set(double value) {
     if (std::abs(value_ - value) <= std::numeric_limits<double>::epsilon()) return;
     value_ = value;
     if (curve_ && curve_->IsInterpolating() && CurveSampler::AUTOKEY) {
-        curve_->SetKeyframe(frame_, value_);
+        curve_->SetKeyframe(scene_time_, value_);
         CurveUpdated.Emit();
     }
-    if (allow_signals_) ValueChanged.Emit(value);
+    NotifyChanged();
 }
 
 void DoubleProperty::SetAnimationTime(float t) {
-    frame_ = t;
     if (curve_ && curve_->GetKeyframesCount() > 0) {
-        float value = curve_->SampleAt(t);
-        if (std::abs(value_ - value) < std::numeric_limits<double>::epsilon()) return;
-        value_ = value;
-        if (allow_signals_) ValueChanged.Emit(value);
+        if (SetAnimatedValue(curve_->SampleAt(t))) NotifyValueChanged();
     }
 }
 
+bool DoubleProperty::SetAnimatedValue(double value) {
+    if (std::abs(value_ - value) < std::numeric_limits<double>::epsilon()) return false;
+    value_ = value;
+    return true;
+}
+
 void DoubleProperty::SaveToYAML(YAML::Emitter& out) const {
     if (curve_ && curve_->GetKeyframesCount() > 1) {
         out << YAML::BeginMap;
@@ -86,6 +90,7 @@ void DoubleProperty::SaveToYAML(YAML::Emitter& out) const {
 }
 
 void DoubleProperty::LoadFromYAML(const YAML::Node& node) {
+    bool had_curve = curve_ != nullptr;
     if (curve_ != nullptr) {
         delete curve_;
         curve_ = nullptr;
@@ -114,10 +119,87 @@ void DoubleProperty::LoadFromYAML(const YAML::Node& node) {
             SetAnimationTime(0);
         } else {
             value_ = y.size()==1 ? y[0] : 0;
-            if (allow_signals_) ValueChanged.Emit(value_);
+            NotifyChanged();
         }
     } else {
         value_ = node.as<double>();
-        if (allow_signals_) ValueChanged.Emit(value_);
+        NotifyChanged();
+    }
+    if (had_curve || curve_ != nullptr) CurveAssigned.Emit();
+}
+
+// Binary encodings: a constant value, or a curve's settings and keyframes
+static const uint8_t BINARY_VALUE = 0;
+static const uint8_t BINARY_CURVE = 1;
+
+void DoubleProperty::SaveToBinary(BinaryWriter& out) const {
+    if (curve_ && curve_->GetKeyframesCount() > 1) {
+        std::vector<float> t;
+        std::vector<float> y;
+        for (auto& keyframe : curve_->GetKeyframes()) {
+            t.push_back(keyframe->Get().x);
+            y.push_back(keyframe->Get().y);
+        }
+        out.WriteUInt8(BINARY_CURVE);
+        out.WriteString(CurveSampler::TypeToString()[curve_->GetCurveType()]);
+        out.WriteUInt8(curve_->IsWrapping());
+        out.WriteFloats(t);
+        out.WriteFloats(y);
+    } else {
+        out.WriteUInt8(BINARY_VALUE);
+        out.WriteDouble(curve_ && curve_->GetKeyframesCount() == 1 ? curve_->GetKeyframes()[0]->Get().y : value_);
+    }
+}
+
+void DoubleProperty::LoadFromBinary(BinaryReader& in) {
+    bool had_curve = curve_ != nullptr;
+    if (curve_ != nullptr) {
+        delete curve_;
+        curve_ = nullptr;
+    }
+    if (in.ReadUInt8() == BINARY_CURVE) {
+        std::string interpolation = in.ReadString();
+        bool wrap = in.ReadUInt8() != 0;
+        std::vector<float> t = in.ReadFloats();
+        std::vector<float> y = in.ReadFloats();
+        if (t.size() != y.size()) throw FileIOException("Curve has " + std::to_string(t.size()) + " frame times but " + std::to_string(y.size()) + " values");
+
+        //MAKING THE CURVE CAUSES THE SCREEN TO REFRESH
+        curve_ = &(SceneManager::Instance()->GetCurveSamplerFactory()->CreateCurveSampler());
+        curve_->SetCurveType(CurveSampler::StringToType()[interpolation]);
+        curve_->SetWrapping(wrap);
+        curve_->SetKeyframes(t, y);
+        SetAnimationTime(0);
+    } else {
+        value_ = in.ReadDouble();
+        NotifyChanged();
+    }
+    if (had_curve || curve_ != nullptr) CurveAssigned.Emit();
+}
+
+void DoubleProperty::CopyValueFrom(const Property& other) {
+    const DoubleProperty* source = dynamic_cast<const DoubleProperty*>(&other);
+    if (source == nullptr) return;
+    bool had_curve = curve_ != nullptr;
+    if (curve_ != nullptr) {
+        delete curve_;
+        curve_ = nullptr;
+    }
+    if (source->curve_ && source->curve_->GetKeyframesCount() > 1) {
+        std::vector<float> t;
+        std::vector<float> y;
+        for (auto& keyframe : source->curve_->GetKeyframes()) {
+            t.push_back(keyframe->Get().x);
+            y.push_back(keyframe->Get().y);
+        }
+        curve_ = &(SceneManager::Instance()->GetCurveSamplerFactory()->CreateCurveSampler());
+        curve_->SetCurveType(source->curve_->GetCurveType());
+        curve_->SetWrapping(source->curve_->IsWrapping());
+        curve_->SetKeyframes(t, y);
+        SetAnimationTime(scene_time_);
+    } else {
+        value_ = source->curve_ && source->curve_->GetKeyframesCount() == 1 ? source->curve_->GetKeyframes()[0]->Get().y : source->value_;
+        NotifyChanged();
     }
+    if (had_curve || curve_ != nullptr) CurveAssigned.Emit();
 }
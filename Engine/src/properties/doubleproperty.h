@@ -23,6 +23,8 @@ class DoubleProperty : public Property {
 public:
     Signal1<double> ValueChanged;
     Signal0<> CurveUpdated;
+    // Emitted when a curve is attached to or removed from this property
+    Signal0<> CurveAssigned;
 
     DoubleProperty(double value = 0.0);
     DoubleProperty(double value, double min, double max, double step);
@@ -32,8 +34,19 @@ public:
     void Set(double value);
 
     CurveSampler* GetCurve() { return curve_; }
-    void SetCurve(CurveSampler* curve) { curve_ = curve; }
+    void SetCurve(CurveSampler* curve) { curve_ = curve; CurveAssigned.Emit(); }
+    bool IsAnimated() const { return curve_ != nullptr; }
     void SetAnimationTime(float frame);
+    // Takes a value sampled from the curve without emitting ValueChanged, so that
+    // several animated properties can be updated before anything reacts to them.
+    // Returns whether the value changed; call NotifyValueChanged afterwards if it did.
+    bool SetAnimatedValue(double value);
+    void NotifyValueChanged() { NotifyChanged(); }
+
+    // The time the scene's animation was last evaluated at. Setting a property with a curve keys it at this time,
+    // including a curve that was only just attached, so the time is shared instead of kept by each property.
+    static void SetSceneTime(float t) { scene_time_ = t; }
+    static float GetSceneTime() { return scene_time_; }
 
     bool IsRange() const { return range_!=nullptr; }
     double GetMin() const { return range_->min; }
@@ -42,10 +55,16 @@ public:
 
     virtual void SaveToYAML(YAML::Emitter& out) const override;
     virtual void LoadFromYAML(const YAML::Node& node) override;
+    virtual void SaveToBinary(BinaryWriter& out) const override;
+    virtual void LoadFromBinary(BinaryReader& in) override;
+    virtual void CopyValueFrom(const Property& other) override;
+
+protected:
+    virtual void EmitChanged() override { ValueChanged.Emit(value_); }
 
 private:
     double value_;
-    float frame_;
+    static float scene_time_;
     RangePropertyData* range_ = nullptr;
     CurveSampler* curve_ = nullptr;
 };
@@ -26,7 +26,7 @@ FileType FileProperty::GetFileType() const {
 
 void FileProperty::Set(std::string path) {
     path_ = path;
-    if (allow_signals_) ValueSet.Emit(path_);
+    NotifyChanged();
 }
 
 void FileProperty::SaveToYAML(YAML::Emitter& out) const {
@@ -37,3 +37,14 @@ void FileProperty::LoadFromYAML(const YAML::Node& node) {
     Set(node.as<std::string>());
 }
 
+void FileProperty::SaveToBinary(BinaryWriter& out) const {
+    out.WriteString(path_);
+}
+
+void FileProperty::LoadFromBinary(BinaryReader& in) {
+    Set(in.ReadString());
+}
+
+void FileProperty::CopyValueFrom(const Property& other) {
+    if (auto source = dynamic_cast<const FileProperty*>(&other)) Set(source->Get());
+}
@@ -24,7 +24,7 @@ int IntProperty::Get() const {
 void IntProperty::Set(int value) {
     value_ = value;
     if (is_unsigned_ && (value_ < 0)) value_ = 0;
-    if (allow_signals_) ValueChanged.Emit(value);
+    NotifyChanged();
 }
 
 void IntProperty::SaveToYAML(YAML::Emitter& out) const {
@@ -34,3 +34,15 @@ void IntProperty::SaveToYAML(YAML::Emitter& out) const {
 void IntProperty::LoadFromYAML(const YAML::Node& node) {
     Set(node.as<int>());
 }
+
+void IntProperty::SaveToBinary(BinaryWriter& out) const {
+    out.WriteInt32(value_);
+}
+
+void IntProperty::LoadFromBinary(BinaryReader& in) {
+    Set(in.ReadInt32());
+}
+
+void IntProperty::CopyValueFrom(const Property& other) {
+    if (auto source = dynamic_cast<const IntProperty*>(&other)) Set(source->Get());
+}
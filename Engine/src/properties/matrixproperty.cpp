@@ -22,7 +22,7 @@ glm::mat4 Mat4Property::Get() const {
 
 void Mat4Property::Set(glm::mat4 value) {
     value_ = value;
-    if (allow_signals_) ValueSet.Emit(value);
+    NotifyChanged();
 }
 
 void Mat4Property::SaveToYAML(YAML::Emitter& out) const {
@@ -32,3 +32,21 @@ void Mat4Property::SaveToYAML(YAML::Emitter& out) const {
 void Mat4Property::LoadFromYAML(const YAML::Node& node) {
     Set(node.as<glm::mat4>());
 }
+
+void Mat4Property::SaveToBinary(BinaryWriter& out) const {
+    for (int col = 0; col < 4; col++) {
+        for (int row = 0; row < 4; row++) out.WriteFloat(value_[col][row]);
+    }
+}
+
+void Mat4Property::LoadFromBinary(BinaryReader& in) {
+    glm::mat4 value;
+    for (int col = 0; col < 4; col++) {
+        for (int row = 0; row < 4; row++) value[col][row] = in.ReadFloat();
+    }
+    Set(value);
+}
+
+void Mat4Property::CopyValueFrom(const Property& other) {
+    if (auto source = dynamic_cast<const Mat4Property*>(&other)) Set(source->Get());
+}
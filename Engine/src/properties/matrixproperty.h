@@ -24,6 +24,12 @@ public:
 
     virtual void SaveToYAML(YAML::Emitter& out) const override;
     virtual void LoadFromYAML(const YAML::Node& node) override;
+    virtual void SaveToBinary(BinaryWriter& out) const override;
+    virtual void LoadFromBinary(BinaryReader& in) override;
+    virtual void CopyValueFrom(const Property& other) override;
+
+protected:
+    virtual void EmitChanged() override { ValueSet.Emit(value_); }
 
 private:
     glm::mat4 value_;
@@ -18,14 +18,18 @@
 #include <map>
 #include <memory>
 #include "serializable.h"
+#include <binarystream.h>
+#include <properties/propertybatch.h>
 
 // For signal.h library
 using namespace Gallant;
 
 class Property : public virtual Serializable {
 protected:
-    Property() : locked_(false), hidden_(false), allow_signals_(true) {}
+    Property() : locked_(false), hidden_(false), allow_signals_(true), batch_pending_(false) {}
 public:
+    virtual ~Property() { PropertyBatch::Cancel(*this); }
+
     void BlockSignals() { allow_signals_ = false; }
     void UnblockSignals() { allow_signals_ = true; }
 
@@ -39,11 +43,31 @@ public:
         if (allow_signals_) HiddenChanged.Emit(hidden_);
     }
 
+    // Takes the value of another property of the same type, as if it had been saved and loaded.
+    // By default this goes through the binary encoding.
+    virtual void CopyValueFrom(const Property& other) {
+        BinaryWriter out;
+        other.SaveToBinary(out);
+        BinaryReader in(out.GetData().data(), out.GetData().size());
+        LoadFromBinary(in);
+    }
+
     Signal1<bool> HiddenChanged;
 protected:
     bool locked_;
     bool hidden_;
     bool allow_signals_;
+
+    // Emits the property's change signal, or records it to be emitted once when the open PropertyBatch commits
+    void NotifyChanged() {
+        if (allow_signals_ && !PropertyBatch::Defer(*this)) PropertyBatch::Emit(*this);
+    }
+    // Emits the change signal with the current value
+    virtual void EmitChanged() {}
+
+private:
+    friend class PropertyBatch;
+    bool batch_pending_;
 };
 
 class ObjectWithProperties : public virtual Serializable
@@ -70,6 +94,40 @@ public:
        }
     }
 
+    // Properties are stored as a table of names and sized blocks, so unknown ones can be skipped
+    virtual void SaveToBinary(BinaryWriter& out) const {
+        out.WriteUInt32(property_order_.size());
+        for (const std::string& name : property_order_) {
+            out.WriteString(name);
+            size_t block = out.BeginBlock();
+            properties_.at(name)->SaveToBinary(out);
+            out.EndBlock(block);
+        }
+    }
+
+    virtual void LoadFromBinary(BinaryReader& in) {
+        uint32_t count = in.ReadUInt32();
+        for (uint32_t i = 0; i < count; i++) {
+            std::string key = in.ReadString();
+            size_t end = in.BeginBlock();
+            auto it = properties_.find(key);
+            if (it != properties_.end()) {
+                it->second->LoadFromBinary(in);
+            } else {
+                qDebug() << "Unknown key: " << key.c_str();
+            }
+            in.Seek(end);
+        }
+    }
+
+    // Copies the values of the other object's properties into the properties with the same names
+    void CopyPropertiesFrom(const ObjectWithProperties& other) {
+        for (const std::string& name : other.property_order_) {
+            auto it = properties_.find(name);
+            if (it != properties_.end()) it->second->CopyValueFrom(*other.properties_.at(name));
+        }
+    }
+
     const std::vector<std::string>& GetProperties() const {
         return property_order_;
     }
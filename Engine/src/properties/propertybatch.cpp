@@ -0,0 +1,95 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#include "propertybatch.h"
+#include <properties/property.h>
+#include <algorithm>
+#include <QCoreApplication>
+#include <QThread>
+
+// The batch state is shared and unsynchronized, so only the GUI thread may touch it
+static bool OnGuiThread() {
+    return qApp == nullptr || QThread::currentThread() == qApp->thread();
+}
+
+unsigned int PropertyBatch::depth_ = 0;
+bool PropertyBatch::committing_ = false;
+unsigned long PropertyBatch::signals_emitted_ = 0;
+std::vector<Property*> PropertyBatch::pending_properties_;
+std::vector<std::pair<const void*, std::function<void()>>> PropertyBatch::pending_calls_;
+std::unordered_map<const void*, size_t> PropertyBatch::pending_call_keys_;
+
+bool PropertyBatch::Defer(Property& property) {
+    Q_ASSERT(OnGuiThread());
+    if (!IsOpen()) return false;
+    if (!property.batch_pending_) {
+        property.batch_pending_ = true;
+        pending_properties_.push_back(&property);
+    }
+    return true;
+}
+
+void PropertyBatch::Defer(const void* key, std::function<void()> fn) {
+    Q_ASSERT(OnGuiThread());
+    if (!IsOpen()) {
+        fn();
+        return;
+    }
+    if (pending_call_keys_.count(key) > 0) return;
+    pending_call_keys_[key] = pending_calls_.size();
+    pending_calls_.push_back(std::make_pair(key, std::move(fn)));
+}
+
+void PropertyBatch::Cancel(const void* key) {
+    auto it = pending_call_keys_.find(key);
+    if (it == pending_call_keys_.end()) return;
+    pending_calls_[it->second].second = nullptr;
+    pending_call_keys_.erase(it);
+}
+
+void PropertyBatch::Cancel(Property& property) {
+    if (!property.batch_pending_) return;
+    property.batch_pending_ = false;
+    std::replace(pending_properties_.begin(), pending_properties_.end(), &property, (Property*) nullptr);
+}
+
+void PropertyBatch::Emit(Property& property) {
+    signals_emitted_++;
+    property.EmitChanged();
+}
+
+void PropertyBatch::Commit() {
+    Q_ASSERT(OnGuiThread());
+    // Listeners may change more properties or defer more work while we commit, so keep
+    // recording until both queues are drained
+    committing_ = true;
+    size_t next_property = 0;
+    size_t next_call = 0;
+    while (next_property < pending_properties_.size() || next_call < pending_calls_.size()) {
+        // Signal every changed property first, so deferred work sees all the new values
+        while (next_property < pending_properties_.size()) {
+            Property* property = pending_properties_[next_property++];
+            if (property == nullptr) continue; // Destroyed since it changed
+            property->batch_pending_ = false;
+            Emit(*property);
+        }
+        if (next_call < pending_calls_.size()) {
+            size_t index = next_call++;
+            std::function<void()> fn = std::move(pending_calls_[index].second);
+            // Let the key defer again from here on
+            auto it = pending_call_keys_.find(pending_calls_[index].first);
+            if (it != pending_call_keys_.end() && it->second == index) pending_call_keys_.erase(it);
+            if (fn) fn();
+        }
+    }
+    pending_properties_.clear();
+    pending_calls_.clear();
+    pending_call_keys_.clear();
+    committing_ = false;
+}
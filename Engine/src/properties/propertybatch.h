@@ -0,0 +1,67 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#ifndef PROPERTYBATCH_H
+#define PROPERTYBATCH_H
+
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+class Property;
+
+// Groups property changes so that listeners react once per object instead of once per change.
+// While a batch is open, properties record that they changed instead of emitting their change signal.
+// When the outermost batch closes, every changed property emits once with its final value, and then
+// any work that listeners deferred runs once per key. Batches nest.
+// Batches and the pending changes are shared by the whole program and are not synchronized, so properties
+// may only be changed, and batches opened, on the GUI thread. Worker threads must hand results back to it.
+//
+//     {
+//         PropertyBatch batch;
+//         transform.Translation.Set(t);
+//         transform.Rotation.Set(r);
+//     } // Transform recomputes its matrix once here
+class PropertyBatch {
+public:
+    PropertyBatch() { depth_++; }
+    ~PropertyBatch() { if (--depth_ == 0) Commit(); }
+    PropertyBatch(const PropertyBatch&) = delete;
+    PropertyBatch& operator=(const PropertyBatch&) = delete;
+
+    // Whether changes are currently being recorded rather than signalled
+    static bool IsOpen() { return depth_ > 0 || committing_; }
+
+    // Records that the property changed. Returns false if no batch is open, in which case the caller should emit now.
+    static bool Defer(Property& property);
+    // Runs fn when the batch commits, once for all calls with the same key. Runs fn now if no batch is open.
+    static void Defer(const void* key, std::function<void()> fn);
+    // Forgets deferred work for a key, e.g. when the object that deferred it is destroyed
+    static void Cancel(const void* key);
+    // Forgets a recorded property that is being destroyed
+    static void Cancel(Property& property);
+
+    // Emits a property's change signal and counts it
+    static void Emit(Property& property);
+    // Total number of property change signals emitted, for instrumentation
+    static unsigned long GetSignalsEmitted() { return signals_emitted_; }
+
+private:
+    static void Commit();
+
+    static unsigned int depth_;
+    static bool committing_;
+    static unsigned long signals_emitted_;
+    static std::vector<Property*> pending_properties_;
+    static std::vector<std::pair<const void*, std::function<void()>>> pending_calls_;
+    static std::unordered_map<const void*, size_t> pending_call_keys_;
+};
+
+#endif // PROPERTYBATCH_H
@@ -24,6 +24,11 @@ public:
         ValueSet.Emit(this);
     }
 
+    // Called after animation has set some of the group's child properties without signals.
+    // Groups that combine their children into one value take it from them and signal once,
+    // returning true. Otherwise the children signal their own changes.
+    virtual bool UpdateFromChildren() { return false; }
+
     virtual void SaveToYAML(YAML::Emitter& out) const {
         ObjectWithProperties::SaveToYAML(out);
     }
@@ -31,6 +36,18 @@ public:
     virtual void LoadFromYAML(const YAML::Node& node) {
        ObjectWithProperties::LoadFromYAML(node);
     }
+
+    virtual void SaveToBinary(BinaryWriter& out) const {
+        ObjectWithProperties::SaveToBinary(out);
+    }
+
+    virtual void LoadFromBinary(BinaryReader& in) {
+        ObjectWithProperties::LoadFromBinary(in);
+    }
+
+    virtual void CopyValueFrom(const Property& other) override {
+        if (auto source = dynamic_cast<const ObjectWithProperties*>(&other)) CopyPropertiesFrom(*source);
+    }
 };
 
 
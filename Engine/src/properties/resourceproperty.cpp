@@ -43,6 +43,16 @@ Texture *TextureProperty::Get() const {
     }
 }
 
+TraceColor TextureProperty::GetTraceColor() const {
+    TraceColor trace_color;
+    if (UseTexture.Get() && reinterpret_cast<ResourceProperty<Texture>*>(MappedColor)->IsSet()) {
+        trace_color.texture = reinterpret_cast<ResourceProperty<Texture>*>(MappedColor)->Get();
+    } else {
+        trace_color.color = glm::vec4(SolidColor.GetRGB(), 1.0f);
+    }
+    return trace_color;
+}
+
 void TextureProperty::SetColor(glm::vec3 color)
 {
     SolidColor.Set(color);
@@ -16,6 +16,7 @@
 #include <properties/property.h>
 
 class Texture;
+struct TraceColor;
 
 class ResourcePropertyBase : public Property {
 public:
@@ -31,6 +32,14 @@ public:
 
     static void SetFromName(ResourcePropertyBase* obj, std::string name);
 
+    virtual void CopyValueFrom(const Property& other) override {
+        if (auto source = dynamic_cast<const ResourcePropertyBase*>(&other)) SetAsset(source->GetAsset());
+    }
+
+protected:
+    virtual void EmitChanged() override { ValueSet.Emit(asset_); }
+
+public:
     Asset* asset_;
     AssetType asset_type_;
 };
@@ -50,7 +59,7 @@ public:
     virtual void Set(ResourceType* asset) {
         asset_ = asset;
         if (asset_ != nullptr) asset_->Deleted.Connect(this, &ResourceProperty::AssetDeleted);
-        if(allow_signals_) ValueSet.Emit(asset_);
+        NotifyChanged();
     }
 
     virtual AssetType GetAssetType() const override { return asset_type_; }
@@ -71,11 +80,18 @@ public:
         ResourcePropertyBase::SetFromName(this, name);
     }
 
+    virtual void SaveToBinary(BinaryWriter& out) const override {
+        out.WriteString(asset_ ? asset_->GetName() : "");
+    }
+    virtual void LoadFromBinary(BinaryReader& in) override {
+        ResourcePropertyBase::SetFromName(this, in.ReadString());
+    }
+
     virtual bool IsSet() const override { return asset_ != nullptr; }
 private:
     void AssetDeleted() {
         asset_ = nullptr;
-        if (allow_signals_) ValueSet.Emit(asset_);
+        NotifyChanged();
     }
 
 
@@ -105,6 +121,8 @@ class TextureProperty : public PropertyGroup {
 
     //DO NOT call this from a trace thread, it modifies the AssetManager
     Texture* Get() const;
+    // The mapped texture, or the solid color on its own (without the texture made for it for OpenGL)
+    TraceColor GetTraceColor() const;
 
     void SetColor(glm::vec3 color);
     void Set(Texture* tex);
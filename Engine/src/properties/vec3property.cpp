@@ -64,7 +64,13 @@ void Vec3Property::Set(glm::vec3 value) {
     Y.UnblockSignals();
     Z.UnblockSignals();
 
-    if (allow_signals_) ValueChanged.Emit(value_);
+    NotifyChanged();
+}
+
+bool Vec3Property::UpdateFromChildren() {
+    value_ = glm::vec3(X.Get(), Y.Get(), Z.Get());
+    NotifyChanged();
+    return true;
 }
 
 void Vec3Property::OnChangedX(double x) {
@@ -26,6 +26,11 @@ public:
     glm::vec3 Get() const;
     void Set(glm::vec3 value);
 
+    virtual bool UpdateFromChildren() override;
+
+protected:
+    virtual void EmitChanged() override { ValueChanged.Emit(value_); }
+
 private:
     glm::vec3 value_;
     // For animation purposes:
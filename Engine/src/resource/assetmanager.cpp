@@ -20,13 +20,82 @@
 #include <resource/shaderfactory.h>
 #include <resource/shapes.h>
 #include <scene/components/transform.h>
+#include <algorithm>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QMutex>
+#include <QRunnable>
+#include <QTimer>
+#include <QWaitCondition>
 
 template<> AssetManager* Singleton<AssetManager>::_instance_ = nullptr;
 
+// A file decoded for LoadAssets, read by the main thread once done is set
+struct DecodedAsset {
+    Importers::ImageData image;
+    std::array<Importers::ImageData, 6> faces;
+    Importers::MeshData mesh;
+    std::string error;
+    bool done = false;
+};
+
+// Signals the main thread as each DecodedAsset of a batch is done
+struct DecodeBatch {
+    QMutex mutex;
+    QWaitCondition ready;
+};
+
+// Decodes one of LoadAssets' or PreloadAssets' files on a worker thread. Preloads can't be cancelled.
+class AssetDecoder : public QRunnable {
+public:
+    AssetDecoder(const AssetManager::AssetImport& import, DecodedAsset& result, DecodeBatch& batch, const std::atomic<bool>* cancelled) :
+        import_(import), result_(result), batch_(batch), cancelled_(cancelled) { }
+
+    void run() override {
+        if (cancelled_ == nullptr || !*cancelled_) {
+            try {
+                switch (import_.type) {
+                    case AssetType::Texture: result_.image = Importers::DecodeImage(import_.path, import_.compress); break;
+                    case AssetType::Cubemap: result_.faces = Importers::DecodeCubemap(import_.path); break;
+                    case AssetType::Mesh: result_.mesh = Importers::DecodeMesh(import_.path); break;
+                    default: result_.error = "Can't load \"" + import_.name + "\" from disk";
+                }
+            } catch (const std::exception& e) {
+                result_.error = e.what();
+            }
+        }
+        QMutexLocker lock(&batch_.mutex);
+        result_.done = true;
+        batch_.ready.wakeAll();
+    }
+
+private:
+    const AssetManager::AssetImport import_;
+    DecodedAsset& result_;
+    DecodeBatch& batch_;
+    const std::atomic<bool>* cancelled_;
+};
+
 AssetManager::AssetManager(ShaderFactory& shader_factory) :
     Singleton<AssetManager>(),
-    shader_factory_(&shader_factory)
+    shader_factory_(&shader_factory),
+    preload_batch_(std::make_unique<DecodeBatch>()),
+    reload_batch_(std::make_unique<DecodeBatch>()),
+    file_watcher_(std::make_unique<QFileSystemWatcher>()),
+    reload_timer_(std::make_unique<QTimer>()),
+    load_cancelled_(false)
 {
+    reload_timer_->setSingleShot(true);
+    reload_timer_->setInterval(RELOAD_DELAY_MS);
+    QObject::connect(file_watcher_.get(), &QFileSystemWatcher::fileChanged, [this](const QString& path) {
+        OnFileChanged(path.toStdString());
+    });
+    QObject::connect(reload_timer_.get(), &QTimer::timeout, [this]() {
+        std::set<std::string> changed;
+        changed.swap(changed_files_);
+        for (const std::string& path : changed) ReloadFile(path);
+    });
+
     // Setup default assets
     static const unsigned char texture_data[16] = {
         255, 0, 255, 255, 0, 0, 0, 255,
@@ -48,11 +117,14 @@ AssetManager::AssetManager(ShaderFactory& shader_factory) :
     // Create the Cube mesh
     auto cube_mesh = CreateMesh("Cube");
     cube_mesh->SetHidden(false);
-    cube_mesh->SetPositions(std::vector<float>(Cube::Vertices()));
-    cube_mesh->SetNormals(std::vector<float>(Cube::Normals()));
-    cube_mesh->SetColors(std::vector<float>(Cube::Colors()));
-    cube_mesh->SetUVs(std::vector<float>(Cube::UVs()));
-    cube_mesh->SetTriangles(std::vector<unsigned int>(Cube::Triangles()));
+    {
+        MeshEdit edit(*cube_mesh);
+        edit.SetPositions(Cube::Vertices());
+        edit.SetNormals(Cube::Normals());
+        edit.SetColors(Cube::Colors());
+        edit.SetUVs(Cube::UVs());
+        edit.SetTriangles(Cube::Triangles());
+    }
 
     auto cube2_mesh = CreateMesh("Hollow Cube");
     cube2_mesh->SetHidden(false);
@@ -62,18 +134,24 @@ AssetManager::AssetManager(ShaderFactory& shader_factory) :
     // Create the Pyramid mesh
     auto pyramid_mesh = CreateMesh("Pyramid");
     pyramid_mesh->SetHidden(false);
-    pyramid_mesh->SetPositions(std::vector<float>(Pyramid::Vertices()));
-    pyramid_mesh->SetNormals(std::vector<float>(Pyramid::Normals()));
-    pyramid_mesh->SetColors(std::vector<float>(Pyramid::Colors()));
-    pyramid_mesh->SetUVs(std::vector<float>(Pyramid::UVs()));
-    pyramid_mesh->SetTriangles(std::vector<unsigned int>(Pyramid::Triangles()));
+    {
+        MeshEdit edit(*pyramid_mesh);
+        edit.SetPositions(Pyramid::Vertices());
+        edit.SetNormals(Pyramid::Normals());
+        edit.SetColors(Pyramid::Colors());
+        edit.SetUVs(Pyramid::UVs());
+        edit.SetTriangles(Pyramid::Triangles());
+    }
 
     // Create the Banana Mesh
     auto banana_mesh = CreateMesh("Banana");
     banana_mesh->SetHidden(false);
-    banana_mesh->SetPositions(std::vector<float>(Banana::Vertices()));
-    banana_mesh->SetNormals(std::vector<float>(Banana::Normals()));
-    banana_mesh->SetTriangles(std::vector<unsigned int>(Banana::Triangles()));
+    {
+        MeshEdit edit(*banana_mesh);
+        edit.SetPositions(Banana::Vertices());
+        edit.SetNormals(Banana::Normals());
+        edit.SetTriangles(Banana::Triangles());
+    }
 
     // Create the Arrow mesh
     auto arrow_mesh = CreateMesh("Arrow");
@@ -87,13 +165,13 @@ AssetManager::AssetManager(ShaderFactory& shader_factory) :
     arrowhead_transform.Rotation.Set(glm::vec3(180.f, 0.f, 0.f));
     arrow_mesh->Append(*pyramid_mesh, arrowhead_transform.GetMatrix());
 
-    // Import standard meshes
-    LoadMesh("Teapot", "assets/teapot.obj", true);
-    LoadMesh("Spikey", "assets/spikey.obj", true);
-    LoadMesh("Bunny", "assets/bunny.obj", true);
+    // Standard meshes are imported when first used
+    RegisterAsset({AssetType::Mesh, "Teapot", "assets/teapot.obj", true});
+    RegisterAsset({AssetType::Mesh, "Spikey", "assets/spikey.obj", true});
+    RegisterAsset({AssetType::Mesh, "Bunny", "assets/bunny.obj", true});
     // These take a while to load
-    //LoadMesh("Dragon", "assets/dragon.ply", true);
-    //LoadMesh("Buddha", "assets/buddha.ply", true);
+    //RegisterAsset({AssetType::Mesh, "Dragon", "assets/dragon.ply", true});
+    //RegisterAsset({AssetType::Mesh, "Buddha", "assets/buddha.ply", true});
 
     // ------- Basic Materials -------
     // Flat textured shader and material
@@ -102,7 +180,8 @@ AssetManager::AssetManager(ShaderFactory& shader_factory) :
     tex_shader->FragmentShader.Set("assets/texture.frag");
     Material* textured_material = CreateMaterial("Textured Material", false);
     textured_material->Shader.Set(tex_shader);
-    LoadTexture("Checkers Texture", "assets/checkers.png");
+    // Built-in textures are small, and a checkerboard's hard edges are what block compression does worst
+    LoadTexture("Checkers Texture", "assets/checkers.png", false);
     auto texture = GetTexture("Checkers Texture");
     textured_material->Uniforms.Get<TextureProperty>("DiffuseMap")->Set(texture);
 
@@ -207,15 +286,16 @@ AssetManager::AssetManager(ShaderFactory& shader_factory) :
 }
 
 AssetManager::~AssetManager() {
+    // Preloads write into lazy_assets_, reloads into reloads_
+    load_pool_.waitForDone();
     AssetCreated.Clear();
     AssetDeleted.Clear();
+    LoadProgress.Clear();
 }
 
-void AssetManager::LoadTexture(const std::string& name, const std::string& path) {
+void AssetManager::LoadTexture(const std::string& name, const std::string& path, bool compress) {
     try {
-        if (textures_.count(name) > 0) UnloadTexture(name);
-        textures_.emplace(std::make_pair(name, Importers::ImportTexture(name, path)));
-        AssetCreated.Emit(*textures_[name]);
+        AddTexture(name, Importers::ImportTexture(name, path, compress));
     } catch (const FileIOException& e) {
         Debug::Log.WriteLine(e.what(), Priority::Error);
     }
@@ -223,9 +303,7 @@ void AssetManager::LoadTexture(const std::string& name, const std::string& path)
 
 void AssetManager::LoadCubemap(const std::string& name, const std::string& path) {
     try {
-        if (cubemaps_.count(name) > 0) UnloadCubemap(name);
-        cubemaps_.emplace(std::make_pair(name, Importers::ImportCubemap(name, path)));
-        AssetCreated.Emit(*cubemaps_[name]);
+        AddCubemap(name, Importers::ImportCubemap(name, path));
     } catch (const FileIOException& e) {
         Debug::Log.WriteLine(e.what(), Priority::Error);
     }
@@ -233,17 +311,156 @@ void AssetManager::LoadCubemap(const std::string& name, const std::string& path)
 
 void AssetManager::LoadMesh(const std::string& name, const std::string& path, bool internal) {
     try {
-        if (meshes_.count(name) > 0) UnloadMesh(name);
-        meshes_.emplace(std::make_pair(name, Importers::ImportMesh(name, path)));
-        if (internal) {
-            meshes_[name]->MakeInternal();
-        }
-        AssetCreated.Emit(*meshes_[name]);
+        AddMesh(name, Importers::ImportMesh(name, path), internal);
     } catch (const FileIOException& e) {
         Debug::Log.WriteLine(e.what(), Priority::Error);
     }
 }
 
+bool AssetManager::LoadAssets(const std::vector<AssetImport>& imports) {
+    load_cancelled_ = false;
+    std::vector<DecodedAsset> results(imports.size());
+    DecodeBatch batch;
+
+    // Keep a few files per thread decoding ahead of the one being published, so that
+    // the decoded data waiting to be published stays bounded
+    const size_t window = 2 * std::max(load_pool_.maxThreadCount(), 1);
+    size_t queued = 0;
+    size_t published = 0;
+    for (; published < imports.size() && !load_cancelled_; published++) {
+        while (queued < imports.size() && queued < published + window) {
+            load_pool_.start(new AssetDecoder(imports[queued], results[queued], batch, &load_cancelled_));
+            queued++;
+        }
+
+        DecodedAsset& result = results[published];
+        batch.mutex.lock();
+        while (!result.done) batch.ready.wait(&batch.mutex);
+        batch.mutex.unlock();
+        if (load_cancelled_) break;
+
+        PublishDecodedAsset(imports[published], result);
+        // The asset holds (or shares) the data now
+        result.image = Importers::ImageData();
+        result.faces = std::array<Importers::ImageData, 6>();
+        result.mesh = Importers::MeshData();
+        LoadProgress.Emit(published + 1, imports.size());
+    }
+
+    // Files still decoding write into results. Once cancelled, the ones not yet started finish straight away.
+    QMutexLocker lock(&batch.mutex);
+    for (size_t i = published; i < queued; i++) {
+        while (!results[i].done) batch.ready.wait(&batch.mutex);
+    }
+    // A cancel from the last progress callback still counts, even though everything was published
+    return published == imports.size() && !load_cancelled_;
+}
+
+void AssetManager::RegisterAsset(const AssetImport& import) {
+    if (IsLoaded(import.type, import.name)) return;
+    for (auto& asset : lazy_assets_) {
+        // Already registered, and possibly being preloaded
+        if (asset.import.type == import.type && asset.import.name == import.name) return;
+    }
+    lazy_assets_.push_back({import, nullptr});
+}
+
+void AssetManager::PreloadAssets() {
+    for (auto& asset : lazy_assets_) {
+        if (asset.decoded != nullptr) continue;
+        asset.decoded = std::make_unique<DecodedAsset>();
+        load_pool_.start(new AssetDecoder(asset.import, *asset.decoded, *preload_batch_, nullptr));
+    }
+}
+
+bool AssetManager::PublishPreloadedAssets() {
+    for (size_t i = 0; i < lazy_assets_.size(); ) {
+        LazyAsset& asset = lazy_assets_[i];
+        bool done = false;
+        if (asset.decoded != nullptr) {
+            QMutexLocker lock(&preload_batch_->mutex);
+            done = asset.decoded->done;
+        }
+        if (!done) {
+            i++;
+            continue;
+        }
+
+        LazyAsset loaded = std::move(asset);
+        lazy_assets_.erase(lazy_assets_.begin() + i);
+        if (!IsLoaded(loaded.import.type, loaded.import.name)) PublishDecodedAsset(loaded.import, *loaded.decoded);
+    }
+    return !lazy_assets_.empty();
+}
+
+bool AssetManager::IsLoaded(AssetType type, const std::string& name) const {
+    switch (type) {
+        case AssetType::Texture: return textures_.count(name) > 0;
+        case AssetType::Cubemap: return cubemaps_.count(name) > 0;
+        case AssetType::Mesh: return meshes_.count(name) > 0;
+        default: return false;
+    }
+}
+
+void AssetManager::LoadRegisteredAsset(AssetType type, const std::string& name) {
+    auto it = std::find_if(lazy_assets_.begin(), lazy_assets_.end(), [&](const LazyAsset& asset) {
+        return asset.import.type == type && asset.import.name == name;
+    });
+    if (it == lazy_assets_.end()) return;
+    LazyAsset asset = std::move(*it);
+    lazy_assets_.erase(it);
+
+    if (asset.decoded == nullptr) {
+        // Not preloaded, so import it here
+        const AssetImport& import = asset.import;
+        if (type == AssetType::Texture) LoadTexture(import.name, import.path, import.compress);
+        else if (type == AssetType::Cubemap) LoadCubemap(import.name, import.path);
+        else LoadMesh(import.name, import.path, import.internal);
+        return;
+    }
+
+    preload_batch_->mutex.lock();
+    while (!asset.decoded->done) preload_batch_->ready.wait(&preload_batch_->mutex);
+    preload_batch_->mutex.unlock();
+    PublishDecodedAsset(asset.import, *asset.decoded);
+}
+
+void AssetManager::PublishDecodedAsset(const AssetImport& import, DecodedAsset& decoded) {
+    if (!decoded.error.empty()) {
+        Debug::Log.WriteLine(decoded.error, Priority::Error);
+    } else if (import.type == AssetType::Texture) {
+        AddTexture(import.name, Importers::CreateTexture(import.name, import.path, decoded.image, import.compress));
+    } else if (import.type == AssetType::Cubemap) {
+        AddCubemap(import.name, Importers::CreateCubemap(import.name, import.path, decoded.faces));
+    } else {
+        AddMesh(import.name, Importers::CreateMesh(import.name, import.path, std::move(decoded.mesh)), import.internal);
+    }
+}
+
+void AssetManager::AddTexture(const std::string& name, std::unique_ptr<Texture> texture) {
+    if (textures_.count(name) > 0) UnloadTexture(name);
+    WatchFile(texture->ExternalPath.Get());
+    texture->CompressChanged.Connect(this, &AssetManager::OnTextureCompressChanged);
+    textures_.emplace(std::make_pair(name, std::move(texture)));
+    AssetCreated.Emit(*textures_[name]);
+}
+
+void AssetManager::AddCubemap(const std::string& name, std::unique_ptr<Cubemap> cubemap) {
+    if (cubemaps_.count(name) > 0) UnloadCubemap(name);
+    cubemaps_.emplace(std::make_pair(name, std::move(cubemap)));
+    AssetCreated.Emit(*cubemaps_[name]);
+}
+
+void AssetManager::AddMesh(const std::string& name, std::unique_ptr<Mesh> mesh, bool internal) {
+    if (meshes_.count(name) > 0) UnloadMesh(name);
+    WatchFile(mesh->ExternalPath.Get());
+    meshes_.emplace(std::make_pair(name, std::move(mesh)));
+    if (internal) {
+        meshes_[name]->MakeInternal();
+    }
+    AssetCreated.Emit(*meshes_[name]);
+}
+
 Mesh* AssetManager::CreateMesh(const std::string &name, MeshType meshtype, bool internal, bool hidden) {
     if (meshes_.count(name) > 0) return nullptr;
     meshes_[name] = std::make_unique<Mesh>(name, meshtype);
@@ -269,6 +486,10 @@ Material* AssetManager::CreateMaterial(const std::string &name, bool internal) {
 ShaderProgram* AssetManager::CreateShaderProgram(const std::string &name, bool internal) {
     if (shader_programs_.count(name) > 0) return nullptr;
     shader_programs_[name] = shader_factory_->CreateShaderProgram(name);
+    ShaderProgram& program = *shader_programs_[name];
+    program.VertexShader.ValueSet.Connect(this, &AssetManager::WatchFile);
+    program.FragmentShader.ValueSet.Connect(this, &AssetManager::WatchFile);
+    program.GeometryShader.ValueSet.Connect(this, &AssetManager::WatchFile);
     if (internal) {
         shader_programs_[name]->MakeInternal();
         shader_programs_[name]->SetHidden();
@@ -314,7 +535,8 @@ void AssetManager::UnloadShaderProgram(const std::string& name) {
 
 Texture* AssetManager::GetTexture(const std::string& name) {
     if (name == "Default Texture") return default_texture_.get();
-    else if (textures_.count(name) < 1) {
+    if (textures_.count(name) < 1) LoadRegisteredAsset(AssetType::Texture, name);
+    if (textures_.count(name) < 1) {
         Debug::Log.WriteLine("Texture not imported \"" + name + "\"", Priority::Error);
         return default_texture_.get();
     }
@@ -324,7 +546,8 @@ Texture* AssetManager::GetTexture(const std::string& name) {
 
 Cubemap* AssetManager::GetCubemap(const std::string& name) {
     if (name == "Default Cubemap") return default_cubemap_.get();
-    else if (cubemaps_.count(name) < 1) {
+    if (cubemaps_.count(name) < 1) LoadRegisteredAsset(AssetType::Cubemap, name);
+    if (cubemaps_.count(name) < 1) {
         Debug::Log.WriteLine("Cubemap not imported \"" + name + "\"", Priority::Error);
         return default_cubemap_.get();
     }
@@ -343,6 +566,7 @@ Material* AssetManager::GetMaterial(const std::string& name) {
 }
 
 Mesh* AssetManager::GetMesh(const std::string& name) {
+    if (meshes_.count(name) < 1) LoadRegisteredAsset(AssetType::Mesh, name);
     if (meshes_.count(name) < 1) {
         // Debug::Log.WriteLine("Mesh not imported \"" + name + "\"", Priority::Error);
         return meshes_["default"].get();
@@ -412,11 +636,93 @@ std::vector<ShaderProgram *> AssetManager::GetShaderPrograms() const {
 }
 
 void AssetManager::Refresh() {
-    // Reload shaders
-    for (auto & kv : shader_programs_) {
+    std::set<std::string> paths;
+    for (auto& kv : textures_) paths.insert(kv.second->ExternalPath.Get());
+    for (auto& kv : meshes_) paths.insert(kv.second->ExternalPath.Get());
+    for (auto& kv : shader_programs_) {
         ShaderProgram* prog = kv.second.get();
-        if (prog->VertexShader.IsSet()) prog->VertexShader.Set(prog->VertexShader.Get());
-        if (prog->FragmentShader.IsSet()) prog->FragmentShader.Set(prog->FragmentShader.Get());
-        if (prog->GeometryShader.IsSet()) prog->GeometryShader.Set(prog->GeometryShader.Get());
+        paths.insert(prog->VertexShader.Get());
+        paths.insert(prog->FragmentShader.Get());
+        paths.insert(prog->GeometryShader.Get());
     }
+    paths.erase("");
+    for (const std::string& path : paths) ReloadFile(path);
+}
+
+bool AssetManager::PublishReloadedAssets() {
+    bool changed = false;
+    for (size_t i = 0; i < reloads_.size(); ) {
+        {
+            QMutexLocker lock(&reload_batch_->mutex);
+            if (!reloads_[i].decoded->done) {
+                i++;
+                continue;
+            }
+        }
+        ReloadAsset reload = std::move(reloads_[i]);
+        reloads_.erase(reloads_.begin() + i);
+
+        // The asset may have been unloaded, or loaded from another file, while its file was decoding
+        const AssetImport& import = reload.import;
+        DecodedAsset& decoded = *reload.decoded;
+        if (!decoded.error.empty()) {
+            Debug::Log.WriteLine(decoded.error, Priority::Error);
+            continue;
+        } else if (import.type == AssetType::Texture) {
+            auto it = textures_.find(import.name);
+            if (it == textures_.end() || it->second->ExternalPath.Get() != import.path) continue;
+            // Compress was changed again since, and another reload is on its way
+            if (it->second->Compress.Get() != import.compress) continue;
+            Importers::ReloadTexture(*it->second, import.path, decoded.image);
+            changed = true;
+        } else {
+            auto it = meshes_.find(import.name);
+            if (it == meshes_.end() || it->second->ExternalPath.Get() != import.path) continue;
+            Importers::ReloadMesh(*it->second, import.path, std::move(decoded.mesh));
+            changed = true;
+        }
+        Debug::Log.WriteLine("Reloaded \"" + import.name + "\" from \"" + import.path + "\"", Priority::Status);
+    }
+    return changed;
+}
+
+void AssetManager::WatchFile(std::string path) {
+    if (path.empty() || !QFileInfo::exists(QString::fromStdString(path))) return;
+    file_watcher_->addPath(QString::fromStdString(path));
+}
+
+void AssetManager::OnFileChanged(const std::string& path) {
+    // Editors often save by replacing the file, which stops it being watched
+    WatchFile(path);
+    changed_files_.insert(path);
+    reload_timer_->start();
+}
+
+void AssetManager::ReloadFile(const std::string& path) {
+    // Shader sources are small, so shader programs just set the path again to recompile
+    for (auto& kv : shader_programs_) {
+        ShaderProgram* prog = kv.second.get();
+        if (prog->VertexShader.Get() == path) prog->VertexShader.Set(path);
+        if (prog->FragmentShader.Get() == path) prog->FragmentShader.Set(path);
+        if (prog->GeometryShader.Get() == path) prog->GeometryShader.Set(path);
+    }
+
+    std::vector<AssetImport> imports;
+    for (auto& kv : textures_) {
+        if (kv.second->ExternalPath.Get() == path) imports.push_back({AssetType::Texture, kv.first, path, false, kv.second->Compress.Get()});
+    }
+    for (auto& kv : meshes_) {
+        if (kv.second->ExternalPath.Get() == path) imports.push_back({AssetType::Mesh, kv.first, path});
+    }
+    for (const AssetImport& import : imports) QueueReload(import);
+}
+
+void AssetManager::QueueReload(const AssetImport& import) {
+    reloads_.push_back({import, std::make_unique<DecodedAsset>()});
+    load_pool_.start(new AssetDecoder(import, *reloads_.back().decoded, *reload_batch_, nullptr));
+}
+
+void AssetManager::OnTextureCompressChanged(Texture& texture) {
+    if (texture.ExternalPath.Get().empty()) return;
+    QueueReload({AssetType::Texture, texture.GetName(), texture.ExternalPath.Get(), false, texture.Compress.Get()});
 }
@@ -13,7 +13,12 @@
 #include <animator.h>
 
 #include <singleton.h>
+#include <QThreadPool>
+#include <atomic>
+#include <set>
 
+class QFileSystemWatcher;
+class QTimer;
 class ShaderFactory;
 class Asset;
 class Mesh;
@@ -21,6 +26,8 @@ class Material;
 class ShaderProgram;
 class Texture;
 class Cubemap;
+struct DecodedAsset;
+struct DecodeBatch;
 
 // AssetManager owns all the Scene's assets and caches them for reference via names.
 // Assets not created through the AssetManager will not be kept track of.
@@ -32,10 +39,35 @@ public:
 
     // Load from Disk. If failed, has no effect and writes a log message.
     // If the name already exists, replaces the pre-existing asset.
-    void LoadTexture(const std::string& name, const std::string& path);
+    void LoadTexture(const std::string& name, const std::string& path, bool compress=true);
     void LoadCubemap(const std::string& name, const std::string& path);
     void LoadMesh(const std::string& name, const std::string& path, bool internal=false);
 
+    // A texture, cubemap or mesh for LoadAssets to import
+    struct AssetImport {
+        AssetType type;
+        std::string name;
+        std::string path;
+        bool internal = false; // Only used for meshes
+        bool compress = true; // Only used for textures; see Texture::Compress
+    };
+
+    // Loads a batch of assets from disk, decoding the files in parallel. Each asset is created and published
+    // on the calling thread in the order given, with the same effect as the Load function for its type.
+    // LoadProgress is emitted after each one; calling CancelLoad (from a LoadProgress handler or another thread)
+    // stops the batch, leaving the assets published so far. Returns false if the batch was cancelled.
+    bool LoadAssets(const std::vector<AssetImport>& imports);
+    void CancelLoad() { load_cancelled_ = true; }
+
+    // Registers an asset to be loaded from disk when it is first requested through GetTexture, GetCubemap or GetMesh,
+    // or once preloaded, whichever comes first. Nothing is read until then. Does nothing once the asset is loaded.
+    void RegisterAsset(const AssetImport& import);
+    // Starts decoding every registered asset on worker threads, without waiting for them
+    void PreloadAssets();
+    // Publishes the preloaded assets that have finished decoding, without waiting for the rest.
+    // Call from the main thread, e.g. when idle. Returns true while registered assets remain unloaded.
+    bool PublishPreloadedAssets();
+
     // Creates an asset in-memory. If the name already exists, returns a nullptr.
     // Internal indicates this asset is not to be serialized (as it is created in the code).
     Mesh* CreateMesh(const std::string& name, MeshType meshtype = MeshType::Triangles, bool internal = true, bool hidden = true); // Returns an empty Mesh
@@ -58,11 +90,20 @@ public:
 
     Texture* GetOrCreateSolidTexture(glm::vec3 color);
 
+    // The files of loaded textures, meshes and shader programs are watched, and when one changes only the assets
+    // made from it are reloaded, in place, so everything referencing them stays valid. Shader programs recompile
+    // right away; textures and meshes are decoded again on worker threads and updated by PublishReloadedAssets.
+    // Either way the asset's version goes up, so only its GL copies (and other caches keyed by version) are rebuilt.
     void Refresh();  // Reloads all assets from disk
+    // Updates the assets whose files finished decoding since the last call. Call from the main thread, e.g. on a
+    // timer, but not while a RayTracer is tracing the scene; until then the reloads stay queued.
+    // Returns true if any asset changed, so views showing it should redraw.
+    bool PublishReloadedAssets();
 
     // Signals
     Signal1<Asset&> AssetCreated;
     Signal1<uint64_t> AssetDeleted;
+    Signal2<size_t, size_t> LoadProgress; // Assets loaded and total in the batch
 
     // Used for serialization and UI
     std::vector<Texture*> GetTextures() const;
@@ -295,6 +336,47 @@ protected:
     std::map<std::string, std::unique_ptr<ShaderProgram>> shader_programs_;
 
     std::map<unsigned int, std::unique_ptr<Texture>> solid_textures_;
+
+    // Registered assets that aren't loaded yet. decoded is set once PreloadAssets queues the file.
+    struct LazyAsset {
+        AssetImport import;
+        std::unique_ptr<DecodedAsset> decoded;
+    };
+    std::vector<LazyAsset> lazy_assets_;
+    std::unique_ptr<DecodeBatch> preload_batch_;
+    bool IsLoaded(AssetType type, const std::string& name) const;
+    // Loads the registered asset with the name now, if there is one, waiting for it if it is being preloaded
+    void LoadRegisteredAsset(AssetType type, const std::string& name);
+    // Creates the asset from its decoded file, which it may take the data of, or logs why it couldn't be decoded
+    void PublishDecodedAsset(const AssetImport& import, DecodedAsset& decoded);
+
+    // Files being decoded again since they changed on disk
+    struct ReloadAsset {
+        AssetImport import;
+        std::unique_ptr<DecodedAsset> decoded;
+    };
+    std::vector<ReloadAsset> reloads_;
+    std::unique_ptr<DecodeBatch> reload_batch_;
+    // Changed files wait for the timer, so a file being written in several steps is only read once it's done
+    std::unique_ptr<QFileSystemWatcher> file_watcher_;
+    std::unique_ptr<QTimer> reload_timer_;
+    std::set<std::string> changed_files_;
+    static const int RELOAD_DELAY_MS = 100;
+    void WatchFile(std::string path);
+    void OnFileChanged(const std::string& path);
+    // Reloads the assets made from the file
+    void ReloadFile(const std::string& path);
+    // Decodes the asset's file again on a worker thread, to be published by PublishReloadedAssets
+    void QueueReload(const AssetImport& import);
+    // Compressing or not changes how the file is decoded, so the texture is read again
+    void OnTextureCompressChanged(Texture& texture);
+
+    // Worker threads that decode LoadAssets', PreloadAssets' and reloaded files
+    QThreadPool load_pool_;
+    std::atomic<bool> load_cancelled_;
+    void AddTexture(const std::string& name, std::unique_ptr<Texture> texture);
+    void AddCubemap(const std::string& name, std::unique_ptr<Cubemap> cubemap);
+    void AddMesh(const std::string& name, std::unique_ptr<Mesh> mesh, bool internal);
 };
 
 #endif // ASSETMANAGER_H
@@ -8,41 +8,29 @@
  * should contact the author.
  ****************************************************************************/
 #include "cubemap.h"
+#include <cstring>
 
 const int Cubemap::NUM_CUBEMAP_FACES = 6;
 
-Cubemap::Cubemap(const std::string& name, unsigned int resolution, const unsigned char* faces[NUM_CUBEMAP_FACES]) :
+Cubemap::Cubemap(const std::string& name, unsigned int resolution, std::array<std::shared_ptr<unsigned char>, 6> faces) :
     Asset(name),
     ExternalPath(FileType::Image),
-    resolution_(resolution)
+    resolution_(resolution),
+    image_(std::move(faces))
 {
     AddProperty("Path", &ExternalPath);
     ExternalPath.SetHidden(true);
-
-    // Store a copy of each face
-    const unsigned int CHANNELS = 4; // RGBA
-    unsigned int bytes_w = resolution_ * CHANNELS;
-    for (int i = 0; i < NUM_CUBEMAP_FACES; i++) {
-        if (resolution > 0 && faces != nullptr) {
-            image_[i] = new unsigned char[bytes_w * bytes_w];
-            for (unsigned int y = 0; y < resolution_; y++) {
-                for (unsigned int x = 0; x < resolution_; x++) {
-                    unsigned int j = x * CHANNELS;
-                    // Copy over a pixel
-                    for (unsigned int ch = 0; ch < CHANNELS; ch++) {
-                        int idx = y * bytes_w + j + ch;
-                        image_[i][idx] = faces[i][idx];
-                    }
-                }
-            }
-        } else {
-            image_[i] = nullptr;
-        }
-    }
 }
 
-Cubemap::~Cubemap() {
+Cubemap::Cubemap(const std::string& name, unsigned int resolution, const unsigned char* faces[NUM_CUBEMAP_FACES]) :
+    Cubemap(name, resolution, std::array<std::shared_ptr<unsigned char>, 6>())
+{
+    // Store a copy of each face
+    if (resolution == 0 || faces == nullptr) return;
+    const size_t CHANNELS = 4; // RGBA
+    size_t bytes = (size_t) resolution * resolution * CHANNELS;
     for (int i = 0; i < NUM_CUBEMAP_FACES; i++) {
-        if (image_[i]) delete [] image_[i];
+        image_[i] = std::shared_ptr<unsigned char>(new unsigned char[bytes], std::default_delete<unsigned char[]>());
+        memcpy(image_[i].get(), faces[i], bytes);
     }
 }
@@ -13,6 +13,8 @@
 #include <animator.h>
 #include <resource/asset.h>
 #include <resource/cacheable.h>
+#include <array>
+#include <memory>
 
 class Cubemap: public Asset, public Cacheable {
 public:
@@ -20,22 +22,25 @@ public:
 
     FileProperty ExternalPath;
 
+    // Creates a cubemap from a copy of each face's bytes
     Cubemap(const std::string& name, unsigned int resolution, const unsigned char** faces);
-    virtual ~Cubemap();
+    // Creates a cubemap from RGBA faces without copying them, freed by their deleters once nothing else holds them
+    Cubemap(const std::string& name, unsigned int resolution, std::array<std::shared_ptr<unsigned char>, 6> faces);
+    virtual ~Cubemap() {}
 
     virtual AssetType GetType() const override { return AssetType::Cubemap; }
     unsigned int GetResolution() const { return resolution_; }
-    const unsigned char* GetFace(int face) const { return image_[face]; }
+    const unsigned char* GetFace(int face) const { return image_[face].get(); }
 
 protected:
     unsigned int resolution_;
-    unsigned char* image_[6];
+    std::array<std::shared_ptr<unsigned char>, 6> image_;
 };
 
 class RenderableCubemap: public Cubemap {
 public:
     RenderableCubemap(const std::string& name, unsigned int resolution)
-        : Cubemap(name, resolution, nullptr) {}
+        : Cubemap(name, resolution, std::array<std::shared_ptr<unsigned char>, 6>()) {}
     virtual ~RenderableCubemap() {}
 
     virtual AssetType GetType() const override { return AssetType::RenderableCubemap; }
@@ -11,71 +11,121 @@
 #include <resource/cubemap.h>
 #include <resource/texture.h>
 #include <resource/importers.h>
+#include <resource/meshcache.h>
+#include <resource/texturecache.h>
 #include <SOIL.h>
 #include <assimp/cimport.h>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
+#include <cstdio>
+
+// Block compression settings. Part of the texture cache key, so changing the encoder invalidates the cache.
+static const std::string TEXTURE_COMPRESSION_SETTINGS = "bc1/bc3 1";
+
+// Uses SOIL to load the image found at path as RGBA, unless its compressed copy is already in the texture cache
+Importers::ImageData Importers::DecodeImage(const std::string& path, bool compress) {
+    ImageData decoded;
+    if (compress) {
+        decoded.cache_key = TextureCache::GetKey(path, TEXTURE_COMPRESSION_SETTINGS);
+        if (TextureCache::Load(decoded.cache_key, decoded)) {
+            decoded.cached = true;
+            return decoded;
+        }
+    }
 
-// Uses SOIL to load the image found at path and returns its width and height.
-std::unique_ptr<Texture> Importers::ImportTexture(const std::string& name, const std::string& path) {
-    int width, height, channels;
-    unsigned char* image = SOIL_load_image(path.c_str(), &width, &height, &channels, SOIL_LOAD_RGBA);
+    int channels;
+    unsigned char* image = SOIL_load_image(path.c_str(), &decoded.width, &decoded.height, &channels, SOIL_LOAD_RGBA);
 
     // Make sure SOIL was able to load the image
     if (image == nullptr) {
         throw FileIOException("Failed to import image \"" + path + "\": " + strerror(errno));
     }
 
-    // Create the texture object
-    std::unique_ptr<Texture> tex = std::make_unique<Texture>(name, width, height, image);
-    tex->Get<FileProperty>("Path")->Set(path);
-
-    // Free the image buffer
-    SOIL_free_image_data(image);
-
-    return std::move(tex);
+    decoded.pixels = std::shared_ptr<unsigned char>(image, SOIL_free_image_data);
+
+    // Images smaller than a block stay uncompressed; they take next to no memory anyway
+    if (compress && decoded.width >= 4 && decoded.height >= 4) {
+        decoded.format = TextureCompression::ChooseFormat(image, decoded.width, decoded.height);
+        auto levels = std::make_shared<std::vector<TextureLevel>>(
+            TextureCompression::CompressMipChain(image, decoded.width, decoded.height, decoded.format));
+        decoded.psnr = TextureCompression::PSNR(image, TextureCompression::Decompress(decoded.format, levels->front()).data(),
+                                                decoded.width, decoded.height, decoded.format);
+        decoded.levels = std::move(levels);
+        decoded.pixels.reset();
+    }
+    return decoded;
 }
 
-std::unique_ptr<Cubemap> Importers::ImportCubemap(const std::string& name, const std::string& path) {
-    static std::string suffixes[] = { "ft","bk","up","dn","rt","lf" };
+std::array<Importers::ImageData, 6> Importers::DecodeCubemap(const std::string& path) {
+    static const std::string suffixes[] = { "ft","bk","up","dn","rt","lf" };
     auto base_filename_length = path.rfind(".");
     std::string extension = path.substr(base_filename_length);
     std::string base_filename = path.substr(0, base_filename_length-2);
 
-    int resolution = 0;
-
-
-    unsigned char** images = new unsigned char*[Cubemap::NUM_CUBEMAP_FACES];
-
-    for (int i = 0; i < Cubemap::NUM_CUBEMAP_FACES; i++) {
-        std::string filepath = base_filename + suffixes[i] + extension;
-
-        int width, height, channels;
-        unsigned char* image = SOIL_load_image(filepath.c_str(), &width, &height, &channels, SOIL_LOAD_RGBA);
+    std::array<ImageData, 6> faces;
+    for (size_t i = 0; i < faces.size(); i++) {
+        faces[i] = DecodeImage(base_filename + suffixes[i] + extension);
+        assert(faces[i].width == faces[i].height);
+        assert(faces[i].width == faces[0].width);
+    }
+    return faces;
+}
 
-        // Make sure SOIL was able to load the image
-        if (image == nullptr) {
-            throw FileIOException("Failed to import image \"" + path + "\": " + strerror(errno));
-        }
+// Reports how well a freshly compressed image compressed and adds it to the texture cache
+static void StoreCompressedImage(const std::string& name, const std::string& path, const Importers::ImageData& image) {
+    if (!image.levels || image.cached) return;
+    size_t compressed_bytes = 0;
+    for (const TextureLevel& level : *image.levels) compressed_bytes += level.blocks.size();
+    size_t original_bytes = (size_t) image.width * image.height * 4;
+    char summary[128];
+    snprintf(summary, sizeof(summary), ": %.2f MB -> %.2f MB with mipmaps, PSNR %.1f dB",
+             original_bytes / 1048576.0, compressed_bytes / 1048576.0, image.psnr);
+    Debug::Log.WriteLine("Compressed \"" + name + "\" as " + (image.format == TextureFormat::BC1 ? "BC1" : "BC3") + summary, Priority::Status);
+    if (!image.cache_key.empty() && !TextureCache::Store(image.cache_key, image)) {
+        Debug::Log.WriteLine("Could not cache texture \"" + path + "\" in " + TextureCache::GetDirectory(), Priority::Warning);
+    }
+}
 
-        assert(width == height);
-        if (resolution) assert(resolution == width);
-        else resolution = width;
+std::unique_ptr<Texture> Importers::CreateTexture(const std::string& name, const std::string& path, const ImageData& image, bool compress) {
+    std::unique_ptr<Texture> tex;
+    if (image.levels) {
+        tex = std::make_unique<Texture>(name, image.format, image.levels);
+    } else {
+        tex = std::make_unique<Texture>(name, image.width, image.height, image.pixels);
+    }
+    tex->Get<FileProperty>("Path")->Set(path);
+    // Quietly, since nothing needs to read the file again
+    tex->Compress.BlockSignals();
+    tex->Compress.Set(compress);
+    tex->Compress.UnblockSignals();
+    StoreCompressedImage(name, path, image);
+    return tex;
+}
 
-        images[i] = image;
+void Importers::ReloadTexture(Texture& texture, const std::string& path, const ImageData& image) {
+    if (image.levels) {
+        texture.SetLevels(image.format, image.levels);
+    } else {
+        texture.SetImage(image.width, image.height, image.pixels);
     }
+    StoreCompressedImage(texture.GetName(), path, image);
+}
+
+std::unique_ptr<Cubemap> Importers::CreateCubemap(const std::string& name, const std::string& path, const std::array<ImageData, 6>& faces) {
+    std::array<std::shared_ptr<unsigned char>, 6> images;
+    for (size_t i = 0; i < faces.size(); i++) images[i] = faces[i].pixels;
 
-    // Create the cubemap object
-    std::unique_ptr<Cubemap> cubemap = std::make_unique<Cubemap>(name, resolution, (const unsigned char**) images);
+    std::unique_ptr<Cubemap> cubemap = std::make_unique<Cubemap>(name, faces[0].width, images);
     cubemap->Get<FileProperty>("Path")->Set(path);
+    return cubemap;
+}
 
-    // Free memory
-    for (int i = 0; i < Cubemap::NUM_CUBEMAP_FACES; i++) {
-        SOIL_free_image_data(images[i]);
-    }
-    delete [] images;
+std::unique_ptr<Texture> Importers::ImportTexture(const std::string& name, const std::string& path, bool compress) {
+    return CreateTexture(name, path, DecodeImage(path, compress), compress);
+}
 
-    return std::move(cubemap);
+std::unique_ptr<Cubemap> Importers::ImportCubemap(const std::string& name, const std::string& path) {
+    return CreateCubemap(name, path, DecodeCubemap(path));
 }
 
 void assimp2vector(const aiVector3D* a, unsigned int count, std::vector<float>& v, int dim=3) {
@@ -94,13 +144,24 @@ void assimp2vector(const aiColor4D* a, unsigned int count, std::vector<float>& v
     }
 }
 
-// Uses assimp to load the mesh found at path
-std::unique_ptr<Mesh> Importers::ImportMesh(const std::string& name, const std::string& path) {
-    const struct aiScene* scene = aiImportFile(path.c_str(), aiProcessPreset_TargetRealtime_MaxQuality);
+// Postprocessing assimp does on imported meshes. Part of the mesh cache key, so changing it invalidates the cache.
+static const unsigned int MESH_IMPORT_FLAGS = aiProcessPreset_TargetRealtime_MaxQuality;
+
+// Uses assimp to load the mesh found at path, unless it is already in the mesh cache
+Importers::MeshData Importers::DecodeMesh(const std::string& path) {
+    MeshData data;
+    data.cache_key = MeshCache::GetKey(path, "assimp " + std::to_string(MESH_IMPORT_FLAGS));
+    if (MeshCache::Load(data.cache_key, data)) {
+        data.cached = true;
+        return data;
+    }
+
+    const struct aiScene* scene = aiImportFile(path.c_str(), MESH_IMPORT_FLAGS);
     if (scene == nullptr) {
         throw FileIOException("Failed to import mesh \"" + path + "\"");
     }
     if (scene->mNumMeshes == 0) {
+        aiReleaseImport(scene);
         throw FileIOException("Invalid mesh \"" + path + "\"");
     }
 
@@ -113,36 +174,60 @@ std::unique_ptr<Mesh> Importers::ImportMesh(const std::string& name, const std::
         }
     }
     if (aimesh == nullptr) {
+        aiReleaseImport(scene);
         throw FileIOException("Mesh with non-triangular faces \"" + path + "\"");
     }
-    if (aimesh->HasPositions() && aimesh->HasFaces()) {
-        std::unique_ptr<Mesh> mesh = std::make_unique<Mesh>(name);
-        mesh->Get<FileProperty>("Path")->Set(path);
-        std::vector<unsigned int> triangles;
-        std::vector<float> positions, colors, uvs, normals;
-        assimp2vector(aimesh->mVertices, aimesh->mNumVertices, positions);
-        for (unsigned int i = 0; i < aimesh->mNumFaces; i++) {
-            for (int j = 0; j < 3; j++) {
-                triangles.push_back(aimesh->mFaces[i].mIndices[j]);
-            }
-        }
-        mesh->SetPositions(positions);
-        mesh->SetTriangles(triangles);
-        if (aimesh->HasVertexColors(0)) {
-            assimp2vector(aimesh->mColors[0], aimesh->mNumVertices, colors);
-            mesh->SetColors(colors);
-        }
-        if (aimesh->HasTextureCoords(0)) {
-            assimp2vector(aimesh->mTextureCoords[0], aimesh->mNumVertices, uvs, 2);
-            mesh->SetUVs(uvs);
-        }
-        if (aimesh->HasNormals()) {
-            assimp2vector(aimesh->mNormals, aimesh->mNumVertices, normals);
-            mesh->SetNormals(normals);
-        }
+    if (!aimesh->HasPositions() || !aimesh->HasFaces()) {
         aiReleaseImport(scene);
-        return std::move(mesh);
-    } else {
         throw FileIOException("Invalid mesh \"" + path + "\"");
     }
+
+    assimp2vector(aimesh->mVertices, aimesh->mNumVertices, data.positions);
+    data.triangles.reserve(aimesh->mNumFaces * 3);
+    for (unsigned int i = 0; i < aimesh->mNumFaces; i++) {
+        for (int j = 0; j < 3; j++) {
+            data.triangles.push_back(aimesh->mFaces[i].mIndices[j]);
+        }
+    }
+    if (aimesh->HasVertexColors(0)) {
+        assimp2vector(aimesh->mColors[0], aimesh->mNumVertices, data.colors);
+    }
+    if (aimesh->HasTextureCoords(0)) {
+        assimp2vector(aimesh->mTextureCoords[0], aimesh->mNumVertices, data.uvs, 2);
+    }
+    if (aimesh->HasNormals()) {
+        assimp2vector(aimesh->mNormals, aimesh->mNumVertices, data.normals);
+    }
+    aiReleaseImport(scene);
+    return data;
+}
+
+std::unique_ptr<Mesh> Importers::CreateMesh(const std::string& name, const std::string& path, MeshData&& data) {
+    std::unique_ptr<Mesh> mesh = std::make_unique<Mesh>(name);
+    mesh->Get<FileProperty>("Path")->Set(path);
+    ReloadMesh(*mesh, path, std::move(data));
+    return mesh;
+}
+
+void Importers::ReloadMesh(Mesh& mesh, const std::string& path, MeshData&& data) {
+    {
+        MeshEdit edit(mesh);
+        edit.SetPositions(std::move(data.positions));
+        edit.SetTriangles(std::move(data.triangles));
+        edit.SetColors(std::move(data.colors));
+        edit.SetUVs(std::move(data.uvs));
+        edit.SetNormals(std::move(data.normals));
+        // Cached meshes come with their tangents
+        if (data.cached) {
+            edit.SetBinormals(std::move(data.binormals));
+            edit.SetTangents(std::move(data.tangents));
+        }
+    }
+    if (!data.cached && !data.cache_key.empty() && !MeshCache::Store(data.cache_key, mesh)) {
+        Debug::Log.WriteLine("Could not cache mesh \"" + path + "\" in " + MeshCache::GetDirectory(), Priority::Warning);
+    }
+}
+
+std::unique_ptr<Mesh> Importers::ImportMesh(const std::string& name, const std::string& path) {
+    return CreateMesh(name, path, DecodeMesh(path));
 }
@@ -13,11 +13,62 @@
 #include <animator.h>
 #include <resource/texture.h>
 #include <resource/mesh.h>
+#include <resource/cubemap.h>
 
 // Handles loading of disk-stored external resources.
+// Decoding is split from creating the asset: the Decode functions only touch their own buffers, so they can
+// run on worker threads, while assets must be created on the main thread.
 class Importers {
 public:
-    // ImportTexture into memory as an unsigned char array (32 bit color depth).
+    // Pixels of a decoded image, RGBA with 8 bits per channel. They stay in the decoder's buffer,
+    // which the texture made from them shares rather than copies.
+    // Compressed images have a block compressed mip chain, shared the same way, instead of pixels.
+    struct ImageData {
+        int width = 0;
+        int height = 0;
+        std::shared_ptr<unsigned char> pixels;
+        TextureFormat format = TextureFormat::RGBA8;
+        std::shared_ptr<const std::vector<TextureLevel>> levels;
+        // How close the compressed image is to the original
+        double psnr = 0.0;
+        // The TextureCache entry for the file, and whether the data was read from it
+        std::string cache_key;
+        bool cached = false;
+    };
+
+    // Vertex attributes and triangles of a decoded mesh. Attributes the file doesn't have are left empty.
+    // Binormals and tangents are only filled when the mesh comes from the MeshCache.
+    struct MeshData {
+        std::vector<float> positions;
+        std::vector<float> normals;
+        std::vector<float> colors;
+        std::vector<float> uvs;
+        std::vector<float> binormals;
+        std::vector<float> tangents;
+        std::vector<unsigned int> triangles;
+        // The MeshCache entry for the file, and whether the data was read from it
+        std::string cache_key;
+        bool cached = false;
+    };
+
+    // Throw an exception if the file couldn't be decoded
+    // Compressing picks BC1 or BC3 for the image and reuses the TextureCache's copy when there is one
+    static ImageData DecodeImage(const std::string& path, bool compress = false);
+    static std::array<ImageData, 6> DecodeCubemap(const std::string& path);
+    static MeshData DecodeMesh(const std::string& path);
+
+    // Create the asset from decoded data. Textures and cubemaps share the decoded pixels; the mesh takes over data's arrays.
+    // Newly compressed textures and meshes are written to their cache here.
+    // Compress is the texture's setting, and should match how the image was decoded.
+    static std::unique_ptr<Texture> CreateTexture(const std::string& name, const std::string& path, const ImageData& image, bool compress);
+    static std::unique_ptr<Cubemap> CreateCubemap(const std::string& name, const std::string& path, const std::array<ImageData, 6>& faces);
+    static std::unique_ptr<Mesh> CreateMesh(const std::string& name, const std::string& path, MeshData&& data);
+    // Replace an existing asset's data with data decoded from its file again, keeping the asset itself
+    static void ReloadTexture(Texture& texture, const std::string& path, const ImageData& image);
+    static void ReloadMesh(Mesh& mesh, const std::string& path, MeshData&& data);
+
+    // ImportTexture into memory as an unsigned char array (32 bit color depth), block compressed if compress is set
+    // and it isn't smaller than a block.
     // I believe the reason 8 bits per color channel is used is most monitors operate with 32 bit color depth anyway,
     // and any HDR or higher bit depth images would need to be downsampled.
     // Readable Image Formats:
@@ -29,7 +80,7 @@ public:
     //    PSD - (from stb_image documentation)
     //    HDR - converted to LDR, unless loaded with *HDR* functions (RGBE or RGBdivA or RGBdivA2)
     // Throws an exception if the texture was unable to be imported.
-    static std::unique_ptr<Texture> ImportTexture(const std::string& name, const std::string& path);
+    static std::unique_ptr<Texture> ImportTexture(const std::string& name, const std::string& path, bool compress = true);
 
     // Import Cubemap into memory as an array of 6 unsigned char arrays (32 bit color depth)
     // Cubemaps as downloaded from e.g. http://www.custommapmakers.org/skyboxes.php are
@@ -16,6 +16,18 @@
 #include <resource/shaderprogram.h>
 #include <resource/asset.h>
 
+// The inputs a tracer reads from a Material. Each tracer takes its own copy when it is built,
+// so later edits and animation never change a frame that is still tracing.
+struct TraceMaterial {
+    //Solid colors are sampled directly, without going through a texture
+    TraceColor Emissive;
+    TraceColor Specular;
+    TraceColor Diffuse;
+    TraceColor Transmittence;
+    double Shininess = 0.0;
+    double IndexOfRefraction = 0.0;
+};
+
 // Material defines how some piece of geometry is rendered, and inputs the Shaders require.
 // See: https://docs.unity3d.com/Manual/class-Material.html
 class Material : public Asset {
@@ -44,30 +56,23 @@ public:
     }
 
     // Returns false if this material can't trace
-    // If you change trace inputs, make sure they are added in Material::OnShaderSet in the cpp
-    bool PrepareToTrace() {
-        if (!(Shader.Get()->TraceCompatible.Get())) {
-            return false;
-        }
+    bool IsTraceCompatible() const {
+        return Shader.Get()->TraceCompatible.Get();
+    }
 
+    // Copies the current trace inputs. Only call this if the material is trace compatible.
+    // If you change trace inputs, make sure they are added in Material::OnShaderSet in the cpp
+    TraceMaterial GetTraceMaterial() const {
         //If there is a nullptr crash here, the material isn't getting the trace properties
-        Emissive = dynamic_cast<TextureProperty*>(Uniforms.GetProperty("Emissive"))->Get();
-        Specular = dynamic_cast<TextureProperty*>(Uniforms.GetProperty("Specular"))->Get();
-        Diffuse = dynamic_cast<TextureProperty*>(Uniforms.GetProperty("Diffuse"))->Get();
-        Transmittence = dynamic_cast<TextureProperty*>(Uniforms.GetProperty("Transmittence"))->Get();
-        Shininess = dynamic_cast<DoubleProperty*>(Uniforms.GetProperty("Shininess"))->Get();
-        IndexOfRefraction = dynamic_cast<DoubleProperty*>(Uniforms.GetProperty("IndexOfRefraction"))->Get();
-
-        return true;
+        TraceMaterial trace;
+        trace.Emissive = dynamic_cast<TextureProperty*>(Uniforms.GetProperty("Emissive"))->GetTraceColor();
+        trace.Specular = dynamic_cast<TextureProperty*>(Uniforms.GetProperty("Specular"))->GetTraceColor();
+        trace.Diffuse = dynamic_cast<TextureProperty*>(Uniforms.GetProperty("Diffuse"))->GetTraceColor();
+        trace.Transmittence = dynamic_cast<TextureProperty*>(Uniforms.GetProperty("Transmittence"))->GetTraceColor();
+        trace.Shininess = dynamic_cast<DoubleProperty*>(Uniforms.GetProperty("Shininess"))->Get();
+        trace.IndexOfRefraction = dynamic_cast<DoubleProperty*>(Uniforms.GetProperty("IndexOfRefraction"))->Get();
+        return trace;
     }
-
-    //These are for caching the things we will use for trace
-    Texture* Emissive;
-    Texture* Specular;
-    Texture* Diffuse;
-    Texture* Transmittence;
-    double Shininess;
-    double IndexOfRefraction;
 };
 
 #endif // MATERIAL_H
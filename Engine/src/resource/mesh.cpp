@@ -9,6 +9,8 @@
  ****************************************************************************/
 #include "mesh.h"
 #include <algorithm>
+#include <parallelfor.h>
+#include <meshadjacency.h>
 
 Mesh::Mesh(const std::string& name, MeshType type) :
     Asset(name),
@@ -20,42 +22,59 @@ Mesh::Mesh(const std::string& name, MeshType type) :
 }
 
 void Mesh::SetPositions(const std::vector<float>& positions) {
-    positions_ = std::vector<float>(positions);
-    CalculateBinormalsAndTangents();
-    MarkDirty();
+    SetPositions(std::vector<float>(positions));
+}
+
+void Mesh::SetPositions(std::vector<float>&& positions) {
+    MeshEdit(*this).SetPositions(std::move(positions));
 }
 
 void Mesh::SetUVs(const std::vector<float>& UVs) {
-    UVs_ = std::vector<float>(UVs);
-    CalculateBinormalsAndTangents();
-    MarkDirty();
+    SetUVs(std::vector<float>(UVs));
+}
+
+void Mesh::SetUVs(std::vector<float>&& UVs) {
+    MeshEdit(*this).SetUVs(std::move(UVs));
 }
 
 void Mesh::SetColors(const std::vector<float>& colors) {
-    colors_ = std::vector<float>(colors);
-    MarkDirty();
+    SetColors(std::vector<float>(colors));
+}
+
+void Mesh::SetColors(std::vector<float>&& colors) {
+    MeshEdit(*this).SetColors(std::move(colors));
 }
 
 void Mesh::SetNormals(const std::vector<float>& normals) {
-    normals_ = std::vector<float>(normals);
-    CalculateBinormalsAndTangents();
-    MarkDirty();
+    SetNormals(std::vector<float>(normals));
+}
+
+void Mesh::SetNormals(std::vector<float>&& normals) {
+    MeshEdit(*this).SetNormals(std::move(normals));
 }
 
 void Mesh::SetBinormals(const std::vector<float>& binormals) {
-    binormals_ = std::vector<float>(binormals);
-    MarkDirty();
+    SetBinormals(std::vector<float>(binormals));
+}
+
+void Mesh::SetBinormals(std::vector<float>&& binormals) {
+    MeshEdit(*this).SetBinormals(std::move(binormals));
 }
 
 void Mesh::SetTangents(const std::vector<float>& tangents) {
-    tangents_ = std::vector<float>(tangents);
-    MarkDirty();
+    SetTangents(std::vector<float>(tangents));
+}
+
+void Mesh::SetTangents(std::vector<float>&& tangents) {
+    MeshEdit(*this).SetTangents(std::move(tangents));
 }
 
 void Mesh::SetTriangles(const std::vector<unsigned int>& triangles) {
-    triangles_ = std::vector<unsigned int>(triangles);
-    CalculateBinormalsAndTangents();
-    MarkDirty();
+    SetTriangles(std::vector<unsigned int>(triangles));
+}
+
+void Mesh::SetTriangles(std::vector<unsigned int>&& triangles) {
+    MeshEdit(*this).SetTriangles(std::move(triangles));
 }
 
 void Mesh::Append(Mesh& other, glm::mat4 transform) {
@@ -127,6 +146,7 @@ void Mesh::Append(Mesh& other, glm::mat4 transform) {
     std::vector<unsigned int> remapped_tris(other.triangles_.size());
     std::transform(other.triangles_.begin(), other.triangles_.end(), remapped_tris.begin(), [sz1](unsigned int x) { return x + sz1; });
     triangles_.insert(triangles_.end(), remapped_tris.begin(), remapped_tris.end());
+    SetAdjacency(nullptr);
     MarkDirty();
 }
 
@@ -169,63 +189,91 @@ const std::vector<unsigned int>& Mesh::GetTriangles() const {
     return triangles_;
 }
 
+std::shared_ptr<const MeshAdjacency> Mesh::GetAdjacency() const {
+    std::lock_guard<std::mutex> lock(adjacency_mutex_);
+    if (adjacency_ == nullptr) adjacency_ = std::make_shared<MeshAdjacency>(triangles_, positions_.size() / 3);
+    return adjacency_;
+}
+
+void Mesh::SetAdjacency(std::shared_ptr<const MeshAdjacency> adjacency) {
+    std::lock_guard<std::mutex> lock(adjacency_mutex_);
+    adjacency_ = std::move(adjacency);
+}
+
 void Mesh::CalculateBinormalsAndTangents() {
+    ComputeBinormalsAndTangents();
+    MarkDirty();
+}
+
+void Mesh::ComputeBinormalsAndTangents() {
     if (UVs_.size()==0 || triangles_.size()==0 || (normals_.size()*2 != UVs_.size()*3) || (normals_.size() != positions_.size())) {
         return;
     }
 
-    std::vector<float> binorms(normals_.size(), 0);
-    std::vector<float> tans(normals_.size(), 0);
+    // The tangent and binormal of each triangle are independent, so they are found in parallel for big meshes,
+    // then summed into their vertices in order
+    size_t num_triangles = triangles_.size() / 3;
+    std::vector<glm::vec3> triangle_tans(num_triangles);
+    std::vector<glm::vec3> triangle_binorms(num_triangles);
 
     //This turns out incorrect. I think one of the axises should be flipped. (TODO FIX)
-    for (unsigned int i = 0; i < triangles_.size(); i += 3) {
-        glm::vec3 P0(positions_[(triangles_[i]*3)], positions_[(triangles_[i]*3)+1], positions_[(triangles_[i]*3)+2]);
-        glm::vec3 P1(positions_[(triangles_[i+1]*3)], positions_[(triangles_[i+1]*3)+1], positions_[(triangles_[i+1]*3)+2]);
-        glm::vec3 P2(positions_[(triangles_[i+2]*3)], positions_[(triangles_[i+2]*3)+1], positions_[(triangles_[i+2]*3)+2]);
-
-        glm::vec2 UV0(UVs_[(triangles_[i]*2)], UVs_[(triangles_[i]*2)+1]);
-        glm::vec2 UV1(UVs_[(triangles_[i+1]*2)], UVs_[(triangles_[i+1]*2)+1]);
-        glm::vec2 UV2(UVs_[(triangles_[i+2]*2)], UVs_[(triangles_[i+2]*2)+1]);
-
-        //using Eric Lengyel's approach with a few modifications
-        //from Mathematics for 3D Game Programmming and Computer Graphics
-        // want to be able to trasform a vector in Object Space to Tangent Space
-        // such that the x-axis cooresponds to the 's' direction and the
-        // y-axis corresponds to the 't' direction, and the z-axis corresponds
-        // to <0,0,1>, straight up out of the texture map
-
-        //let P = v1 - v0
-        glm::vec3 P = P1 - P0;
-        //let Q = v2 - v0
-        glm::vec3 Q = P2 - P0;
-        float s1 = UV1.x - UV0.x;
-        float t1 = UV1.y - UV0.y;
-        float s2 = UV2.x - UV0.x;
-        float t2 = UV2.y - UV0.y;
-
-        //we need to solve the equation
-        // P = s1*T + t1*B
-        // Q = s2*T + t2*B
-        // for T and B
-
-        //this is a linear system with six unknowns and six equatinos, for TxTyTz BxByBz
-        //[px,py,pz] = [s1,t1] * [Tx,Ty,Tz]
-        // qx,qy,qz     s2,t2     Bx,By,Bz
-
-        //multiplying both sides by the inverse of the s,t matrix gives
-        //[Tx,Ty,Tz] = 1/(s1t2-s2t1) *  [t2,-t1] * [px,py,pz]
-        // Bx,By,Bz                      -s2,s1	    qx,qy,qz
-
-        //solve this for the unormalized T and B to get from tangent to object space
-        glm::vec3 tan((t2*P.x - t1*Q.x), (t2*P.y - t1*Q.y), (t2*P.z - t1*Q.z));
-        glm::vec3 binorm((s1*Q.x - s2*P.x), (s1*Q.y - s2*P.y), (s1*Q.z - s2*P.z));
-
-        float factor = 1.0f/(s1*t2-s2*t1);
-
-        tan = factor*tan;
-        binorm = factor*binorm;
-
-        for (unsigned int j = i; j <= i+2; j++) {
+    ParallelFor(num_triangles, TANGENT_TRIANGLES_PER_TASK, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; t++) {
+            size_t i = t * 3;
+            glm::vec3 P0(positions_[(triangles_[i]*3)], positions_[(triangles_[i]*3)+1], positions_[(triangles_[i]*3)+2]);
+            glm::vec3 P1(positions_[(triangles_[i+1]*3)], positions_[(triangles_[i+1]*3)+1], positions_[(triangles_[i+1]*3)+2]);
+            glm::vec3 P2(positions_[(triangles_[i+2]*3)], positions_[(triangles_[i+2]*3)+1], positions_[(triangles_[i+2]*3)+2]);
+
+            glm::vec2 UV0(UVs_[(triangles_[i]*2)], UVs_[(triangles_[i]*2)+1]);
+            glm::vec2 UV1(UVs_[(triangles_[i+1]*2)], UVs_[(triangles_[i+1]*2)+1]);
+            glm::vec2 UV2(UVs_[(triangles_[i+2]*2)], UVs_[(triangles_[i+2]*2)+1]);
+
+            //using Eric Lengyel's approach with a few modifications
+            //from Mathematics for 3D Game Programmming and Computer Graphics
+            // want to be able to trasform a vector in Object Space to Tangent Space
+            // such that the x-axis cooresponds to the 's' direction and the
+            // y-axis corresponds to the 't' direction, and the z-axis corresponds
+            // to <0,0,1>, straight up out of the texture map
+
+            //let P = v1 - v0
+            glm::vec3 P = P1 - P0;
+            //let Q = v2 - v0
+            glm::vec3 Q = P2 - P0;
+            float s1 = UV1.x - UV0.x;
+            float t1 = UV1.y - UV0.y;
+            float s2 = UV2.x - UV0.x;
+            float t2 = UV2.y - UV0.y;
+
+            //we need to solve the equation
+            // P = s1*T + t1*B
+            // Q = s2*T + t2*B
+            // for T and B
+
+            //this is a linear system with six unknowns and six equatinos, for TxTyTz BxByBz
+            //[px,py,pz] = [s1,t1] * [Tx,Ty,Tz]
+            // qx,qy,qz     s2,t2     Bx,By,Bz
+
+            //multiplying both sides by the inverse of the s,t matrix gives
+            //[Tx,Ty,Tz] = 1/(s1t2-s2t1) *  [t2,-t1] * [px,py,pz]
+            // Bx,By,Bz                      -s2,s1	    qx,qy,qz
+
+            //solve this for the unormalized T and B to get from tangent to object space
+            glm::vec3 tan((t2*P.x - t1*Q.x), (t2*P.y - t1*Q.y), (t2*P.z - t1*Q.z));
+            glm::vec3 binorm((s1*Q.x - s2*P.x), (s1*Q.y - s2*P.y), (s1*Q.z - s2*P.z));
+
+            float factor = 1.0f/(s1*t2-s2*t1);
+
+            triangle_tans[t] = factor*tan;
+            triangle_binorms[t] = factor*binorm;
+        }
+    });
+
+    std::vector<float> binorms(normals_.size(), 0);
+    std::vector<float> tans(normals_.size(), 0);
+    for (size_t t = 0; t < num_triangles; t++) {
+        const glm::vec3& tan = triangle_tans[t];
+        const glm::vec3& binorm = triangle_binorms[t];
+        for (size_t j = t*3; j <= t*3+2; j++) {
             binorms[(triangles_[j]*3)] += binorm.x;
             binorms[(triangles_[j]*3)+1] += binorm.y;
             binorms[(triangles_[j]*3)+2] += binorm.z;
@@ -237,22 +285,29 @@ void Mesh::CalculateBinormalsAndTangents() {
     }
 
     // The binormal/tangent of each triangle around a vertex can be different, so just average them
-    for (unsigned int i = 0; i < normals_.size(); i += 3) {
-        glm::vec3 binorm(binorms[i], binorms[i+1], binorms[i+2]);
-        glm::vec3 tan(tans[i], tans[i+1], tans[i+2]);
+    ParallelFor(normals_.size() / 3, TANGENT_TRIANGLES_PER_TASK, [&](size_t begin, size_t end) {
+        for (size_t i = begin*3; i < end*3; i += 3) {
+            glm::vec3 binorm(binorms[i], binorms[i+1], binorms[i+2]);
+            glm::vec3 tan(tans[i], tans[i+1], tans[i+2]);
 
-        binorm = glm::normalize(binorm);
-        tan = glm::normalize(tan);
+            binorm = glm::normalize(binorm);
+            tan = glm::normalize(tan);
 
-        binorms[i] = binorm.x;
-        binorms[i+1] = binorm.y;
-        binorms[i+2] = binorm.z;
+            binorms[i] = binorm.x;
+            binorms[i+1] = binorm.y;
+            binorms[i+2] = binorm.z;
 
-        tans[i] = tan.x;
-        tans[i+1] = tan.y;
-        tans[i+2] = tan.z;
-    }
+            tans[i] = tan.x;
+            tans[i+1] = tan.y;
+            tans[i+2] = tan.z;
+        }
+    });
+
+    binormals_ = std::move(binorms);
+    tangents_ = std::move(tans);
+}
 
-    SetBinormals(binorms);
-    SetTangents(tans);
+MeshEdit::~MeshEdit() {
+    if (tangents_stale_ && !tangents_set_) mesh_.ComputeBinormalsAndTangents();
+    mesh_.MarkDirty();
 }
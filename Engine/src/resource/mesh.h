@@ -14,11 +14,18 @@
 #include <resource/asset.h>
 #include <properties.h>
 #include <resource/cacheable.h>
+#include <memory>
+#include <mutex>
+
+class MeshEdit;
+class MeshAdjacency;
 
 // Mesh consists of triangles arranged in 3D space to create the impression of a solid object.
 // A triangle is defined by its three corner points or vertices.
 // See: https://docs.unity3d.com/Manual/AnatomyofaMesh.html
+// Each setter is an edit of its own; use a MeshEdit to change several arrays at once.
 class Mesh : public Asset, public Cacheable {
+    friend class MeshEdit;
 public:
 
     // Relative Path to the asset on disk, should be set after loading from disk.
@@ -27,12 +34,19 @@ public:
 
     Mesh(const std::string& name, MeshType type = MeshType::Triangles);
     void SetPositions(const std::vector<float>& positions);
+    void SetPositions(std::vector<float>&& positions);
     void SetUVs(const std::vector<float>& UVs);
+    void SetUVs(std::vector<float>&& UVs);
     void SetColors(const std::vector<float>& colors);
+    void SetColors(std::vector<float>&& colors);
     void SetNormals(const std::vector<float>& normals);
+    void SetNormals(std::vector<float>&& normals);
     void SetBinormals(const std::vector<float>& binormals);
+    void SetBinormals(std::vector<float>&& binormals);
     void SetTangents(const std::vector<float>& tangents);
+    void SetTangents(std::vector<float>&& tangents);
     void SetTriangles(const std::vector<unsigned int>& triangles);
+    void SetTriangles(std::vector<unsigned int>&& triangles);
     void CalculateBinormalsAndTangents();
 
     void Append(Mesh& other, glm::mat4 transform=glm::mat4());
@@ -48,6 +62,8 @@ public:
     const std::vector<float>& GetBinormals() const;
     const std::vector<float>& GetTangents() const;
     const std::vector<unsigned int>& GetTriangles() const;
+    // Connectivity of the triangles, built on first use and kept until the triangles or the vertex count change
+    std::shared_ptr<const MeshAdjacency> GetAdjacency() const;
 private:
     // Triangle mesh, quad mesh, or other
     MeshType mesh_type_;
@@ -68,6 +84,58 @@ private:
     std::vector<float> binormals_;
     std::vector<float> tangents_;
     std::vector<unsigned int> triangles_;
+
+    // Guards every access to adjacency_, since it is built lazily by whichever thread asks for it first
+    mutable std::mutex adjacency_mutex_;
+    mutable std::shared_ptr<const MeshAdjacency> adjacency_;
+    void SetAdjacency(std::shared_ptr<const MeshAdjacency> adjacency);
+
+    // Triangles per task when computing tangents on several threads
+    static const size_t TANGENT_TRIANGLES_PER_TASK = 16384;
+    // Recomputes binormals_ and tangents_ from the other arrays, if they are complete
+    void ComputeBinormalsAndTangents();
+};
+
+// Groups changes to a Mesh so that its tangents are recomputed, and its version bumped, once when the edit ends.
+// The setters take their vectors by move, so building a mesh doesn't copy its arrays.
+//
+//     {
+//         MeshEdit edit(mesh);
+//         edit.SetPositions(std::move(positions));
+//         edit.SetNormals(std::move(normals));
+//         edit.SetTriangles(std::move(triangles));
+//     } // Tangents are computed and the mesh is marked dirty here
+class MeshEdit {
+public:
+    MeshEdit(Mesh& mesh) : mesh_(mesh), tangents_stale_(false), tangents_set_(false) { }
+    ~MeshEdit();
+    MeshEdit(const MeshEdit&) = delete;
+    MeshEdit& operator=(const MeshEdit&) = delete;
+
+    void SetPositions(std::vector<float>&& positions) {
+        if (positions.size() != mesh_.positions_.size()) mesh_.SetAdjacency(nullptr);
+        mesh_.positions_ = std::move(positions);
+        tangents_stale_ = true;
+    }
+    void SetUVs(std::vector<float>&& UVs) { mesh_.UVs_ = std::move(UVs); tangents_stale_ = true; }
+    void SetColors(std::vector<float>&& colors) { mesh_.colors_ = std::move(colors); }
+    void SetNormals(std::vector<float>&& normals) { mesh_.normals_ = std::move(normals); tangents_stale_ = true; }
+    void SetTriangles(std::vector<unsigned int>&& triangles) { SetTriangles(std::move(triangles), nullptr); }
+    // Takes adjacency already built for these triangles (e.g. from a mesh with the same connectivity) along with them.
+    // Set the positions first, since changing the vertex count drops it.
+    void SetTriangles(std::vector<unsigned int>&& triangles, std::shared_ptr<const MeshAdjacency> adjacency) {
+        mesh_.triangles_ = std::move(triangles);
+        mesh_.SetAdjacency(std::move(adjacency));
+        tangents_stale_ = true;
+    }
+    // Setting these keeps them as given rather than recomputing them when the edit ends
+    void SetBinormals(std::vector<float>&& binormals) { mesh_.binormals_ = std::move(binormals); tangents_set_ = true; }
+    void SetTangents(std::vector<float>&& tangents) { mesh_.tangents_ = std::move(tangents); tangents_set_ = true; }
+
+private:
+    Mesh& mesh_;
+    bool tangents_stale_;
+    bool tangents_set_;
 };
 
 #endif // MESH_H
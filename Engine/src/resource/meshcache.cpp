@@ -0,0 +1,130 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#include "meshcache.h"
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <cstdint>
+#include <cstring>
+
+// "AMSH" in a little-endian file; reads as something else on a machine with the other byte order
+const uint32_t MeshCache::MAGIC = 0x48534D41;
+const uint32_t MeshCache::VERSION = 1;
+
+std::string MeshCache::GetKey(const std::string& path, const std::string& settings) {
+    QFile file(QString::fromStdString(path));
+    if (!file.open(QIODevice::ReadOnly)) return "";
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    if (!hash.addData(&file)) return "";
+    hash.addData(settings.data(), settings.size());
+    return hash.result().toHex().toStdString();
+}
+
+std::string MeshCache::GetDirectory() {
+    return (QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/meshes").toStdString();
+}
+
+// Layout: magic, version, then for each array its element count (uint64) followed by its elements.
+// Every element is 4 bytes, so the arrays stay aligned in the mapped file.
+template <typename T>
+static bool ReadArray(const uchar*& cursor, const uchar* end, std::vector<T>& v) {
+    static_assert(sizeof(T) == 4, "Mesh cache arrays have 4 byte elements");
+    uint64_t count;
+    if (end - cursor < (ptrdiff_t) sizeof(count)) return false;
+    memcpy(&count, cursor, sizeof(count));
+    cursor += sizeof(count);
+    if ((uint64_t) (end - cursor) / sizeof(T) < count) return false;
+    v.resize(count);
+    memcpy(v.data(), cursor, count * sizeof(T));
+    cursor += count * sizeof(T);
+    return true;
+}
+
+template <typename T>
+static bool WriteArray(QSaveFile& file, const std::vector<T>& v) {
+    uint64_t count = v.size();
+    qint64 bytes = count * sizeof(T);
+    return file.write(reinterpret_cast<const char*>(&count), sizeof(count)) == sizeof(count)
+        && file.write(reinterpret_cast<const char*>(v.data()), bytes) == bytes;
+}
+
+// Whether the arrays describe one mesh: every per-vertex array is empty or has an entry for each vertex,
+// and every triangle indexes vertices that exist
+static bool IsConsistent(const Importers::MeshData& data) {
+    size_t vertices = data.positions.size() / 3;
+    if (data.positions.size() % 3 != 0 || data.triangles.size() % 3 != 0) return false;
+    for (const std::vector<float>* v : { &data.normals, &data.colors, &data.binormals, &data.tangents }) {
+        if (!v->empty() && v->size() != data.positions.size()) return false;
+    }
+    if (!data.uvs.empty() && data.uvs.size() != vertices * 2) return false;
+    for (unsigned int index : data.triangles) {
+        if (index >= vertices) return false;
+    }
+    return true;
+}
+
+bool MeshCache::Load(const std::string& key, Importers::MeshData& data) {
+    if (key.empty()) return false;
+    QFile file(QString::fromStdString(GetDirectory() + "/" + key + ".mesh"));
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    const uchar* cursor = file.map(0, file.size());
+    if (cursor == nullptr) return false;
+    const uchar* end = cursor + file.size();
+
+    uint32_t header[2];
+    if (end - cursor < (ptrdiff_t) sizeof(header)) return false;
+    memcpy(header, cursor, sizeof(header));
+    if (header[0] != MAGIC || header[1] != VERSION) return false;
+    cursor += sizeof(header);
+
+    // Read into a copy so that data is untouched if the entry turns out to be truncated or corrupt
+    Importers::MeshData loaded;
+    bool valid = ReadArray(cursor, end, loaded.positions)
+        && ReadArray(cursor, end, loaded.normals)
+        && ReadArray(cursor, end, loaded.colors)
+        && ReadArray(cursor, end, loaded.uvs)
+        && ReadArray(cursor, end, loaded.binormals)
+        && ReadArray(cursor, end, loaded.tangents)
+        && ReadArray(cursor, end, loaded.triangles);
+    if (!valid || !IsConsistent(loaded)) return false;
+    data.positions.swap(loaded.positions);
+    data.normals.swap(loaded.normals);
+    data.colors.swap(loaded.colors);
+    data.uvs.swap(loaded.uvs);
+    data.binormals.swap(loaded.binormals);
+    data.tangents.swap(loaded.tangents);
+    data.triangles.swap(loaded.triangles);
+    return true;
+}
+
+bool MeshCache::Store(const std::string& key, const Mesh& mesh) {
+    if (key.empty() || !QDir().mkpath(QString::fromStdString(GetDirectory()))) return false;
+
+    // Written to a temporary file that replaces the entry on commit, so a partial entry is never read
+    QSaveFile file(QString::fromStdString(GetDirectory() + "/" + key + ".mesh"));
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    const uint32_t header[2] = { MAGIC, VERSION };
+    bool written = file.write(reinterpret_cast<const char*>(header), sizeof(header)) == sizeof(header)
+        && WriteArray(file, mesh.GetPositions())
+        && WriteArray(file, mesh.GetNormals())
+        && WriteArray(file, mesh.GetColors())
+        && WriteArray(file, mesh.GetUVs())
+        && WriteArray(file, mesh.GetBinormals())
+        && WriteArray(file, mesh.GetTangents())
+        && WriteArray(file, mesh.GetTriangles());
+    if (!written) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
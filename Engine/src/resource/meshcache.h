@@ -0,0 +1,39 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#ifndef MESHCACHE_H
+#define MESHCACHE_H
+
+#include <resource/importers.h>
+
+// On-disk cache of imported meshes, so each mesh file only goes through assimp once.
+// Entries are named by a hash of the source file's contents and the import settings, and hold the
+// mesh's final arrays (including tangents) one after another, so reading one back is a copy per array.
+// The cache lives in the user's cache directory. Entries are never invalidated, since editing the
+// source file changes its key; deleting the directory is always safe.
+class MeshCache {
+public:
+    // Identifies the file's current contents imported with the given settings.
+    // Returns an empty key if the file can't be read.
+    static std::string GetKey(const std::string& path, const std::string& settings);
+
+    // Fills data's arrays from the entry for key. Returns false, leaving data as it was, if there isn't a valid one.
+    static bool Load(const std::string& key, Importers::MeshData& data);
+
+    // Writes the mesh's arrays as the entry for key. Returns false if the entry couldn't be written.
+    static bool Store(const std::string& key, const Mesh& mesh);
+
+    static std::string GetDirectory();
+
+private:
+    static const uint32_t MAGIC;
+    static const uint32_t VERSION;
+};
+
+#endif // MESHCACHE_H
@@ -0,0 +1,94 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#include "revolutioncache.h"
+#include <fileio.h>
+#include <resource/subdivisioncache.h>
+#include <QFileInfo>
+#include <QDateTime>
+
+RevolutionCache& RevolutionCache::Instance() {
+    static RevolutionCache cache;
+    return cache;
+}
+
+RevolutionCache::RevolutionCache() :
+    memory_budget_(DEFAULT_MEMORY_BUDGET),
+    memory_used_(0)
+{
+}
+
+RevolutionCache::~RevolutionCache() {
+    MeshEvicted.Clear();
+}
+
+std::shared_ptr<const RevolutionCache::CurveList> RevolutionCache::GetCurves(const std::string& path) {
+    return Refresh(path).points;
+}
+
+std::shared_ptr<Mesh> RevolutionCache::GetMesh(const std::string& path, int quality, const MeshCreator& create) {
+    const Curves& curves = Refresh(path);
+    if (quality < 0 || (size_t) quality >= curves.points->size()) quality = 0;
+    Key key = {path, quality};
+
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+        recent_.splice(recent_.begin(), recent_, it->second.recent);
+        return it->second.mesh;
+    }
+
+    recent_.push_front(key);
+    Entry& entry = entries_[key];
+    entry.mesh = create((*curves.points)[quality]);
+    entry.bytes = SubdivisionCache::MeshBytes(*entry.mesh);
+    entry.recent = recent_.begin();
+    memory_used_ += entry.bytes;
+    Evict(entry.mesh.get());
+    return entry.mesh;
+}
+
+void RevolutionCache::SetMemoryBudget(size_t bytes) {
+    memory_budget_ = bytes;
+    Evict(nullptr);
+}
+
+const RevolutionCache::Curves& RevolutionCache::Refresh(const std::string& path) {
+    QFileInfo info(QString::fromStdString(path));
+    FileVersion version = {info.lastModified().toMSecsSinceEpoch(), info.size()};
+    auto it = curves_.find(path);
+    if (it != curves_.end() && it->second.version == version) return it->second;
+
+    // Parse first, so that a file that can't be read leaves the cache as it was
+    auto points = std::make_shared<const CurveList>(FileIO::ReadCurveFile(path));
+    for (auto entry = entries_.lower_bound({path, 0}); entry != entries_.end() && entry->first.path == path; ) {
+        Remove(entry++);
+    }
+    Curves& curves = curves_[path];
+    curves.version = version;
+    curves.points = std::move(points);
+    return curves;
+}
+
+void RevolutionCache::Remove(std::map<Key, Entry>::iterator entry) {
+    MeshEvicted.Emit(entry->second.mesh->GetUID());
+    memory_used_ -= entry->second.bytes;
+    recent_.erase(entry->second.recent);
+    entries_.erase(entry);
+}
+
+void RevolutionCache::Evict(const Mesh* keep) {
+    auto it = recent_.end();
+    while (memory_used_ > memory_budget_ && it != recent_.begin()) {
+        --it;
+        auto entry = entries_.find(*it);
+        if (entry->second.mesh.get() == keep) continue;
+        ++it;
+        Remove(entry);
+    }
+}
@@ -0,0 +1,85 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#ifndef REVOLUTIONCACHE_H
+#define REVOLUTIONCACHE_H
+
+#include <resource/mesh.h>
+#include <list>
+#include <map>
+#include <tuple>
+
+// Surfaces of revolution made from curve files, shared by every SurfaceOfRevolution using the same file.
+// Curve files are parsed once per version (modification time and size) of the file, and each quality level's mesh
+// is kept, so switching quality or reopening a scene doesn't regenerate anything.
+// Once the meshes held grow past the memory budget, the least recently used are evicted.
+class RevolutionCache {
+public:
+    typedef std::vector<std::vector<glm::vec2>> CurveList;
+    typedef std::function<std::unique_ptr<Mesh>(const std::vector<glm::vec2>&)> MeshCreator;
+
+    static RevolutionCache& Instance();
+    ~RevolutionCache();
+
+    // The points of each quality level in the curve file, as FileIO::ReadCurveFile reads them.
+    // Throws a FileIOException if the file can't be read.
+    std::shared_ptr<const CurveList> GetCurves(const std::string& path);
+
+    // The mesh create makes from the quality level's points in the curve file (quality 0 if the file has fewer levels).
+    // Throws a FileIOException if the file can't be read.
+    std::shared_ptr<Mesh> GetMesh(const std::string& path, int quality, const MeshCreator& create);
+
+    // Counts the vertex and index arrays of the meshes held
+    void SetMemoryBudget(size_t bytes);
+    size_t GetMemoryBudget() const { return memory_budget_; }
+    size_t GetMemoryUsed() const { return memory_used_; }
+
+    // Emitted with the UID of a mesh before it is evicted, so that copies of it (like GPU buffers) can go too
+    Signal1<uint64_t> MeshEvicted;
+
+    static const size_t DEFAULT_MEMORY_BUDGET = size_t(1) << 28;
+
+private:
+    RevolutionCache();
+
+    struct FileVersion {
+        int64_t modified;
+        int64_t size;
+        bool operator==(const FileVersion& other) const { return modified == other.modified && size == other.size; }
+    };
+    struct Key {
+        std::string path;
+        int quality;
+        bool operator<(const Key& other) const { return std::tie(path, quality) < std::tie(other.path, other.quality); }
+    };
+    struct Curves {
+        FileVersion version;
+        std::shared_ptr<const CurveList> points;
+    };
+    struct Entry {
+        std::shared_ptr<Mesh> mesh;
+        size_t bytes;
+        std::list<Key>::iterator recent;
+    };
+
+    std::map<std::string, Curves> curves_;
+    std::map<Key, Entry> entries_;
+    // Most recently used first
+    std::list<Key> recent_;
+    size_t memory_budget_;
+    size_t memory_used_;
+
+    // Parses the file again if it changed since it was last read, dropping the meshes made from the old version
+    const Curves& Refresh(const std::string& path);
+    void Remove(std::map<Key, Entry>::iterator entry);
+    // Evicts the least recently used meshes, other than keep, until the cache fits in its budget
+    void Evict(const Mesh* keep);
+};
+
+#endif // REVOLUTIONCACHE_H
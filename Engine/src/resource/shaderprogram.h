@@ -60,6 +60,8 @@ public:
             "area_light_atten_const",
             "area_light_atten_linear",
             "area_light_atten_quad",
+            // Instanced rendering
+            "instance_billboard",
         };
         return uniforms;
     }
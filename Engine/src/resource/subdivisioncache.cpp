@@ -0,0 +1,235 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#include "subdivisioncache.h"
+#include <meshprocessing.h>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <algorithm>
+
+// Levels being built in the background. Each level is subdivided from the one before, starting from base.
+struct SubdivisionBuild {
+    std::shared_ptr<const Mesh> base;
+    std::vector<std::pair<SubdivisionCache::Key, std::shared_ptr<Mesh>>> levels;
+    QMutex mutex;
+    bool done = false;
+    // Set once the mesh has been edited since the build was queued, so its levels would only be thrown away
+    std::atomic<bool> superseded{false};
+};
+
+class SubdivisionBuilder : public QRunnable {
+public:
+    SubdivisionBuilder(std::shared_ptr<SubdivisionBuild> build, std::atomic<bool>& finished) :
+        build_(build), finished_(finished) { }
+
+    void run() override {
+        const Mesh* input = build_->base.get();
+        for (auto& level : build_->levels) {
+            if (build_->superseded) break;
+            MeshProcessing::SubdivideMesh(*input, *level.second, level.first.limit);
+            input = level.second.get();
+        }
+        {
+            QMutexLocker lock(&build_->mutex);
+            build_->done = true;
+        }
+        finished_ = true;
+    }
+
+private:
+    std::shared_ptr<SubdivisionBuild> build_;
+    std::atomic<bool>& finished_;
+};
+
+SubdivisionCache& SubdivisionCache::Instance() {
+    static SubdivisionCache cache;
+    return cache;
+}
+
+SubdivisionCache::SubdivisionCache() :
+    memory_budget_(DEFAULT_MEMORY_BUDGET),
+    memory_used_(0),
+    builds_finished_(false)
+{
+    // One level at a time; subdividing is already spread over the global thread pool
+    build_pool_.setMaxThreadCount(1);
+}
+
+SubdivisionCache::~SubdivisionCache() {
+    build_pool_.waitForDone();
+    MeshEvicted.Clear();
+}
+
+Mesh* SubdivisionCache::Get(Mesh& mesh, int level, bool wait) {
+    if (level <= 0) return &mesh;
+    Key key = {mesh.GetUID(), mesh.GetVersion(), level, true};
+    latest_versions_[key.uid] = key.version;
+    CollectBuilds();
+    DropStale(key.uid, key.version);
+
+    Mesh* subdivided = Find(key);
+    if (subdivided == nullptr && wait && builds_.count(key) > 0) {
+        build_pool_.waitForDone();
+        CollectBuilds();
+        subdivided = Find(key);
+    }
+    if (subdivided != nullptr) {
+        Evict(subdivided);
+        return subdivided;
+    }
+
+    if (builds_.count(key) == 0) {
+        // Start from the deepest level already built
+        int base = level - 1;
+        while (base > 0 && Find({key.uid, key.version, base, false}) == nullptr) base--;
+        std::shared_ptr<Mesh> base_mesh = base > 0 ? entries_[{key.uid, key.version, base, false}].mesh : nullptr;
+        const Mesh& input = base > 0 ? *base_mesh : mesh;
+        size_t triangles = input.GetTriangles().size() / 3;
+        for (int i = base; i < level && triangles < SYNCHRONOUS_TRIANGLES; i++) triangles *= 4;
+
+        auto levels = MakeLevels(mesh, key, base);
+        if (wait || triangles < SYNCHRONOUS_TRIANGLES) {
+            const Mesh* current = &input;
+            for (auto& next : levels) {
+                MeshProcessing::SubdivideMesh(*current, *next.second, next.first.limit);
+                Insert(next.first, next.second);
+                current = next.second.get();
+            }
+            subdivided = levels.back().second.get();
+            Evict(subdivided);
+            return subdivided;
+        }
+
+        auto build = std::make_shared<SubdivisionBuild>();
+        if (base_mesh != nullptr) {
+            build->base = base_mesh;
+        } else {
+            // The mesh may be edited while the build runs, so it works on a copy of the arrays subdivision reads.
+            // Setting the (empty) tangents keeps the copy from computing its own.
+            auto copy = std::make_shared<Mesh>(mesh.GetName(), mesh.GetMeshType());
+            MeshEdit edit(*copy);
+            edit.SetPositions(std::vector<float>(mesh.GetPositions()));
+            edit.SetUVs(std::vector<float>(mesh.GetUVs()));
+            edit.SetTriangles(std::vector<unsigned int>(mesh.GetTriangles()));
+            edit.SetBinormals(std::vector<float>());
+            edit.SetTangents(std::vector<float>());
+            build->base = copy;
+        }
+        build->levels = std::move(levels);
+        builds_[key] = build;
+        build_pool_.start(new SubdivisionBuilder(build, builds_finished_));
+    }
+
+    // Show the deepest level that's ready in the meantime
+    Mesh* shown = &mesh;
+    for (int k = level - 1; k > 0 && shown == &mesh; k--) {
+        Mesh* found = Find({key.uid, key.version, k, true});
+        if (found == nullptr) found = Find({key.uid, key.version, k, false});
+        if (found != nullptr) shown = found;
+    }
+    Evict(shown);
+    return shown;
+}
+
+void SubdivisionCache::SetMemoryBudget(size_t bytes) {
+    memory_budget_ = bytes;
+    Evict(nullptr);
+}
+
+bool SubdivisionCache::TakeFinishedBuilds() {
+    return builds_finished_.exchange(false);
+}
+
+Mesh* SubdivisionCache::Find(const Key& key) {
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return nullptr;
+    recent_.splice(recent_.begin(), recent_, it->second.recent);
+    return it->second.mesh.get();
+}
+
+void SubdivisionCache::Insert(const Key& key, std::shared_ptr<Mesh> mesh) {
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+        memory_used_ -= it->second.bytes;
+        recent_.erase(it->second.recent);
+        entries_.erase(it);
+    }
+    recent_.push_front(key);
+    Entry& entry = entries_[key];
+    entry.bytes = MeshBytes(*mesh);
+    entry.mesh = std::move(mesh);
+    entry.recent = recent_.begin();
+    memory_used_ += entry.bytes;
+}
+
+void SubdivisionCache::Evict(const Mesh* keep) {
+    auto it = recent_.end();
+    while (memory_used_ > memory_budget_ && it != recent_.begin()) {
+        --it;
+        auto entry = entries_.find(*it);
+        if (entry->second.mesh.get() == keep) continue;
+        MeshEvicted.Emit(entry->second.mesh->GetUID());
+        memory_used_ -= entry->second.bytes;
+        entries_.erase(entry);
+        it = recent_.erase(it);
+    }
+}
+
+void SubdivisionCache::DropStale(uint64_t uid, uint64_t version) {
+    // Builds of other versions that haven't finished stop at their next level, and CollectBuilds discards them
+    for (auto it = builds_.lower_bound({uid, 0, 0, false}); it != builds_.end() && it->first.uid == uid; ++it) {
+        if (it->first.version != version) it->second->superseded = true;
+    }
+    for (auto it = entries_.lower_bound({uid, 0, 0, false}); it != entries_.end() && it->first.uid == uid; ) {
+        if (it->first.version == version) {
+            ++it;
+            continue;
+        }
+        MeshEvicted.Emit(it->second.mesh->GetUID());
+        memory_used_ -= it->second.bytes;
+        recent_.erase(it->second.recent);
+        it = entries_.erase(it);
+    }
+}
+
+void SubdivisionCache::CollectBuilds() {
+    for (auto it = builds_.begin(); it != builds_.end(); ) {
+        {
+            QMutexLocker lock(&it->second->mutex);
+            if (!it->second->done) {
+                ++it;
+                continue;
+            }
+        }
+        // Only keep the levels of the version of the mesh that was last asked for
+        auto latest = latest_versions_.find(it->first.uid);
+        bool stale = it->second->superseded || (latest != latest_versions_.end() && latest->second != it->first.version);
+        if (!stale) {
+            for (auto& level : it->second->levels) Insert(level.first, level.second);
+        }
+        it = builds_.erase(it);
+    }
+}
+
+std::vector<std::pair<SubdivisionCache::Key, std::shared_ptr<Mesh>>> SubdivisionCache::MakeLevels(const Mesh& mesh, const Key& key, int base) {
+    std::vector<std::pair<Key, std::shared_ptr<Mesh>>> levels;
+    for (int k = base + 1; k <= key.level; k++) {
+        bool limit = k == key.level;
+        std::string name = mesh.GetName() + " subdivision" + std::to_string(k) + (limit ? " limit" : "");
+        levels.emplace_back(Key{key.uid, key.version, k, limit}, std::make_shared<Mesh>(name, MeshType::Triangles));
+    }
+    return levels;
+}
+
+size_t SubdivisionCache::MeshBytes(const Mesh& mesh) {
+    size_t floats = mesh.GetPositions().size() + mesh.GetColors().size() + mesh.GetUVs().size() +
+                    mesh.GetNormals().size() + mesh.GetBinormals().size() + mesh.GetTangents().size();
+    return floats * sizeof(float) + mesh.GetTriangles().size() * sizeof(unsigned int);
+}
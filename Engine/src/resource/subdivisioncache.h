@@ -0,0 +1,99 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#ifndef SUBDIVISIONCACHE_H
+#define SUBDIVISIONCACHE_H
+
+#include <resource/mesh.h>
+#include <QThreadPool>
+#include <atomic>
+#include <list>
+#include <map>
+#include <tuple>
+
+struct SubdivisionBuild;
+
+// Loop subdivisions of meshes, shared by every component that subdivides the same mesh.
+// Entries are keyed by the mesh's UID and version, the level, and whether the vertices are at their limit positions.
+// Once the meshes held grow past the memory budget, the least recently used are evicted.
+// Levels that would take a while are built in the background, and until they're ready Get returns the deepest
+// level that is, so the viewport keeps showing the previous level instead of stalling.
+// There is a single cache for the program, since the meshes it's keyed by may belong to any scene.
+class SubdivisionCache {
+    friend struct SubdivisionBuild;
+public:
+    static SubdivisionCache& Instance();
+    ~SubdivisionCache();
+
+    // Mesh subdivided level times, with its vertices at their limit positions. While that is being built,
+    // returns the deepest level that's ready instead (down to mesh itself), unless wait is true.
+    // The result stays valid until the next call.
+    Mesh* Get(Mesh& mesh, int level, bool wait = false);
+
+    // Counts the vertex and index arrays of the meshes held
+    void SetMemoryBudget(size_t bytes);
+    size_t GetMemoryBudget() const { return memory_budget_; }
+    size_t GetMemoryUsed() const { return memory_used_; }
+
+    // True if a background build finished since the last call, so views showing a coarser level should redraw
+    bool TakeFinishedBuilds();
+
+    // Emitted with the UID of a subdivided mesh before it is evicted, so that copies of it (like GPU buffers) can go too
+    Signal1<uint64_t> MeshEvicted;
+
+    // Bytes of the vertex and index arrays of the mesh, as the memory budget counts them
+    static size_t MeshBytes(const Mesh& mesh);
+
+    static const size_t DEFAULT_MEMORY_BUDGET = size_t(1) << 30;
+    // Levels expected to have fewer triangles than this are built right away
+    static const size_t SYNCHRONOUS_TRIANGLES = 1 << 18;
+
+private:
+    SubdivisionCache();
+
+    struct Key {
+        uint64_t uid;
+        uint64_t version;
+        int level;
+        bool limit;
+        bool operator<(const Key& other) const {
+            return std::tie(uid, version, level, limit) < std::tie(other.uid, other.version, other.level, other.limit);
+        }
+    };
+    struct Entry {
+        std::shared_ptr<Mesh> mesh;
+        size_t bytes;
+        std::list<Key>::iterator recent;
+    };
+
+    std::map<Key, Entry> entries_;
+    // Most recently used first
+    std::list<Key> recent_;
+    size_t memory_budget_;
+    size_t memory_used_;
+
+    std::map<Key, std::shared_ptr<SubdivisionBuild>> builds_;
+    // The version of each mesh that was last asked for, by UID; builds of older versions are discarded
+    std::map<uint64_t, uint64_t> latest_versions_;
+    QThreadPool build_pool_;
+    std::atomic<bool> builds_finished_;
+
+    Mesh* Find(const Key& key);
+    void Insert(const Key& key, std::shared_ptr<Mesh> mesh);
+    // Evicts the least recently used meshes, other than keep, until the cache fits in its budget
+    void Evict(const Mesh* keep);
+    // Drops entries for other versions of the mesh, and stops builds of them
+    void DropStale(uint64_t uid, uint64_t version);
+    // Moves the meshes of finished background builds into the cache
+    void CollectBuilds();
+    // Empty meshes to build the levels above base up to level into; built on this thread, since creating assets isn't thread safe
+    std::vector<std::pair<Key, std::shared_ptr<Mesh>>> MakeLevels(const Mesh& mesh, const Key& key, int base);
+};
+
+#endif // SUBDIVISIONCACHE_H
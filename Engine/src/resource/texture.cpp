@@ -8,37 +8,62 @@
  * should contact the author.
  ****************************************************************************/
 #include <resource/texture.h>
+#include <cstring>
 
-Texture::Texture(const std::string &name, unsigned int width, unsigned int height, const unsigned char* image) :
+Texture::Texture(const std::string &name, unsigned int width, unsigned int height, std::shared_ptr<unsigned char> image) :
     Asset(name),
     ExternalPath(FileType::Image),
     Bilinear(true),
+    Compress(true),
     width_(width),
-    height_(height)
+    height_(height),
+    image_(std::move(image)),
+    format_(TextureFormat::RGBA8)
 {
     AddProperty("Path", &ExternalPath);
     AddProperty("Bilinear", &Bilinear);
+    AddProperty("Compress", &Compress);
     ExternalPath.SetHidden(true);
     Bilinear.ValueSet.Connect(this, &Texture::OnChangeBilinear);
+    Compress.ValueSet.Connect(this, &Texture::OnChangeCompress);
+}
 
+Texture::Texture(const std::string &name, unsigned int width, unsigned int height, const unsigned char* image) :
+    Texture(name, width, height, std::shared_ptr<unsigned char>())
+{
     // Store a copy of the image
-    const unsigned int CHANNELS = 4; // RGBA
-    unsigned int bytes_width = width * CHANNELS;
-    image_ = new unsigned char[bytes_width * height];
-    for (unsigned int y = 0; y < height; y++) {
-        for (unsigned int x = 0; x < width; x++) {
-            unsigned int i = x * CHANNELS;
-            // Copy over a pixel
-            for (unsigned int ch = 0; ch < CHANNELS; ch++)
-                image_[y * bytes_width + i + ch] = image[y * bytes_width + i + ch];
-        }
-    }
+    if (image == nullptr) return;
+    const size_t CHANNELS = 4; // RGBA
+    size_t bytes = (size_t) width * height * CHANNELS;
+    image_ = std::shared_ptr<unsigned char>(new unsigned char[bytes], std::default_delete<unsigned char[]>());
+    memcpy(image_.get(), image, bytes);
 }
 
-void Texture::OnChangeBilinear(bool use) {
+Texture::Texture(const std::string &name, TextureFormat format, std::shared_ptr<const std::vector<TextureLevel>> levels) :
+    Texture(name, levels->front().width, levels->front().height, std::shared_ptr<unsigned char>())
+{
+    format_ = format;
+    levels_ = std::move(levels);
+}
+
+void Texture::SetImage(unsigned int width, unsigned int height, std::shared_ptr<unsigned char> image) {
+    width_ = width;
+    height_ = height;
+    image_ = std::move(image);
+    format_ = TextureFormat::RGBA8;
+    levels_.reset();
+    MarkDirty();
+}
+
+void Texture::SetLevels(TextureFormat format, std::shared_ptr<const std::vector<TextureLevel>> levels) {
+    width_ = levels->front().width;
+    height_ = levels->front().height;
+    image_.reset();
+    format_ = format;
+    levels_ = std::move(levels);
     MarkDirty();
 }
 
-Texture::~Texture() {
-    delete [] image_;
+void Texture::OnChangeBilinear(bool use) {
+    MarkDirty();
 }
@@ -13,6 +13,8 @@
 #include <animator.h>
 #include <resource/asset.h>
 #include <resource/cacheable.h>
+#include <resource/texturecompression.h>
+#include <memory>
 
 class Texture : public Asset, public Cacheable {
 public:
@@ -21,19 +23,39 @@ public:
     // Some assets are stored in the scene file, in which case they will not have an external path.
     FileProperty ExternalPath;
     BooleanProperty Bilinear;
+    // Whether the image is block compressed when it's read from disk. Turn it off for textures that hold data
+    // rather than colors, such as normal or specular maps, where the compression error shows.
+    BooleanProperty Compress;
 
-    // Creates a texture from bytes
+    // Creates a texture from a copy of the bytes
     Texture(const std::string& name, unsigned int width, unsigned int height, const unsigned char* image);
-    ~Texture();
+    // Creates a texture from RGBA pixels without copying them, e.g. straight from the image decoder.
+    // The pixels are freed by the shared pointer's deleter once nothing else holds them.
+    Texture(const std::string& name, unsigned int width, unsigned int height, std::shared_ptr<unsigned char> image);
+    // Creates a block compressed texture from its mip chain, largest level first, sharing the levels
+    Texture(const std::string& name, TextureFormat format, std::shared_ptr<const std::vector<TextureLevel>> levels);
+
+    // Replace the texture's contents, e.g. when its file is reloaded
+    void SetImage(unsigned int width, unsigned int height, std::shared_ptr<unsigned char> image);
+    void SetLevels(TextureFormat format, std::shared_ptr<const std::vector<TextureLevel>> levels);
 
     virtual AssetType GetType() const override { return AssetType::Texture; }
     unsigned int GetWidth() const { return width_; }
     unsigned int GetHeight() const { return height_; }
-    const unsigned char* GetImage() const { return image_; }
+    TextureFormat GetFormat() const { return format_; }
+    // RGBA pixels, or nullptr if the texture is compressed
+    const unsigned char* GetImage() const { return image_.get(); }
+    // The compressed mip chain, or nullptr if the texture is RGBA
+    const std::vector<TextureLevel>* GetLevels() const { return levels_.get(); }
     const glm::vec4 GetColor(unsigned int x,unsigned int y) {
         assert(x < width_);
         assert(y < height_);
-        unsigned char* pixel = image_ + (y * width_ + x)*4;
+        if (levels_) {
+            unsigned char decoded[4];
+            TextureCompression::DecodeTexel(format_, levels_->front(), x, y, decoded);
+            return (glm::vec4{decoded[0],decoded[1],decoded[2],decoded[3]})/255.0f;
+        }
+        unsigned char* pixel = image_.get() + (y * width_ + x)*4;
         return (glm::vec4{pixel[0],pixel[1],pixel[2],pixel[3]})/255.0f;
     }
     const glm::vec4 GetColorUV(glm::vec2 uv) {
@@ -56,17 +78,32 @@ public:
     }
 
     void OnChangeBilinear(bool use);
+    void OnChangeCompress(bool) { CompressChanged.Emit(*this); }
+
+    // Emitted when Compress changes, so that the image can be read from disk again
+    Signal1<Texture&> CompressChanged;
 
 protected:
     unsigned int width_;
     unsigned int height_;
-    unsigned char* image_;
+    std::shared_ptr<unsigned char> image_;
+    TextureFormat format_;
+    std::shared_ptr<const std::vector<TextureLevel>> levels_;
+};
+
+// A color the tracer samples by UV: either a texture, or a solid color that doesn't need a texture at all
+struct TraceColor {
+    Texture* texture = nullptr;
+    glm::vec4 color = glm::vec4(0.0f);
+
+    const glm::vec4 GetColorUV(glm::vec2 uv) const { return texture != nullptr ? texture->GetColorUV(uv) : color; }
+    bool operator!=(const TraceColor& other) const { return texture != other.texture || color != other.color; }
 };
 
 class RenderableTexture: public Texture {
 public:
     RenderableTexture(const std::string& name, unsigned int width, unsigned int height)
-        : Texture(name, width, height, nullptr) {}
+        : Texture(name, width, height, std::shared_ptr<unsigned char>()) {}
     virtual ~RenderableTexture() {}
 
     virtual AssetType GetType() const override { return AssetType::RenderableTexture; }
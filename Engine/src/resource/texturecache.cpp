@@ -0,0 +1,125 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#include "texturecache.h"
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+// "ATEX" in a little-endian file; reads as something else on a machine with the other byte order
+const uint32_t TextureCache::MAGIC = 0x58455441;
+const uint32_t TextureCache::VERSION = 1;
+// Larger than any texture OpenGL can hold, and small enough that the size of a level can't overflow
+const uint32_t TextureCache::MAX_SIZE = 1 << 16;
+// A full mip chain of a MAX_SIZE texture has 17 levels
+const uint32_t TextureCache::MAX_LEVELS = 32;
+
+std::string TextureCache::GetKey(const std::string& path, const std::string& settings) {
+    QFile file(QString::fromStdString(path));
+    if (!file.open(QIODevice::ReadOnly)) return "";
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    if (!hash.addData(&file)) return "";
+    hash.addData(settings.data(), settings.size());
+    return hash.result().toHex().toStdString();
+}
+
+std::string TextureCache::GetDirectory() {
+    return (QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/textures").toStdString();
+}
+
+// Layout: magic, version, format, level count, PSNR (double), then for each level its width and height
+// followed by its blocks. The size of each level's blocks follows from its width, height and the format.
+struct TextureCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t format;
+    uint32_t level_count;
+    double psnr;
+};
+
+bool TextureCache::Load(const std::string& key, Importers::ImageData& data) {
+    if (key.empty()) return false;
+    QFile file(QString::fromStdString(GetDirectory() + "/" + key + ".tex"));
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    const uchar* cursor = file.map(0, file.size());
+    if (cursor == nullptr) return false;
+    const uchar* end = cursor + file.size();
+
+    TextureCacheHeader header;
+    if (end - cursor < (ptrdiff_t) sizeof(header)) return false;
+    memcpy(&header, cursor, sizeof(header));
+    cursor += sizeof(header);
+    if (header.magic != MAGIC || header.version != VERSION || header.level_count == 0 || header.level_count > MAX_LEVELS) return false;
+    TextureFormat format = static_cast<TextureFormat>(header.format);
+    if (format != TextureFormat::BC1 && format != TextureFormat::BC3) return false;
+
+    // Read into a copy so that data is untouched if the entry turns out to be truncated or corrupt
+    auto levels = std::make_shared<std::vector<TextureLevel>>();
+    levels->reserve(header.level_count);
+    for (uint32_t i = 0; i < header.level_count; i++) {
+        uint32_t size[2];
+        if (end - cursor < (ptrdiff_t) sizeof(size)) return false;
+        memcpy(size, cursor, sizeof(size));
+        cursor += sizeof(size);
+        if (i == 0) {
+            if (size[0] == 0 || size[1] == 0 || size[0] > MAX_SIZE || size[1] > MAX_SIZE) return false;
+            // No more levels than the chain down to 1x1 has
+            uint32_t chain = 1;
+            for (uint32_t s = std::max(size[0], size[1]); s > 1; s /= 2) chain++;
+            if (header.level_count > chain) return false;
+        } else {
+            // Each level is half the size of the one before, rounded down, and at least 1
+            const TextureLevel& previous = levels->back();
+            if (size[0] != std::max(previous.width / 2, 1u) || size[1] != std::max(previous.height / 2, 1u)) return false;
+        }
+        size_t bytes = TextureCompression::LevelBytes(format, size[0], size[1]);
+        if ((size_t) (end - cursor) < bytes) return false;
+        levels->emplace_back();
+        TextureLevel& level = levels->back();
+        level.width = size[0];
+        level.height = size[1];
+        level.blocks.assign(cursor, cursor + bytes);
+        cursor += bytes;
+    }
+    data.width = levels->front().width;
+    data.height = levels->front().height;
+    data.pixels.reset();
+    data.format = format;
+    data.psnr = header.psnr;
+    data.levels = std::move(levels);
+    return true;
+}
+
+bool TextureCache::Store(const std::string& key, const Importers::ImageData& data) {
+    if (key.empty() || !data.levels || !QDir().mkpath(QString::fromStdString(GetDirectory()))) return false;
+
+    // Written to a temporary file that replaces the entry on commit, so a partial entry is never read
+    QSaveFile file(QString::fromStdString(GetDirectory() + "/" + key + ".tex"));
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    TextureCacheHeader header = { MAGIC, VERSION, static_cast<uint32_t>(data.format), static_cast<uint32_t>(data.levels->size()), data.psnr };
+    bool written = file.write(reinterpret_cast<const char*>(&header), sizeof(header)) == sizeof(header);
+    for (const TextureLevel& level : *data.levels) {
+        if (!written) break;
+        const uint32_t size[2] = { level.width, level.height };
+        qint64 bytes = level.blocks.size();
+        written = file.write(reinterpret_cast<const char*>(size), sizeof(size)) == sizeof(size)
+            && file.write(reinterpret_cast<const char*>(level.blocks.data()), bytes) == bytes;
+    }
+    if (!written) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
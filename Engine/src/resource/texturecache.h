@@ -0,0 +1,42 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#ifndef TEXTURECACHE_H
+#define TEXTURECACHE_H
+
+#include <resource/importers.h>
+
+// On-disk cache of compressed textures, so each image is only decoded and block compressed once.
+// Entries are named by a hash of the source file's contents and the compression settings, like the
+// MeshCache's, and hold the format, the PSNR it was compressed at and every level of the mip chain.
+// The cache lives next to the MeshCache's in the user's cache directory; deleting it is always safe.
+class TextureCache {
+public:
+    // Identifies the file's current contents compressed with the given settings.
+    // Returns an empty key if the file can't be read.
+    static std::string GetKey(const std::string& path, const std::string& settings);
+
+    // Fills data's size, format, PSNR and levels from the entry for key.
+    // Returns false, leaving data as it was, if there isn't a valid one.
+    static bool Load(const std::string& key, Importers::ImageData& data);
+
+    // Writes data's compressed levels as the entry for key. Returns false if the entry couldn't be written.
+    static bool Store(const std::string& key, const Importers::ImageData& data);
+
+    static std::string GetDirectory();
+
+private:
+    static const uint32_t MAGIC;
+    static const uint32_t VERSION;
+    // Bounds on what a valid entry can hold, checked before anything is allocated for it
+    static const uint32_t MAX_SIZE;
+    static const uint32_t MAX_LEVELS;
+};
+
+#endif // TEXTURECACHE_H
@@ -0,0 +1,290 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#include "texturecompression.h"
+#include <parallelfor.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+static uint16_t PackColor565(const float color[3]) {
+    int r = std::min(std::max(int(color[0] * 31.0f / 255.0f + 0.5f), 0), 31);
+    int g = std::min(std::max(int(color[1] * 63.0f / 255.0f + 0.5f), 0), 63);
+    int b = std::min(std::max(int(color[2] * 31.0f / 255.0f + 0.5f), 0), 31);
+    return (r << 11) | (g << 5) | b;
+}
+
+static void UnpackColor565(uint16_t packed, unsigned char* rgba) {
+    unsigned int r = (packed >> 11) & 31;
+    unsigned int g = (packed >> 5) & 63;
+    unsigned int b = packed & 31;
+    rgba[0] = (r << 3) | (r >> 2);
+    rgba[1] = (g << 2) | (g >> 4);
+    rgba[2] = (b << 3) | (b >> 2);
+    rgba[3] = 255;
+}
+
+TextureFormat TextureCompression::ChooseFormat(const unsigned char* rgba, unsigned int width, unsigned int height) {
+    size_t pixels = (size_t) width * height;
+    for (size_t i = 0; i < pixels; i++) {
+        if (rgba[4 * i + 3] != 255) return TextureFormat::BC3;
+    }
+    return TextureFormat::BC1;
+}
+
+std::vector<TextureLevel> TextureCompression::CompressMipChain(const unsigned char* rgba, unsigned int width, unsigned int height, TextureFormat format) {
+    std::vector<TextureLevel> levels;
+    std::vector<unsigned char> mip;
+    const unsigned char* current = rgba;
+    while (true) {
+        levels.emplace_back();
+        CompressLevel(current, width, height, format, levels.back());
+        if (width == 1 && height == 1) break;
+
+        // Each pixel of the next level averages a 2x2 square of this one
+        unsigned int next_width = std::max(width / 2, 1u);
+        unsigned int next_height = std::max(height / 2, 1u);
+        std::vector<unsigned char> next((size_t) next_width * next_height * 4);
+        ParallelFor(next_height, BLOCK_ROWS_PER_TASK * 4, [&](size_t begin, size_t end) {
+            for (size_t y = begin; y < end; y++) {
+                size_t y0 = std::min<size_t>(2 * y, height - 1);
+                size_t y1 = std::min<size_t>(2 * y + 1, height - 1);
+                for (size_t x = 0; x < next_width; x++) {
+                    size_t x0 = std::min<size_t>(2 * x, width - 1);
+                    size_t x1 = std::min<size_t>(2 * x + 1, width - 1);
+                    for (int ch = 0; ch < 4; ch++) {
+                        unsigned int sum = current[(y0 * width + x0) * 4 + ch] + current[(y0 * width + x1) * 4 + ch] +
+                                           current[(y1 * width + x0) * 4 + ch] + current[(y1 * width + x1) * 4 + ch];
+                        next[(y * next_width + x) * 4 + ch] = (sum + 2) / 4;
+                    }
+                }
+            }
+        });
+        mip.swap(next);
+        current = mip.data();
+        width = next_width;
+        height = next_height;
+    }
+    return levels;
+}
+
+void TextureCompression::CompressLevel(const unsigned char* rgba, unsigned int width, unsigned int height, TextureFormat format, TextureLevel& level) {
+    size_t blocks_wide = (width + 3) / 4;
+    size_t blocks_high = (height + 3) / 4;
+    level.width = width;
+    level.height = height;
+    level.blocks.resize(blocks_wide * blocks_high * BlockBytes(format));
+    ParallelFor(blocks_high, BLOCK_ROWS_PER_TASK, [&](size_t begin, size_t end) {
+        unsigned char block[64];
+        for (size_t by = begin; by < end; by++) {
+            for (size_t bx = 0; bx < blocks_wide; bx++) {
+                // Gather the block bottom row first, repeating the last row and column past the edges
+                for (size_t py = 0; py < 4; py++) {
+                    size_t y = height - 1 - std::min<size_t>(by * 4 + py, height - 1);
+                    for (size_t px = 0; px < 4; px++) {
+                        size_t x = std::min<size_t>(bx * 4 + px, width - 1);
+                        memcpy(&block[(py * 4 + px) * 4], &rgba[(y * width + x) * 4], 4);
+                    }
+                }
+                unsigned char* out = &level.blocks[(by * blocks_wide + bx) * BlockBytes(format)];
+                if (format == TextureFormat::BC3) {
+                    EncodeAlphaBlock(block, out);
+                    out += 8;
+                }
+                EncodeColorBlock(block, out);
+            }
+        }
+    });
+}
+
+// Picks endpoints at the extremes of the colors along their principal axis, then the nearest blend for each pixel
+void TextureCompression::EncodeColorBlock(const unsigned char block[64], unsigned char* out) {
+    float mean[3] = {0.0f, 0.0f, 0.0f};
+    for (int i = 0; i < 16; i++) {
+        for (int ch = 0; ch < 3; ch++) mean[ch] += block[4 * i + ch] / 16.0f;
+    }
+    float covariance[6] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    for (int i = 0; i < 16; i++) {
+        float r = block[4 * i] - mean[0];
+        float g = block[4 * i + 1] - mean[1];
+        float b = block[4 * i + 2] - mean[2];
+        covariance[0] += r * r;
+        covariance[1] += r * g;
+        covariance[2] += r * b;
+        covariance[3] += g * g;
+        covariance[4] += g * b;
+        covariance[5] += b * b;
+    }
+    // A few steps of power iteration find the principal axis well enough
+    float axis[3] = {1.0f, 1.0f, 1.0f};
+    for (int iteration = 0; iteration < 8; iteration++) {
+        float next[3] = {
+            covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2],
+            covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2],
+            covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2]
+        };
+        float length = std::max(std::max(std::fabs(next[0]), std::fabs(next[1])), std::fabs(next[2]));
+        if (length == 0.0f) break;
+        for (int ch = 0; ch < 3; ch++) axis[ch] = next[ch] / length;
+    }
+    float axis_length2 = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+    float low = 0.0f;
+    float high = 0.0f;
+    for (int i = 0; i < 16; i++) {
+        float t = 0.0f;
+        for (int ch = 0; ch < 3; ch++) t += (block[4 * i + ch] - mean[ch]) * axis[ch];
+        t /= axis_length2;
+        low = std::min(low, t);
+        high = std::max(high, t);
+    }
+    float end0[3];
+    float end1[3];
+    for (int ch = 0; ch < 3; ch++) {
+        end0[ch] = mean[ch] + high * axis[ch];
+        end1[ch] = mean[ch] + low * axis[ch];
+    }
+    uint16_t color0 = PackColor565(end0);
+    uint16_t color1 = PackColor565(end1);
+    // color0 > color1 selects the four color mode
+    if (color0 < color1) std::swap(color0, color1);
+    memcpy(out, &color0, 2);
+    memcpy(out + 2, &color1, 2);
+
+    uint32_t indices = 0;
+    if (color0 != color1) {
+        unsigned char palette[4][4];
+        DecodeColorBlock(out, true, palette);
+        for (int i = 0; i < 16; i++) {
+            int best = 0;
+            int best_distance = std::numeric_limits<int>::max();
+            for (int p = 0; p < 4; p++) {
+                int distance = 0;
+                for (int ch = 0; ch < 3; ch++) {
+                    int d = int(block[4 * i + ch]) - palette[p][ch];
+                    distance += d * d;
+                }
+                if (distance < best_distance) {
+                    best = p;
+                    best_distance = distance;
+                }
+            }
+            indices |= uint32_t(best) << (2 * i);
+        }
+    }
+    memcpy(out + 4, &indices, 4);
+}
+
+void TextureCompression::EncodeAlphaBlock(const unsigned char block[64], unsigned char* out) {
+    unsigned char alpha0 = 0;
+    unsigned char alpha1 = 255;
+    for (int i = 0; i < 16; i++) {
+        alpha0 = std::max(alpha0, block[4 * i + 3]);
+        alpha1 = std::min(alpha1, block[4 * i + 3]);
+    }
+    // alpha0 > alpha1 selects eight interpolated alphas
+    out[0] = alpha0;
+    out[1] = alpha1;
+    uint64_t indices = 0;
+    if (alpha0 != alpha1) {
+        unsigned char palette[8];
+        DecodeAlphaBlock(out, palette);
+        for (int i = 0; i < 16; i++) {
+            int best = 0;
+            for (int p = 1; p < 8; p++) {
+                if (std::abs(int(block[4 * i + 3]) - palette[p]) < std::abs(int(block[4 * i + 3]) - palette[best])) best = p;
+            }
+            indices |= uint64_t(best) << (3 * i);
+        }
+    }
+    for (int k = 0; k < 6; k++) out[2 + k] = (indices >> (8 * k)) & 0xFF;
+}
+
+void TextureCompression::DecodeColorBlock(const unsigned char* in, bool four_colors, unsigned char palette[4][4]) {
+    uint16_t color0;
+    uint16_t color1;
+    memcpy(&color0, in, 2);
+    memcpy(&color1, in + 2, 2);
+    UnpackColor565(color0, palette[0]);
+    UnpackColor565(color1, palette[1]);
+    if (four_colors || color0 > color1) {
+        for (int ch = 0; ch < 3; ch++) {
+            palette[2][ch] = (2 * palette[0][ch] + palette[1][ch]) / 3;
+            palette[3][ch] = (palette[0][ch] + 2 * palette[1][ch]) / 3;
+        }
+        palette[2][3] = 255;
+        palette[3][3] = 255;
+    } else {
+        for (int ch = 0; ch < 3; ch++) palette[2][ch] = (palette[0][ch] + palette[1][ch]) / 2;
+        palette[2][3] = 255;
+        memset(palette[3], 0, 4);
+    }
+}
+
+void TextureCompression::DecodeAlphaBlock(const unsigned char* in, unsigned char palette[8]) {
+    unsigned int alpha0 = in[0];
+    unsigned int alpha1 = in[1];
+    palette[0] = alpha0;
+    palette[1] = alpha1;
+    if (alpha0 > alpha1) {
+        for (unsigned int i = 1; i < 7; i++) palette[i + 1] = ((7 - i) * alpha0 + i * alpha1) / 7;
+    } else {
+        for (unsigned int i = 1; i < 5; i++) palette[i + 1] = ((5 - i) * alpha0 + i * alpha1) / 5;
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+void TextureCompression::DecodeTexel(TextureFormat format, const TextureLevel& level, unsigned int x, unsigned int y, unsigned char* rgba) {
+    unsigned int row = level.height - 1 - y;
+    size_t blocks_wide = (level.width + 3) / 4;
+    const unsigned char* block = &level.blocks[((row / 4) * blocks_wide + x / 4) * BlockBytes(format)];
+    unsigned int i = (row % 4) * 4 + x % 4;
+
+    const unsigned char* color_block = format == TextureFormat::BC3 ? block + 8 : block;
+    unsigned char palette[4][4];
+    DecodeColorBlock(color_block, format == TextureFormat::BC3, palette);
+    uint32_t indices;
+    memcpy(&indices, color_block + 4, 4);
+    memcpy(rgba, palette[(indices >> (2 * i)) & 3], 4);
+
+    if (format == TextureFormat::BC3) {
+        unsigned char alphas[8];
+        DecodeAlphaBlock(block, alphas);
+        uint64_t alpha_indices = 0;
+        for (int k = 0; k < 6; k++) alpha_indices |= uint64_t(block[2 + k]) << (8 * k);
+        rgba[3] = alphas[(alpha_indices >> (3 * i)) & 7];
+    }
+}
+
+std::vector<unsigned char> TextureCompression::Decompress(TextureFormat format, const TextureLevel& level) {
+    std::vector<unsigned char> rgba((size_t) level.width * level.height * 4);
+    ParallelFor(level.height, BLOCK_ROWS_PER_TASK * 4, [&](size_t begin, size_t end) {
+        for (size_t y = begin; y < end; y++) {
+            for (size_t x = 0; x < level.width; x++) DecodeTexel(format, level, x, y, &rgba[(y * level.width + x) * 4]);
+        }
+    });
+    return rgba;
+}
+
+double TextureCompression::PSNR(const unsigned char* original, const unsigned char* decoded, unsigned int width, unsigned int height, TextureFormat format) {
+    int channels = format == TextureFormat::BC1 ? 3 : 4;
+    size_t pixels = (size_t) width * height;
+    double squared_error = 0.0;
+    for (size_t i = 0; i < pixels; i++) {
+        for (int ch = 0; ch < channels; ch++) {
+            double d = double(original[4 * i + ch]) - decoded[4 * i + ch];
+            squared_error += d * d;
+        }
+    }
+    double mse = squared_error / (pixels * channels);
+    if (mse == 0.0) return std::numeric_limits<double>::infinity();
+    return 10.0 * std::log10(255.0 * 255.0 / mse);
+}
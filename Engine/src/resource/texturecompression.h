@@ -0,0 +1,59 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#ifndef TEXTURECOMPRESSION_H
+#define TEXTURECOMPRESSION_H
+
+#include <vector>
+#include <cstddef>
+#include <enum.h>
+
+// One level of a block compressed mip chain
+struct TextureLevel {
+    unsigned int width = 0;
+    unsigned int height = 0;
+    std::vector<unsigned char> blocks;
+};
+
+// CPU encoder and decoder for the block compressed formats OpenGL can sample directly (S3TC).
+// Each 4x4 block of pixels stores two endpoint colors and a 2 bit index per pixel picking a blend of them;
+// BC3 adds a block of 8 bit alpha endpoints with 3 bit indices. BC1 takes 1/8 of the memory of RGBA8, BC3 1/4.
+class TextureCompression {
+public:
+    // BC1 if every pixel is opaque, BC3 otherwise
+    static TextureFormat ChooseFormat(const unsigned char* rgba, unsigned int width, unsigned int height);
+
+    // Compresses the RGBA image and each of its mipmaps down to 1x1, largest first.
+    // Levels are stored bottom row first, the way OpenGL expects them, so they upload as they are.
+    static std::vector<TextureLevel> CompressMipChain(const unsigned char* rgba, unsigned int width, unsigned int height, TextureFormat format);
+
+    // Decodes the pixel at (x, y), counted from the top left like the uncompressed image, into rgba
+    static void DecodeTexel(TextureFormat format, const TextureLevel& level, unsigned int x, unsigned int y, unsigned char* rgba);
+    // Decodes the whole level back into an RGBA image, top row first
+    static std::vector<unsigned char> Decompress(TextureFormat format, const TextureLevel& level);
+
+    // Peak signal to noise ratio (in dB) between two RGBA images, over the channels the format stores
+    static double PSNR(const unsigned char* original, const unsigned char* decoded, unsigned int width, unsigned int height, TextureFormat format);
+
+    static size_t BlockBytes(TextureFormat format) { return format == TextureFormat::BC1 ? 8 : 16; }
+    static size_t LevelBytes(TextureFormat format, unsigned int width, unsigned int height) {
+        return ((width + 3) / 4) * ((height + 3) / 4) * BlockBytes(format);
+    }
+
+private:
+    static const size_t BLOCK_ROWS_PER_TASK = 16;
+
+    static void CompressLevel(const unsigned char* rgba, unsigned int width, unsigned int height, TextureFormat format, TextureLevel& level);
+    static void EncodeColorBlock(const unsigned char block[64], unsigned char* out);
+    static void EncodeAlphaBlock(const unsigned char block[64], unsigned char* out);
+    static void DecodeColorBlock(const unsigned char* in, bool four_colors, unsigned char palette[4][4]);
+    static void DecodeAlphaBlock(const unsigned char* in, unsigned char palette[8]);
+};
+
+#endif // TEXTURECOMPRESSION_H
@@ -22,6 +22,8 @@ struct DebugRay {
 
 class Camera : public Component {
 public:
+    COMPONENT_SLOT(Camera)
+
     // Camera Properties
     IntProperty RenderWidth;
     IntProperty RenderHeight;
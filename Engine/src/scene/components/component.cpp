@@ -27,6 +27,10 @@ std::type_index Component::GetBaseType() const {
     return GetMetaComponent()->BaseType;
 }
 
+ComponentSlot Component::GetSlot() const {
+    return GetMetaComponent()->Slot;
+}
+
 MetaComponent const* Component::GetMetaComponent() const {
     MetaComponent* meta = (*typeinfo_registry_)[std::type_index(typeid(*this))];
     assert(meta != nullptr);
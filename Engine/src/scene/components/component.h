@@ -17,14 +17,38 @@
 
 #include <QDebug>
 
+// Every base component type gets a fixed slot in a SceneObject, which can hold at most one
+// component per slot. Derived types share their base's slot (e.g. Sphere and TriangleMesh are
+// both Geometry), so looking a component up is just indexing an array.
+enum class ComponentSlot : unsigned int {
+    Transform,
+    Geometry,
+    Light,
+    Camera,
+    ParticleSystem,
+    SphereCollider,
+    PlaneCollider,
+    CylinderCollider,
+    EnvironmentMap,
+    RobotArmProp,
+    CustomProp,
+    Count
+};
+
+// Declares the slot of a base component type. Place in the public section of the class.
+#define COMPONENT_SLOT(ClassName_) \
+    static const ComponentSlot SLOT = ComponentSlot::ClassName_; \
+    typedef ClassName_ SlotType;
+
 class MetaComponent {
   public:
-    MetaComponent(std::string const ClassName_, std::type_index const BaseClass_, std::string const BaseClassName_) :
-        TypeName(ClassName_), BaseType(BaseClass_), BaseTypeName(BaseClassName_) {}
+    MetaComponent(std::string const ClassName_, std::type_index const BaseClass_, std::string const BaseClassName_, ComponentSlot const Slot_) :
+        TypeName(ClassName_), BaseType(BaseClass_), BaseTypeName(BaseClassName_), Slot(Slot_) {}
     virtual Component* Create() const = 0;
     std::string const TypeName;
     std::type_index const BaseType;
     std::string const BaseTypeName;
+    ComponentSlot const Slot;
 };
 
 class Component : public ObjectWithProperties {
@@ -37,6 +61,7 @@ public:
     }
 
     std::type_index GetBaseType() const;
+    ComponentSlot GetSlot() const;
     template<typename T> static std::type_index const GetBaseType() {
         if (typeinfo_registry_->find(std::type_index(typeid(T))) == typeinfo_registry_->end()) {
             return std::type_index(typeid(T)); // it is a virtual type, so it is the base type
@@ -79,7 +104,7 @@ protected:
 #define REGISTER_COMPONENT(ClassName_, BaseClass_) \
 class Meta##ClassName_##Component : public MetaComponent { \
     public: \
-        Meta##ClassName_##Component() : MetaComponent(#ClassName_, std::type_index(typeid(BaseClass_)), #BaseClass_) { \
+        Meta##ClassName_##Component() : MetaComponent(#ClassName_, std::type_index(typeid(BaseClass_)), #BaseClass_, ClassName_::SLOT) { \
             Component::Register<ClassName_>(this); \
         } \
         Component* Create() const { \
@@ -6,6 +6,8 @@
 class CustomProp : public Component
 {
 public:
+    COMPONENT_SLOT(CustomProp)
+
     CustomProp();
 
     void SetRoot(SceneObject *p_root){ mp_root = p_root; }
@@ -280,10 +280,13 @@ std::unique_ptr<Mesh> Cylinder::CreateMesh(unsigned int subdivisions) {
     }
 
     // Set the data on the mesh
-    mesh->SetPositions(vertices);
-    mesh->SetNormals(normals);
-    mesh->SetUVs(UVs);
-    mesh->SetTriangles(triangles);
+    {
+        MeshEdit edit(*mesh);
+        edit.SetPositions(std::move(vertices));
+        edit.SetNormals(std::move(normals));
+        edit.SetUVs(std::move(UVs));
+        edit.SetTriangles(std::move(triangles));
+    }
 
     return std::move(mesh);
 }
@@ -14,6 +14,8 @@
 
 class CylinderCollider : public Component {
 public:
+    COMPONENT_SLOT(CylinderCollider)
+
     DoubleProperty Diameter;
     DoubleProperty Height;
     DoubleProperty Restitution;
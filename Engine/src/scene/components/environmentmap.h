@@ -16,6 +16,8 @@
 
 class EnvironmentMap : public Component {
 public:
+    COMPONENT_SLOT(EnvironmentMap)
+
     IntProperty Resolution;
     DoubleProperty NearPlane;
     DoubleProperty FarPlane;
@@ -20,6 +20,8 @@
 class Geometry : public Component
 {
 public:
+    COMPONENT_SLOT(Geometry)
+
     ResourceProperty<Material> RenderMaterial;
 
     Geometry() : RenderMaterial(AssetType::Material) {
@@ -29,6 +31,8 @@ public:
 
     virtual Mesh* GetEditorMesh() { return GetRenderMesh(); }
     virtual Mesh* GetRenderMesh() = 0;
+    // The render mesh, waiting for any part of it still being built in the background (for tracing and exporting)
+    virtual Mesh* GetCompleteRenderMesh() { return GetRenderMesh(); }
 
     bool HasBoundingBox() {
         return local_bbox != nullptr;
@@ -59,12 +63,6 @@ public:
 
 protected:
     std::unique_ptr<BoundingBox> local_bbox;
-
-private:
-    std::map<int, std::unique_ptr<Mesh>> subdivision_cache;
-    std::map<int, std::unique_ptr<Mesh>> limit_subdivision_cache;
-    uint64_t subdivision_cache_mesh_uid;
-    uint64_t subdivision_cache_mesh_version;
 };
 
 #endif // MESHCOMPONENT_H
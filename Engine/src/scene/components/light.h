@@ -18,6 +18,8 @@
 
 class Light : public Component {
 public:
+    COMPONENT_SLOT(Light)
+
     ColorProperty Ambient;
     ColorProperty Color;
 
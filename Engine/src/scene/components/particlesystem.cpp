@@ -22,6 +22,7 @@ ParticleSystem::ParticleSystem() :
     Period(0.5f, 0.0f, 1.0f, 0.01f),
     ConstantF(glm::vec3(0.0f, -9.8f, 0.0f)),
     DragF(0.0f, 0.0f, 10.0f, 0.01f),
+    Billboards(false),
     constant_force_(ConstantF.Get()),
     // REQUIREMENT:
     // init drag force with DragF -- refer to how we deal with constant_force_
@@ -38,6 +39,7 @@ ParticleSystem::ParticleSystem() :
     AddProperty("Period (s)", &Period);
     AddProperty("Constant Force", &ConstantF);
     AddProperty("Drag Coefficient", &DragF);
+    AddProperty("Billboards", &Billboards);
 
     ParticleGeometry.ValueSet.Connect(this, &ParticleSystem::OnGeometrySet);
 
@@ -91,13 +93,6 @@ void ParticleSystem::EmitParticles() {
     time_to_emit_ = Period.Get();
 }
 
-std::vector<Particle*> ParticleSystem::GetParticles() {
-    // Return a vector of particles (used by renderer to draw them)
-    std::vector<Particle*> particles;
-    for (auto& particle : particles_) particles.push_back(particle.get());
-    return particles;
-}
-
 void ParticleSystem::StartSimulation() {
     simulating_ = true;
     constant_force_.SetForce(ConstantF.Get());
@@ -124,6 +119,7 @@ void ParticleSystem::UpdateSimulation(float delta_t, const std::vector<std::pair
    //      Check for and handle collisions
 
    for (auto& p : particles_) {
+       p->PreviousPosition = p->Position;
 //       p->Velocity;
 //       p->Mass;
 //       p->Position;
@@ -229,6 +225,10 @@ void ParticleSystem::UpdateSimulation(float delta_t, const std::vector<std::pair
    }
 }
 
+void ParticleSystem::InterpolateParticles(float alpha) {
+    for (auto& p : particles_) p->RenderPosition = glm::mix(p->PreviousPosition, p->Position, alpha);
+}
+
 void ParticleSystem::StopSimulation() {
     simulating_ = false;
 }
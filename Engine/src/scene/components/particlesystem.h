@@ -21,9 +21,13 @@ public:
     glm::vec3 Position;
     glm::vec3 Velocity;
     glm::vec3 Rotation;
+    // Position at the start of the last simulation step, and the blend of the two that gets drawn
+    glm::vec3 PreviousPosition;
+    glm::vec3 RenderPosition;
 
     Particle(float mass_ = 1.0f, glm::vec3 position_ = glm::vec3(0,0,0), glm::vec3 velocity_ = glm::vec3(0,0,0), glm::vec3 rotation_ = glm::vec3(0,0,0)) :
-        Mass(mass_), Position(position_), Velocity(velocity_), Rotation(rotation_) { }
+        Mass(mass_), Position(position_), Velocity(velocity_), Rotation(rotation_),
+        PreviousPosition(position_), RenderPosition(position_) { }
 };
 
 class Force {
@@ -49,6 +53,8 @@ private:
 
 class ParticleSystem : public Component {
 public:
+    COMPONENT_SLOT(ParticleSystem)
+
     ChoiceProperty ParticleGeometry;
     ResourceProperty<Material> ParticleMaterial;
     DoubleProperty ParticleScale;
@@ -57,17 +63,19 @@ public:
     Vec3Property InitialVelocity;
     Vec3Property ConstantF;
     DoubleProperty DragF;   // Use this for k_d in viscous drag force
-
-    // EXTRA CREDIT: Allow the user to enable billboards. See glRenderer::Render(SceneObject&, ParticleSystem).
-    // BooleanProperty Billboards;
+    // Rotate particles to always face the camera. See GLRenderer::Render(SceneObject&, ParticleSystem&).
+    BooleanProperty Billboards;
 
     ParticleSystem();
 
     void UpdateModelMatrix(glm::mat4 model_matrix);
     void EmitParticles();
-    std::vector<Particle*> GetParticles();
+    const std::vector<std::unique_ptr<Particle>>& GetParticles() const { return particles_; }
     void StartSimulation();
+    // Advances the simulation by one fixed step of the Scene's SimulationClock
     void UpdateSimulation(float delta_t, const std::vector<std::pair<SceneObject*, glm::mat4>>& colliders);
+    // Sets each particle's RenderPosition to alpha of the way from its previous to its current step
+    void InterpolateParticles(float alpha);
     void StopSimulation();
     void ResetSimulation();
     bool IsSimulating();
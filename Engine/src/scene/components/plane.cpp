@@ -120,10 +120,13 @@ std::unique_ptr<Mesh> Plane::CreateMesh(unsigned int subdivisions) {
     }
 
     // Set the data on the mesh
-    surface->SetPositions(vertices);
-    surface->SetNormals(normals);
-    surface->SetUVs(UVs);
-    surface->SetTriangles(triangles);
+    {
+        MeshEdit edit(*surface);
+        edit.SetPositions(std::move(vertices));
+        edit.SetNormals(std::move(normals));
+        edit.SetUVs(std::move(UVs));
+        edit.SetTriangles(std::move(triangles));
+    }
 
     return std::move(surface);
 }
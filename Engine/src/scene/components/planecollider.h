@@ -14,6 +14,8 @@
 
 class PlaneCollider : public Component {
 public:
+    COMPONENT_SLOT(PlaneCollider)
+
     DoubleProperty Width;
     DoubleProperty Height;
     DoubleProperty Restitution;
@@ -209,10 +209,13 @@ std::unique_ptr<Mesh> Ring::CreateMesh(unsigned int subdivisions, double width)
     }
 
     // Set the data on the mesh
-    mesh->SetPositions(vertices);
-    mesh->SetNormals(normals);
-    mesh->SetUVs(UVs);
-    mesh->SetTriangles(triangles);
+    {
+        MeshEdit edit(*mesh);
+        edit.SetPositions(std::move(vertices));
+        edit.SetNormals(std::move(normals));
+        edit.SetUVs(std::move(UVs));
+        edit.SetTriangles(std::move(triangles));
+    }
 
     return std::move(mesh);
 }
@@ -6,6 +6,8 @@
 class RobotArmProp : public Component
 {
 public:
+    COMPONENT_SLOT(RobotArmProp)
+
     RobotArmProp();
 
     void SetRoot(SceneObject *p_root){ mp_root = p_root; }
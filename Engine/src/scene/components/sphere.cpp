@@ -301,10 +301,13 @@ std::unique_ptr<Mesh> Sphere::CreateMesh(unsigned int subdivisions) {
 
     std::unique_ptr<Mesh> surface = std::make_unique<Mesh>("Sphere");
     // Set the data on the mesh
-    surface->SetPositions(vertices);
-    surface->SetNormals(normals);
-    surface->SetUVs(texCoords);
-    surface->SetTriangles(indices);
+    {
+        MeshEdit edit(*surface);
+        edit.SetPositions(std::move(vertices));
+        edit.SetNormals(std::move(normals));
+        edit.SetUVs(std::move(texCoords));
+        edit.SetTriangles(std::move(indices));
+    }
 
     return std::move(surface);
 }
@@ -418,10 +421,13 @@ std::unique_ptr<Mesh> Sphere::CreateMesh_old(unsigned int subdivisions) {
     }
 
     // Set the data on the mesh
-    surface->SetPositions(vertices);
-    surface->SetNormals(normals);
-    surface->SetUVs(UVs);
-    surface->SetTriangles(triangles);
+    {
+        MeshEdit edit(*surface);
+        edit.SetPositions(std::move(vertices));
+        edit.SetNormals(std::move(normals));
+        edit.SetUVs(std::move(UVs));
+        edit.SetTriangles(std::move(triangles));
+    }
 
     return std::move(surface);
 }
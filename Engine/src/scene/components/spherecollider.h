@@ -14,6 +14,8 @@
 
 class SphereCollider : public Component {
 public:
+    COMPONENT_SLOT(SphereCollider)
+
     DoubleProperty Radius;
     DoubleProperty Restitution;
 
@@ -9,6 +9,8 @@
  ****************************************************************************/
 #include "surfaceofrevolution.h"
 #include <fileio.h>
+#include <parallelfor.h>
+#include <glm/gtc/constants.hpp>
 
 REGISTER_COMPONENT(SurfaceOfRevolution, Geometry)
 
@@ -24,35 +26,126 @@ SurfaceOfRevolution::SurfaceOfRevolution() :
     Quality.ValueSet.Connect(this, &SurfaceOfRevolution::OnQualitySet);
 
     // Add some default points and generate a default mesh
-    static const std::vector<glm::vec2> default_points = {
-        glm::vec2(0.0f, 0.5f),
-        glm::vec2(0.25f, 0.25f),
-        glm::vec2(0.5f, 0.0f),
-        glm::vec2(0.25f, -0.25f),
-        glm::vec2(0.0f, -0.5f)
-    };
-    points_list_.push_back(default_points);
+    static const std::shared_ptr<const RevolutionCache::CurveList> default_points = std::make_shared<const RevolutionCache::CurveList>(
+        RevolutionCache::CurveList{{
+            glm::vec2(0.0f, 0.5f),
+            glm::vec2(0.25f, 0.25f),
+            glm::vec2(0.5f, 0.0f),
+            glm::vec2(0.25f, -0.25f),
+            glm::vec2(0.0f, -0.5f)
+        }});
+    points_list_ = default_points;
     OnQualitySet(Quality.Get());
 }
 
 void SurfaceOfRevolution::OnCurveSet(std::string curve_file) {
-    // Get a list of points indexed by the quality
-    points_list_ = FileIO::ReadCurveFile(curve_file);
+    // Get a list of points indexed by the quality, parsed once for every surface using the file
+    points_list_ = RevolutionCache::Instance().GetCurves(curve_file);
+    curve_file_ = curve_file;
     OnQualitySet(0);
 }
 
 void SurfaceOfRevolution::OnQualitySet(int quality) {
-    if (points_list_.size() == 0) return;
-    if ((unsigned int) Quality.Get() >= points_list_.size()) quality = 0;
-    // Create a new surface of revolution mesh
-    mesh_ = CreateMesh(points_list_[quality], points_list_[quality].size());
+    if (points_list_->size() == 0) return;
+    if ((unsigned int) quality >= points_list_->size()) quality = 0;
+    if (curve_file_.empty()) {
+        const std::vector<glm::vec2>& points = (*points_list_)[quality];
+        mesh_ = CreateMesh(points, points.size());
+        return;
+    }
+    // Reuse the mesh made for this quality of the curve file, if there is one
+    mesh_ = RevolutionCache::Instance().GetMesh(curve_file_, quality, [this](const std::vector<glm::vec2>& points) {
+        return CreateMesh(points, points.size());
+    });
+}
+
+// Signed area of the region between the curve and the Y axis: the curve closed back to its start through the axis
+// points (0, back.y) and (0, front.y). Positive when that region is traced counterclockwise.
+static double AreaToAxis(const std::vector<glm::vec2>& points) {
+    const glm::vec2& front = points.front();
+    const glm::vec2& back = points.back();
+    double area = back.x * back.y - front.x * front.y;
+    for (size_t i = 0; i + 1 < points.size(); i++) {
+        area += points[i].x * points[i + 1].y - points[i + 1].x * points[i].y;
+    }
+    return area;
 }
 
 // Transfers ownership of a new Surface of Revolution Mesh to the caller
 std::unique_ptr<Mesh> SurfaceOfRevolution::CreateMesh(const std::vector<glm::vec2>& curve_points, unsigned int subdivisions) {
     std::unique_ptr<Mesh> surface = std::make_unique<Mesh>("Surface of Revolution");
+    size_t count = curve_points.size();
+    if (count < 2) return std::move(surface);
+    subdivisions = std::max(subdivisions, 3u);
+
+    // The curve is revolved about the Y axis, with x as the radius. Normals point out of the region between the curve
+    // and the axis, whichever way the curve runs: its signed area, closed along the axis, says which side that is.
+    double area = AreaToAxis(curve_points);
+    bool clockwise = area <= 0.0;
+
+    // Each point's normal in the plane of the curve and its V coordinate (by arc length) are the same on every ring
+    std::vector<glm::vec2> curve_normals(count);
+    std::vector<float> curve_v(count, 0.0f);
+    for (size_t i = 0; i < count; i++) {
+        glm::vec2 tangent = curve_points[std::min(i + 1, count - 1)] - curve_points[i > 0 ? i - 1 : 0];
+        glm::vec2 normal = clockwise ? glm::vec2(-tangent.y, tangent.x) : glm::vec2(tangent.y, -tangent.x);
+        float length = glm::length(normal);
+        curve_normals[i] = length > 0.0f ? normal / length : glm::vec2(1.0f, 0.0f);
+        if (i > 0) curve_v[i] = curve_v[i - 1] + glm::length(curve_points[i] - curve_points[i - 1]);
+    }
+    for (size_t i = 1; i < count; i++) {
+        curve_v[i] = curve_v[count - 1] > 0.0f ? curve_v[i] / curve_v[count - 1] : float(i) / (count - 1);
+    }
+
+    // One ring of vertices per angle, with the first ring repeated at the end so the seam gets U = 1.
+    // Rings are independent, so they are generated in parallel, each task writing only its own rings' vertices and faces.
+    size_t rings = subdivisions + 1;
+    std::vector<float> positions(rings * count * 3);
+    std::vector<float> normals(rings * count * 3);
+    std::vector<float> uvs(rings * count * 2);
+    std::vector<unsigned int> faces(subdivisions * (count - 1) * 6);
+    ParallelFor(rings, std::max(VERTICES_PER_TASK / count, (size_t) 1), [&](size_t begin, size_t end) {
+        for (size_t ring = begin; ring < end; ring++) {
+            float u = float(ring) / subdivisions;
+            float angle = glm::two_pi<float>() * u;
+            float c = std::cos(angle);
+            float s = std::sin(angle);
+            for (size_t i = 0; i < count; i++) {
+                size_t v = ring * count + i;
+                positions[3 * v] = curve_points[i].x * c;
+                positions[3 * v + 1] = curve_points[i].y;
+                positions[3 * v + 2] = -curve_points[i].x * s;
+                normals[3 * v] = curve_normals[i].x * c;
+                normals[3 * v + 1] = curve_normals[i].y;
+                normals[3 * v + 2] = -curve_normals[i].x * s;
+                uvs[2 * v] = u;
+                uvs[2 * v + 1] = curve_v[i];
+            }
+            if (ring == subdivisions) continue;
 
-    // Modeler: Compute and set vertex positions, normals, UVs, and triangle faces
+            // Two triangles per segment between this ring and the next, wound to face the way the normals do
+            for (size_t i = 0; i + 1 < count; i++) {
+                unsigned int a = ring * count + i;
+                unsigned int b = a + count;
+                unsigned int* face = &faces[(ring * (count - 1) + i) * 6];
+                if (clockwise) {
+                    face[0] = a; face[1] = b + 1; face[2] = b;
+                    face[3] = a; face[4] = a + 1; face[5] = b + 1;
+                } else {
+                    face[0] = a; face[1] = b; face[2] = b + 1;
+                    face[3] = a; face[4] = b + 1; face[5] = a + 1;
+                }
+            }
+        }
+    });
 
+    // Set them together with a MeshEdit, moving the vectors in, so tangents are only computed once
+    {
+        MeshEdit edit(*surface);
+        edit.SetPositions(std::move(positions));
+        edit.SetNormals(std::move(normals));
+        edit.SetUVs(std::move(uvs));
+        edit.SetTriangles(std::move(faces));
+    }
     return std::move(surface);
 }
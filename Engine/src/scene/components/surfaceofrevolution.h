@@ -12,6 +12,7 @@
 
 #include <properties.h>
 #include <scene/components/geometry.h>
+#include <resource/revolutioncache.h>
 
 class SurfaceOfRevolution : public Geometry {
 public:
@@ -26,8 +27,14 @@ protected:
     void OnCurveSet(std::string curve_file);
     void OnQualitySet(int quality);
     std::unique_ptr<Mesh> CreateMesh(const std::vector<glm::vec2> &curve_points, unsigned int subdivisions);
-    std::unique_ptr<Mesh> mesh_;
-    std::vector<std::vector<glm::vec2>> points_list_;
+    // Shared with other surfaces of the same curve file through the RevolutionCache
+    std::shared_ptr<Mesh> mesh_;
+    std::shared_ptr<const RevolutionCache::CurveList> points_list_;
+    // Empty while showing the default curve
+    std::string curve_file_;
+
+    // Vertices each task generates when rings are generated in parallel
+    static const size_t VERTICES_PER_TASK = 4096;
 };
 
 #endif // SURFACEOFREVOLUTION_H
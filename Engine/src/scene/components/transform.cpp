@@ -10,6 +10,7 @@
 #include "transform.h"
 #include <glm/gtx/matrix_decompose.hpp>
 #include <meshprocessing.h>
+#include <scene/transformbatch.h>
 
 REGISTER_COMPONENT(Transform, Transform)
 
@@ -17,6 +18,7 @@ Transform::Transform() :
     Translation(),
     Rotation(),
     Scale(glm::vec3(1.0f, 1.0f, 1.0f)),
+    matrix_stale_(true),
     matrix_override_(false),
     tracking_vertex_of_(nullptr),
     tracking_vertex_id_(0)
@@ -25,12 +27,17 @@ Transform::Transform() :
     AddProperty("Rotation", &Rotation);
     AddProperty("Scale", &Scale);
 
-    Translation.ValueChanged.Connect(this, &Transform::Update);
-    Scale.ValueChanged.Connect(this, &Transform::Update);
-    Rotation.ValueChanged.Connect(this, &Transform::Update);
+    Translation.ValueChanged.Connect(this, &Transform::OnTRSChanged);
+    Scale.ValueChanged.Connect(this, &Transform::OnTRSChanged);
+    Rotation.ValueChanged.Connect(this, &Transform::OnTRSChanged);
+}
+
+Transform::~Transform() {
+    PropertyBatch::Cancel(this);
 }
 
 void Transform::CopyFrom(const Transform& transform) {
+    PropertyBatch batch;
     Translation.Set(transform.Translation.Get());
     Rotation.Set(transform.Rotation.Get());
     Scale.Set(transform.Scale.Get());
@@ -41,6 +48,7 @@ void Transform::SetFromMatrix(glm::mat4 m) {
     glm::vec4 perspective;
     glm::quat orientation;
     glm::decompose(m, scale, orientation, translation, skew, perspective);
+    PropertyBatch batch;
     Translation.Set(translation);
     Scale.Set(scale);
     Rotation.Set(glm::degrees(-glm::eulerAngles(orientation)));
@@ -49,20 +57,30 @@ void Transform::SetFromMatrix(glm::mat4 m) {
 void Transform::ForceMatrix(glm::mat4 m) {
     matrix_override_ = true;
     matrix_ = m;
+    MatrixChanged.Emit();
 }
 
 glm::mat4 Transform::GetMatrix() const {
     if (matrix_override_) return matrix_;
-    else return cached_;
+    if (matrix_stale_) {
+        cached_ = TransformBatch::Compose(Translation.Get(), Rotation.Get(), Scale.Get());
+        matrix_stale_ = false;
+    }
+    return cached_;
 }
 
-void Transform::Update(glm::vec3) {
+glm::mat4 Transform::GetRotationMatrix() const {
+    return glm::eulerAngleXYZ(glm::radians(Rotation.Get().x), glm::radians(Rotation.Get().y), glm::radians(Rotation.Get().z));
+}
+
+void Transform::OnTRSChanged(glm::vec3) {
+    PropertyBatch::Defer(this, [this] () { Update(); });
+}
 
-    glm::mat4 translate = glm::translate(glm::mat4(), Translation.Get());
-    glm::mat4 rotate = glm::eulerAngleXYZ(glm::radians(Rotation.Get().x), glm::radians(Rotation.Get().y), glm::radians(Rotation.Get().z));
-    rotation_ = glm::quat_cast(rotate);
-    glm::mat4 scale = glm::scale(glm::mat4(), Scale.Get());
-    cached_ = translate * rotate * scale;
+void Transform::Update() {
+    // The matrix itself is composed lazily, usually along with every other stale transform in the scene
+    matrix_stale_ = true;
+    MatrixChanged.Emit();
 
     //Ensure mesh is valid?
     if (tracking_vertex_of_) {
@@ -72,7 +90,7 @@ void Transform::Update(glm::vec3) {
         new_pos_vector[tracking_vertex_id_*3+1] = Translation.Get().y;
         new_pos_vector[tracking_vertex_id_*3+2] = Translation.Get().z;
 
-        tracking_vertex_of_->SetPositions(new_pos_vector);
+        tracking_vertex_of_->SetPositions(std::move(new_pos_vector));
         MeshProcessing::ComputeNormals(*tracking_vertex_of_);
     }
 }
@@ -91,7 +109,7 @@ void Transform::SetVertexTracking(Mesh* mesh, int vertex) {
 void Transform::Translate(glm::vec3 translation, Space relative_frame) {
     if (relative_frame == Space::Local) {
         // This basically rotates the translation so it's applied locally
-        translation = (glm::toMat4(rotation_) * glm::vec4(translation, 1.0)).xyz;
+        translation = (GetRotationMatrix() * glm::vec4(translation, 1.0)).xyz;
     }
 
     glm::mat4 matrix = glm::translate(glm::mat4(), Translation.Get());
@@ -18,11 +18,14 @@ class Mesh;
 
 class Transform : public Component {
 public:
+    COMPONENT_SLOT(Transform)
+
     Vec3Property Translation;
     Vec3Property Rotation;
     Vec3Property Scale;
 
     Transform();
+    ~Transform();
     void CopyFrom(const Transform& transform);
 
     // Sets the translation, rotation, and scale based on the given transformation matrix
@@ -31,6 +34,11 @@ public:
 
     // Returns the post-multiplied transformation matrix
     glm::mat4 GetMatrix() const;
+    // Whether the matrix is out of date with Translation, Rotation and Scale. The scene recomposes
+    // stale matrices in bulk each frame; GetMatrix recomposes one on demand.
+    bool IsMatrixStale() const { return matrix_stale_ && !matrix_override_; }
+    // Takes a matrix composed from the current Translation, Rotation and Scale
+    void SetComposedMatrix(const glm::mat4& m) { cached_ = m; matrix_stale_ = false; }
 
     // Applies a translation <X, Y, Z> relative to either Local Space or World Space
     void Translate(glm::vec3 translation, Space relative_frame = Space::Local);
@@ -50,21 +58,26 @@ public:
     }
 
     glm::vec3 GetForward() {
-        return glm::normalize(rotation_ * glm::vec3(0,0,1));
+        return glm::normalize(glm::vec3(GetRotationMatrix() * glm::vec4(0,0,1,0)));
     }
 
     void SetVertexTracking(Mesh* mesh, int vertex);
+
+    // Emitted whenever the value returned by GetMatrix changes
+    Signal0<> MatrixChanged;
 private:
-    // Store the rotation as a quaternion for easier math
-    glm::quat rotation_;
     glm::mat4 matrix_;
-    glm::mat4 cached_;
+    mutable glm::mat4 cached_;
+    mutable bool matrix_stale_;
     bool matrix_override_;
 
     Mesh* tracking_vertex_of_;
     int tracking_vertex_id_;
 
-    void Update(glm::vec3);
+    // Recomputes the matrix once all of the properties changed in the current PropertyBatch are set
+    void OnTRSChanged(glm::vec3);
+    void Update();
+    glm::mat4 GetRotationMatrix() const;
 };
 
 #endif // TRANSFORM_H
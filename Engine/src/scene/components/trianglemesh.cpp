@@ -1,6 +1,6 @@
 #include "trianglemesh.h"
 
-#include <meshprocessing.h>
+#include <resource/subdivisioncache.h>
 
 REGISTER_COMPONENT(TriangleMesh, Geometry)
 
@@ -18,47 +18,13 @@ Mesh* TriangleMesh::GetEditorMesh() {
 }
 
 Mesh* TriangleMesh::GetRenderMesh() {
-    if(MeshFilter.Get()==nullptr) {
-        return nullptr;
-    }
-
-    uint64_t cur_uid = MeshFilter.Get()->GetUID();
-    uint64_t cur_ver = MeshFilter.Get()->GetVersion();
-
-    if (cur_uid != subdivision_cache_mesh_uid || cur_ver != subdivision_cache_mesh_version) {
-        subdivision_cache.clear();
-        limit_subdivision_cache.clear();
-        subdivision_cache_mesh_uid = cur_uid;
-        subdivision_cache_mesh_version = cur_ver;
-    }
-
-    int subdivisions = LoopSubdivision.Get();
-
-    if (subdivisions==0) {
-        return MeshFilter.Get();
-    }
-
-    int current_subdivision = 1;
-
-    while (current_subdivision < subdivisions) {
-        if (subdivision_cache.find(current_subdivision) == subdivision_cache.end()) {
-            subdivision_cache[current_subdivision] = std::make_unique<Mesh>(MeshFilter.Get()->GetName()+" subdivision"+std::to_string(current_subdivision), MeshType::Triangles);
-            MeshProcessing::SubdivideMesh(current_subdivision == 1 ?
-                                              *(MeshFilter.Get()) :
-                                              *(subdivision_cache[current_subdivision-1]),
-                    *(subdivision_cache[current_subdivision]));
-        }
-        current_subdivision++;
-    }
-    if (limit_subdivision_cache.find(current_subdivision) == limit_subdivision_cache.end()) {
-        limit_subdivision_cache[current_subdivision] =
-            std::make_unique<Mesh>(MeshFilter.Get()->GetName()+" subdivision"+std::to_string(current_subdivision) + " limit", MeshType::Triangles);
-        MeshProcessing::SubdivideMesh(current_subdivision == 1 ?
-                *(MeshFilter.Get()) :
-                *(subdivision_cache[current_subdivision-1]),
-                *(limit_subdivision_cache[current_subdivision]),
-                true);
-    }
+    Mesh* mesh = MeshFilter.Get();
+    if (mesh == nullptr) return nullptr;
+    return SubdivisionCache::Instance().Get(*mesh, LoopSubdivision.Get());
+}
 
-    return limit_subdivision_cache[subdivisions].get();
+Mesh* TriangleMesh::GetCompleteRenderMesh() {
+    Mesh* mesh = MeshFilter.Get();
+    if (mesh == nullptr) return nullptr;
+    return SubdivisionCache::Instance().Get(*mesh, LoopSubdivision.Get(), true);
 }
@@ -23,13 +23,9 @@ public:
     TriangleMesh();
 
     virtual Mesh* GetEditorMesh();
+    // Subdivisions come from the SubdivisionCache, shared with every other component using the same mesh
     virtual Mesh* GetRenderMesh();
-
-private:
-    std::map<int, std::unique_ptr<Mesh>> subdivision_cache;
-    std::map<int, std::unique_ptr<Mesh>> limit_subdivision_cache;
-    uint64_t subdivision_cache_mesh_uid = 0;
-    uint64_t subdivision_cache_mesh_version = 0;
+    virtual Mesh* GetCompleteRenderMesh();
 };
 
 
@@ -29,7 +29,8 @@ public:
         draw_lights_(true),
         draw_camera_(true),
         draw_colliders_(true),
-        rendering_selection_(false)
+        rendering_selection_(false),
+        wait_for_complete_meshes_(false)
     {}
 
     // Initialize renderer resources (Must only be called once)
@@ -85,6 +86,9 @@ public:
     void SetNodePrefix(std::string prefix="") { node_prefix_ = prefix; }
 
     void SetVertexEditing(bool edit) { vertex_editing_ = edit; }
+    // Renders each geometry's finished mesh, waiting for it if need be, rather than a coarser stand-in while it builds.
+    // For output that has to be exact, like saved frames; interactive views should not wait.
+    void SetWaitForCompleteMeshes(bool wait) { wait_for_complete_meshes_ = wait; }
 protected:
     RenderingMode rendering_mode_;
     std::string node_prefix_;
@@ -96,6 +100,7 @@ protected:
     bool draw_colliders_;
     bool rendering_selection_;
     bool vertex_editing_;
+    bool wait_for_complete_meshes_;
 
     // Do not render this node or its children; used for environment mapping
     void SetIgnoredNode(const SceneObject* ignored) { ignored_node_ = ignored; }
@@ -11,17 +11,43 @@
 #include <scene/scene.h>
 #include <resource/assetmanager.h>
 #include <scene/components/geometry.h>
+#include <QRunnable>
 
 template<> Scene* Singleton<Scene>::_instance_ = nullptr;
 
+static void SampleChannels(const Scene::AnimationChannel* channels, double* values, size_t count, float t) {
+    for (size_t i = 0; i < count; i++) {
+        DoubleProperty* property = channels[i].property;
+        CurveSampler* curve = property->GetCurve();
+        values[i] = curve->GetKeyframesCount() > 0 ? curve->SampleAt(t) : property->Get();
+    }
+}
+
+// Samples a range of animation channels on a worker thread
+class ChannelSampler : public QRunnable {
+public:
+    ChannelSampler(const Scene::AnimationChannel* channels, double* values, size_t count, float t) :
+        channels_(channels), values_(values), count_(count), t_(t) { }
+    virtual void run() override { SampleChannels(channels_, values_, count_, t_); }
+private:
+    const Scene::AnimationChannel* channels_;
+    double* values_;
+    size_t count_;
+    float t_;
+};
+
 Scene::Scene(std::string name, ShaderFactory& shader_factory) :
     Singleton<Scene>(),
     name_(name),
     asset_manager_(shader_factory),
     scene_root_(std::make_unique<SceneObject>("Root")),
+    hierarchy_dirty_(true),
+    channels_dirty_(true),
     render_cam_(nullptr),
     animation_length_(0),
     fps_(0),
+    realtime_(false),
+    signals_last_update_(0),
     signal_lock_(false)
 {
 }
@@ -35,14 +61,17 @@ SceneObject* Scene::FindSceneObject(uint64_t UID) {
 // Only used for SceneObjects that are not the root
 SceneObject& Scene::CreateSceneObject(const std::string& name, int flag) {
     std::unique_ptr<SceneObject> node = std::make_unique<SceneObject>(name, flag);
-    node->LightSourceAdded.Connect(this, &Scene::RegisterLightSource);
-    node->ParticleSystemAdded.Connect(this, &Scene::RegisterParticleSystem);
+    node->ParentChanged.Connect(this, &Scene::OnHierarchyChanged);
+    node->ComponentAdded.Connect(this, &Scene::OnComponentAdded);
+    node->ComponentRemoved.Connect(this, &Scene::OnComponentRemoved);
     uint64_t uid = node->GetUID();
     assert(scene_objects_.count(uid) == 0); // It's not a "unique" id if it exists already
     // Set the parent to be the root
     node->SetParent(GetSceneRoot());
 
     scene_objects_[uid] = std::move(node);
+    hierarchy_dirty_ = true;
+    channels_dirty_ = true;
 
     if (signal_lock_) {
         signalqueue.push_back(scene_objects_[uid].get());
@@ -57,13 +86,14 @@ void Scene::DeleteSceneObject(uint64_t uid) {
     assert(scene_objects_.count(uid) > 0); // It can't have been removed already!
     SceneObject* obj = scene_objects_[uid].get();
     if (obj->IsInternal()) return;
-    // Need to recursively remove all children too
-    for (auto& child : obj->GetChildren()) {
+    // Need to recursively remove all children too. Deleting a child removes it from our children,
+    // so iterate over a copy.
+    std::vector<SceneObject*> children(obj->GetChildren().begin(), obj->GetChildren().end());
+    for (auto& child : children) {
         DeleteSceneObject(child->GetUID());
     }
 
     // Remove references to this object
-    if (light_sources_.count(uid) > 0) light_sources_.erase(uid);
     obj->GetParent()->RemoveChild(uid);
 
     // Notify the UI of the deletion first, before the pointer is invalidated
@@ -71,6 +101,8 @@ void Scene::DeleteSceneObject(uint64_t uid) {
 
     // All pointers to the scene object are invalidated after this
     scene_objects_.erase(uid);
+    hierarchy_dirty_ = true;
+    channels_dirty_ = true;
 
     if (obj == render_cam_) {
         render_cam_ = nullptr;
@@ -84,14 +116,12 @@ SceneObject* Scene::DuplicateSceneObject(uint64_t uid) {
     assert(!obj->IsInternal());
 
     std::string newObjName = obj->GetName() + " 2";
+    PropertyBatch batch;
 
     SceneObject& newObj = CreateSceneObject(newObjName);
     newObj.SetParent(*(obj->GetParent()));
 
-    YAML::Emitter objdata;
-    obj->SaveToYAML(objdata);
-    YAML::Node root = YAML::Load(objdata.c_str()); //TODO: Is this a memory leak?
-    newObj.LoadFromYAML(root);
+    newObj.CopyFrom(*obj);
     newObj.SetName(newObjName);
 
     return &newObj;
@@ -100,123 +130,234 @@ SceneObject* Scene::DuplicateSceneObject(uint64_t uid) {
 void Scene::RenderPrepass() {
     lights_.clear();
     envmaps_.clear();
-    RenderPrepass(GetSceneRoot(), glm::mat4());
+
+    UpdatePose();
+    const auto& hierarchy = GetFlattenedHierarchy();
+
+    // Save the lights
+    for (size_t i : GetComponentOwners<Light>()) {
+        SceneObject& node = *hierarchy[i].object;
+        if (IsEnabledInHierarchy(i)) lights_.push_back(std::make_pair(&node, world_matrices_[i]));
+    }
+
+    // Save the envmaps
+    for (size_t i : GetComponentOwners<EnvironmentMap>()) {
+        SceneObject& node = *hierarchy[i].object;
+        if (IsEnabledInHierarchy(i)) envmaps_.push_back(std::make_pair(&node, world_matrices_[i]));
+    }
+}
+
+void Scene::UpdatePose() {
+    const auto& hierarchy = GetFlattenedHierarchy();
+    const size_t count = hierarchy.size();
+    world_matrices_.resize(count);
+
+    // Compose the local matrices of everything that moved together
+    pose_batch_.Clear();
+    pose_indices_.clear();
+    for (size_t i = 0; i < count; i++) {
+        Transform& transform = hierarchy[i].object->GetTransform();
+        if (!transform.IsMatrixStale()) continue;
+        pose_batch_.Add(transform.Translation.Get(), transform.Rotation.Get(), transform.Scale.Get());
+        pose_indices_.push_back(i);
+    }
+    pose_batch_.Compose(pose_matrices_);
+    for (size_t k = 0; k < pose_indices_.size(); k++) {
+        hierarchy[pose_indices_[k]].object->GetTransform().SetComposedMatrix(pose_matrices_[k]);
+    }
+
+    // Parents come before their children, so their world matrices are final by the time we need them.
+    // A clean object's ancestors are all clean, so its cached matrix is still right.
+    for (size_t i = 0; i < count; i++) {
+        SceneObject& node = *hierarchy[i].object;
+        if (node.IsModelMatrixDirty()) {
+            glm::mat4 local = node.GetTransform().GetMatrix();
+            int parent = hierarchy[i].parent;
+            world_matrices_[i] = parent < 0 ? local : world_matrices_[parent] * local;
+            node.SetModelMatrix(world_matrices_[i]);
+        } else {
+            world_matrices_[i] = node.GetModelMatrix();
+        }
+    }
+}
+
+const std::vector<Scene::HierarchyNode>& Scene::GetFlattenedHierarchy() {
+    if (hierarchy_dirty_) {
+        hierarchy_.clear();
+        for (auto& owners : component_owners_) owners.clear();
+        FlattenHierarchy(GetSceneRoot(), -1);
+        hierarchy_dirty_ = false;
+    }
+    return hierarchy_;
+}
+
+bool Scene::IsEnabledInHierarchy(size_t index) const {
+    // The root itself is never checked, same as the recursive traversals
+    for (int i = (int)index; i > 0; i = hierarchy_[i].parent) {
+        if (!hierarchy_[i].object->IsEnabled()) return false;
+    }
+    return true;
+}
+
+void Scene::FlattenHierarchy(SceneObject& node, int parent) {
+    size_t index = hierarchy_.size();
+    hierarchy_.push_back({&node, parent, 0});
+    for (size_t slot = 0; slot < component_owners_.size(); slot++) {
+        if (node.HasComponent(static_cast<ComponentSlot>(slot))) component_owners_[slot].push_back(index);
+    }
+    for (auto& child : node.GetChildren()) {
+        FlattenHierarchy(*child, (int)index);
+    }
+    hierarchy_[index].subtree_end = hierarchy_.size();
 }
 
 void Scene::Start() {
+    sim_clock_.Reset();
     // Start all particle systems
-    for (auto& kv : particle_systems_) {
-        // If we can't find the scene object, it's been deleted
-        // TODO: Remove it
-        if (FindSceneObject(kv.first) == nullptr) continue;
-        if (ParticleSystem* ps = kv.second->GetComponent<ParticleSystem>()) {
-            ps->StartSimulation();
-        }
+    const auto& hierarchy = GetFlattenedHierarchy();
+    for (size_t i : GetComponentOwners<ParticleSystem>()) {
+        hierarchy[i].object->GetComponent<ParticleSystem>()->StartSimulation();
     }
 }
 
 void Scene::Stop() {
     // Stop all particle systems
-    for (auto& kv : particle_systems_) {
-        // If we can't find the scene object, it's been deleted
-        // TODO: Remove it
-        if (FindSceneObject(kv.first) == nullptr) continue;
-        if (ParticleSystem* ps = kv.second->GetComponent<ParticleSystem>()) {
-             ps->StopSimulation();
-        }
+    const auto& hierarchy = GetFlattenedHierarchy();
+    for (size_t i : GetComponentOwners<ParticleSystem>()) {
+        hierarchy[i].object->GetComponent<ParticleSystem>()->StopSimulation();
     }
 }
 
 void Scene::Reset() {
+    sim_clock_.Reset();
     // Reset all particle systems
-    for (auto& kv : particle_systems_) {
-        // If we can't find the scene object, it's been deleted
-        // TODO: Remove it
-        if (FindSceneObject(kv.first) == nullptr) continue;
-        if (ParticleSystem* ps = kv.second->GetComponent<ParticleSystem>()) {
-             ps->ResetSimulation();
-        }
+    const auto& hierarchy = GetFlattenedHierarchy();
+    for (size_t i : GetComponentOwners<ParticleSystem>()) {
+        hierarchy[i].object->GetComponent<ParticleSystem>()->ResetSimulation();
     }
 }
 
-void Scene::UpdatePrepass(SceneObject& node, glm::mat4 model_matrix) {
-    model_matrix = model_matrix * node.GetTransform().GetMatrix();
+void Scene::UpdatePrepass() {
+    colliders_.clear();
+
+    UpdatePose();
+    const auto& hierarchy = GetFlattenedHierarchy();
 
     // Update Particle Simulations
-    if (ParticleSystem* ps = node.GetComponent<ParticleSystem>()) {
+    for (size_t i : GetComponentOwners<ParticleSystem>()) {
+        if (!IsEnabledInHierarchy(i)) continue;
         // Store the model matrix in the Particle System so it can use World coordinates
-        ps->UpdateModelMatrix(model_matrix);
+        hierarchy[i].object->GetComponent<ParticleSystem>()->UpdateModelMatrix(world_matrices_[i]);
     }
 
     // Save the colliders
-    SphereCollider* sphere = node.GetComponent<SphereCollider>();
-    if (sphere != nullptr) colliders_.push_back(std::make_pair(&node, model_matrix));
-    PlaneCollider* plane = node.GetComponent<PlaneCollider>();
-    if (plane != nullptr) colliders_.push_back(std::make_pair(&node, model_matrix));
-    CylinderCollider* cylinder = node.GetComponent<CylinderCollider>();
-    if (cylinder != nullptr) colliders_.push_back(std::make_pair(&node, model_matrix));
-
-    // Recurse into children
-    auto children = node.GetChildren();
-    for (auto& child : children) {
-        if (child->IsEnabled()) UpdatePrepass(*child, model_matrix);
+    for (const std::vector<size_t>* owners : {&GetComponentOwners<SphereCollider>(),
+                                              &GetComponentOwners<PlaneCollider>(),
+                                              &GetComponentOwners<CylinderCollider>()}) {
+        for (size_t i : *owners) {
+            SceneObject& node = *hierarchy[i].object;
+            if (IsEnabledInHierarchy(i)) colliders_.push_back(std::make_pair(&node, world_matrices_[i]));
+        }
     }
 }
 
-void Scene::RenderPrepass(SceneObject& node, glm::mat4 model_matrix) {
-    model_matrix = model_matrix * node.GetTransform().GetMatrix();
+void Scene::Update(float t, float delta_t) {
+    unsigned long signals_before = PropertyBatch::GetSignalsEmitted();
+    {
+        // Animated properties signal once each when the batch closes, and their listeners react once per object
+        PropertyBatch batch;
 
-    // Save the lights
-    Light* light = node.GetComponent<Light>();
-    if (light != nullptr) lights_.push_back(std::make_pair(&node, model_matrix));
+        UpdatePrepass();
 
-    // Save the envmaps
-    EnvironmentMap* envmap = node.GetComponent<EnvironmentMap>();
-    if (envmap != nullptr) envmaps_.push_back(std::make_pair(&node, model_matrix));
+        // Update Particle Simulations
+        if (delta_t > 0 && (realtime_ || fps_ > 0)) StepSimulation(realtime_ ? delta_t : 1.0f / fps_);
 
-    // Recurse into children
-    auto children = node.GetChildren();
-    for (auto& child : children) {
-        if (child->IsEnabled()) RenderPrepass(*child, model_matrix);
+        EvaluateAnimation(t);
     }
+    signals_last_update_ = PropertyBatch::GetSignalsEmitted() - signals_before;
 }
 
-void Scene::Update(float t, float delta_t) {
-
-    colliders_.clear();
-    UpdatePrepass(GetSceneRoot(), glm::mat4());
-
-    // Find all animatable properties and particle systems
-    for (auto& kv : scene_objects_) {
-        // Update Particle Simulation
-        if (delta_t > 0) {
-            if (ParticleSystem* ps = kv.second->GetComponent<ParticleSystem>()) {
-                if (realtime_)
-                    ps->UpdateSimulation(delta_t, colliders_);
-                else
-                    ps->UpdateSimulation(1.0f / fps_, colliders_);
-            }
-        }
-
-        // Find animatable properties
-        for (auto& component : kv.second->GetComponents()) {
-                SetAnimationTime(t, component);
+const std::vector<Scene::AnimationChannel>& Scene::GetAnimationChannels() {
+    if (channels_dirty_) {
+        animation_channels_.clear();
+        for (auto& kv : scene_objects_) {
+            for (Component* component : kv.second->GetComponents()) CollectAnimationChannels(*component, nullptr, component);
         }
+        channels_dirty_ = false;
     }
+    return animation_channels_;
 }
 
-void Scene::SetAnimationTime(float t, ObjectWithProperties* o) {
-    for(auto pname : o->GetProperties()) {
-        Property* p = o->GetProperty(pname);
+void Scene::CollectAnimationChannels(ObjectWithProperties& o, PropertyGroup* group, Component* component) {
+    for (const std::string& pname : o.GetProperties()) {
+        Property* p = o.GetProperty(pname);
         if (auto owp = dynamic_cast<ObjectWithProperties*>(p)) {
-            SetAnimationTime(t, owp);
+            CollectAnimationChannels(*owp, dynamic_cast<PropertyGroup*>(p), component);
         }
         if (auto doub = dynamic_cast<DoubleProperty*>(p)) {
-            doub->SetAnimationTime(t);
+            // Listen for curves on every animatable property, so the channels are rebuilt when one is keyed.
+            // Connecting again is harmless since a signal holds each delegate once.
+            doub->CurveAssigned.Connect(this, &Scene::OnCurveAssigned);
+            if (doub->IsAnimated()) animation_channels_.push_back({doub, group, component});
+        }
+    }
+}
+
+void Scene::EvaluateAnimation(float t) {
+    // Properties without a curve still key at the current time once one is attached
+    DoubleProperty::SetSceneTime(t);
+    const std::vector<AnimationChannel>& channels = GetAnimationChannels();
+    size_t count = channels.size();
+    if (count == 0) return;
+    channel_values_.resize(count);
+    channel_changed_.resize(count);
+
+    // Sampling only reads the curves, so large scenes spread it over the pool
+    size_t tasks = std::min(count / CHANNELS_PER_TASK, (size_t) animation_pool_.maxThreadCount());
+    size_t begin = 0;
+    if (tasks > 1) {
+        size_t chunk = (count + tasks - 1) / tasks;
+        for (; begin + chunk < count; begin += chunk)
+            animation_pool_.start(new ChannelSampler(&channels[begin], &channel_values_[begin], chunk, t));
+    }
+    SampleChannels(&channels[begin], &channel_values_[begin], count - begin, t);
+    animation_pool_.waitForDone();
+
+    // Apply the values, then signal once per group rather than once per changed channel
+    for (size_t i = 0; i < count; ) {
+        PropertyGroup* group = channels[i].group;
+        size_t end = i + 1;
+        while (group && end < count && channels[end].group == group) end++;
+
+        bool any_changed = false;
+        for (size_t j = i; j < end; j++) {
+            channel_changed_[j] = channels[j].property->SetAnimatedValue(channel_values_[j]);
+            any_changed = any_changed || channel_changed_[j];
         }
+        if (any_changed && !(group && group->UpdateFromChildren())) {
+            for (size_t j = i; j < end; j++) if (channel_changed_[j]) channels[j].property->NotifyValueChanged();
+        }
+        i = end;
     }
 }
 
+void Scene::StepSimulation(float frame_time) {
+    const auto& hierarchy = GetFlattenedHierarchy();
+    const std::vector<size_t>& systems = GetComponentOwners<ParticleSystem>();
+
+    // Realtime playback may drop time if it falls too far behind; offline rendering never does,
+    // so both end up taking the same sequence of fixed steps.
+    unsigned int steps = sim_clock_.Advance(frame_time, realtime_ ? SimulationClock::MAX_SUBSTEPS : 0);
+    float timestep = sim_clock_.GetTimestep();
+    for (unsigned int step = 0; step < steps; step++) {
+        for (size_t i : systems) hierarchy[i].object->GetComponent<ParticleSystem>()->UpdateSimulation(timestep, colliders_);
+    }
+
+    // Blend between the last two steps for whatever time is still in the accumulator
+    float alpha = sim_clock_.GetAlpha();
+    for (size_t i : systems) hierarchy[i].object->GetComponent<ParticleSystem>()->InterpolateParticles(alpha);
+}
+
 SceneObject &Scene::GetSceneRoot() {
     // SceneRoot is meant to be invisible, therefore it is not referencable by UID.
     // i.e. you can't delete or duplicate the root. The exception is setting a parent to the root.
@@ -225,12 +366,8 @@ SceneObject &Scene::GetSceneRoot() {
 
 SceneObject* Scene::GetOrCreateRenderCam() {
     if (render_cam_ == nullptr) {
-        for (auto& kv : scene_objects_) {
-            if (kv.second->GetComponent<Camera>()) {
-                render_cam_ = kv.second.get();
-                break;
-            }
-        }
+        const std::vector<size_t>& cams = GetComponentOwners<Camera>();
+        if (!cams.empty()) render_cam_ = GetFlattenedHierarchy()[cams.front()].object;
     }
     if (render_cam_ == nullptr) {
         render_cam_ = &CreateCamera("Render Camera");
@@ -241,26 +378,11 @@ SceneObject* Scene::GetOrCreateRenderCam() {
 
 std::vector<SceneObject*> Scene::GetRenderCams() {
     std::vector<SceneObject*> cams;
-    for (auto& kv : scene_objects_) {
-        if (kv.second->GetComponent<Camera>()) {
-            cams.push_back(kv.second.get());
-        }
-    }
+    const auto& hierarchy = GetFlattenedHierarchy();
+    for (size_t i : GetComponentOwners<Camera>()) cams.push_back(hierarchy[i].object);
     return cams;
 }
 
-std::vector<std::pair<SceneObject*, glm::mat4>> Scene::GetColliders() {
-    return std::vector<std::pair<SceneObject*, glm::mat4>>(colliders_);
-}
-
-std::vector<std::pair<SceneObject*, glm::mat4>> Scene::GetLights() {
-    return std::vector<std::pair<SceneObject*, glm::mat4>>(lights_);
-}
-
-std::vector<std::pair<SceneObject*, glm::mat4>> Scene::GetEnvMaps() {
-    return std::vector<std::pair<SceneObject*, glm::mat4>>(envmaps_);
-}
-
 void Scene::ReparentSceneObject(uint64_t object_id, uint64_t parent_id) {
     if (scene_objects_.count(object_id) < 1) {
         // Output some message
@@ -479,28 +601,38 @@ void Scene::SaveToYAML(YAML::Emitter &out) const
 }
 
 void Scene::LoadFromYAML(const YAML::Node &node)
+{
+    PropertyBatch batch;
+    LoadSettingsFromYAML(node);
+
+    //Prevent this from rendering while loading because
+    //creating curves does that
+    scene_root_->SetEnabled(false);
+    scene_root_->LoadFromYAML(node["Root"]);
+    scene_root_->SetEnabled(true);
+}
+
+void Scene::LoadSettingsFromYAML(const YAML::Node &node)
 {
     SetName(node["Name"].as<std::string>());
     SetAnimationLength(node["Animation Length"].as<unsigned int>());
     SetFPS(node["Animation FPS"].as<unsigned int>());
 
-    YAML::Node assetnode = node["Textures"];
-    for (auto it = assetnode.begin(); it != assetnode.end(); it++) {
-        asset_manager_.LoadTexture(it->first.as<std::string>(), it->second["Path"].as<std::string>());
-    }
-
-    assetnode = node["Cubemaps"];
-    for (auto it = assetnode.begin(); it != assetnode.end(); it++) {
-        asset_manager_.LoadCubemap(it->first.as<std::string>(), it->second["Path"].as<std::string>());
-    }
-
-    assetnode = node["Meshes"];
-    for (auto it = assetnode.begin(); it != assetnode.end(); it++) {
-        std::string name = it->first.as<std::string>();
-        asset_manager_.LoadMesh(name, it->second["Path"].as<std::string>());
+    // Files are decoded together; shader programs and materials refer to them, so they come after
+    std::vector<AssetManager::AssetImport> imports;
+    const std::pair<const char*, AssetType> files[] = {
+        {"Textures", AssetType::Texture}, {"Cubemaps", AssetType::Cubemap}, {"Meshes", AssetType::Mesh}
+    };
+    for (auto& file : files) {
+        YAML::Node assetnode = node[file.first];
+        for (auto it = assetnode.begin(); it != assetnode.end(); it++) {
+            imports.push_back({file.second, it->first.as<std::string>(), it->second["Path"].as<std::string>()});
+            if (file.second == AssetType::Texture && it->second["Compress"]) imports.back().compress = it->second["Compress"].as<bool>();
+        }
     }
+    LoadAssets(imports);
 
-    assetnode = node["ShaderPrograms"];
+    YAML::Node assetnode = node["ShaderPrograms"];
     for (auto it = assetnode.begin(); it != assetnode.end(); it++) {
         ShaderProgram* shader_program = asset_manager_.CreateShaderProgram(it->first.as<std::string>(), false);
         if (shader_program==nullptr) {
@@ -518,6 +650,16 @@ void Scene::LoadFromYAML(const YAML::Node &node)
         material->LoadFromYAML(it->second);
     }
 
+    DeleteRootChildren();
+}
+
+void Scene::LoadAssets(const std::vector<AssetManager::AssetImport>& imports) {
+    if (!asset_manager_.LoadAssets(imports)) {
+        throw FileIOException("Loading \"" + name_ + "\" was cancelled");
+    }
+}
+
+void Scene::DeleteRootChildren() {
     std::vector<uint64_t> idz;
     for (auto it : scene_root_->GetChildren()) {
         idz.push_back(it->GetUID());
@@ -525,10 +667,104 @@ void Scene::LoadFromYAML(const YAML::Node &node)
     for (auto it : idz) {
         DeleteSceneObject(it);
     }
+}
+
+// Writes what else an asset needs to be read from disk the same way again
+static void SaveLoadSettings(BinaryWriter&, const Asset&) {}
+static void SaveLoadSettings(BinaryWriter& out, const Texture& texture) { out.WriteUInt8(texture.Compress.Get()); }
+
+// Writes the name, path and load settings of every asset in the list that was loaded from disk
+template <typename T>
+static void SaveAssetPaths(BinaryWriter& out, const std::vector<T*>& assets) {
+    std::vector<T*> external;
+    for (T* asset : assets) {
+        if (!asset->IsInternal()) external.push_back(asset);
+    }
+    out.WriteUInt32(external.size());
+    for (T* asset : external) {
+        out.WriteString(asset->GetName());
+        out.WriteString(asset->ExternalPath.Get());
+        SaveLoadSettings(out, *asset);
+    }
+}
+
+// Writes the name and properties of every asset in the list that isn't built in
+template <typename T>
+static void SaveAssetProperties(BinaryWriter& out, const std::vector<T*>& assets) {
+    std::vector<T*> external;
+    for (T* asset : assets) {
+        if (!asset->IsInternal()) external.push_back(asset);
+    }
+    out.WriteUInt32(external.size());
+    for (T* asset : external) {
+        out.WriteString(asset->GetName());
+        asset->SaveToBinary(out);
+    }
+}
+
+void Scene::SaveToBinary(BinaryWriter& out) const
+{
+    out.WriteString(name_);
+    out.WriteUInt32(GetAnimationLength());
+    out.WriteUInt32(GetFPS());
+
+    // Assets, in the order they are loaded
+    const AssetManager& assets = asset_manager_;
+    SaveAssetPaths(out, assets.GetTextures());
+    SaveAssetPaths(out, assets.GetCubemaps());
+    SaveAssetPaths(out, assets.GetMeshes());
+    SaveAssetProperties(out, assets.GetShaderPrograms());
+    SaveAssetProperties(out, assets.GetMaterials());
+
+    // Scene Graph
+    scene_root_->SaveToBinary(out);
+}
+
+void Scene::LoadFromBinary(BinaryReader& in)
+{
+    PropertyBatch batch;
+    SetName(in.ReadString());
+    SetAnimationLength(in.ReadUInt32());
+    SetFPS(in.ReadUInt32());
+
+    // Versions before 3 didn't store whether textures are compressed
+    bool load_settings = in.GetVersion() == 0 || in.GetVersion() >= 3;
+    std::vector<AssetManager::AssetImport> imports;
+    for (AssetType type : {AssetType::Texture, AssetType::Cubemap, AssetType::Mesh}) {
+        uint32_t count = in.ReadUInt32();
+        for (uint32_t i = 0; i < count; i++) {
+            std::string name = in.ReadString();
+            imports.push_back({type, name, in.ReadString()});
+            if (type == AssetType::Texture && load_settings) imports.back().compress = in.ReadUInt8() != 0;
+        }
+    }
+    LoadAssets(imports);
+
+    uint32_t count = in.ReadUInt32();
+    for (uint32_t i = 0; i < count; i++) {
+        std::string name = in.ReadString();
+        ShaderProgram* shader_program = asset_manager_.CreateShaderProgram(name, false);
+        if (shader_program==nullptr) {
+            shader_program=asset_manager_.GetShaderProgram(name);
+        }
+        shader_program->LoadFromBinary(in);
+    }
+
+    count = in.ReadUInt32();
+    for (uint32_t i = 0; i < count; i++) {
+        std::string name = in.ReadString();
+        Material* material = asset_manager_.CreateMaterial(name, false);
+        if (material==nullptr) {
+            material = asset_manager_.GetMaterial(name);
+        }
+        material->LoadFromBinary(in);
+    }
+
+    DeleteRootChildren();
 
     //Prevent this from rendering while loading because
     //creating curves does that
     scene_root_->SetEnabled(false);
-    scene_root_->LoadFromYAML(node["Root"]);
+    scene_root_->LoadFromBinary(in);
     scene_root_->SetEnabled(true);
 }
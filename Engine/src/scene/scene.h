@@ -14,9 +14,12 @@
 #include <scene/sceneobject.h>
 #include <resource/assetmanager.h>
 #include <scene/scenecamera.h>
+#include <scene/simulationclock.h>
+#include <scene/transformbatch.h>
 #include <components.h>
 #include <serializable.h>
 #include <singleton.h>
+#include <QThreadPool>
 
 class Scene;
 
@@ -35,17 +38,56 @@ public:
     SceneObject* GetOrCreateRenderCam();
     std::vector<SceneObject*> GetRenderCams();
 
+    // Every SceneObject in the scene graph, depth first with parents before their children, starting with
+    // the root. parent indexes into the same array (-1 for the root) and [index, subtree_end) spans the
+    // object and all its descendants, so a pass can skip a disabled subtree in one jump.
+    // Rebuilt lazily after objects are created, deleted or reparented.
+    struct HierarchyNode {
+        SceneObject* object;
+        int parent;
+        size_t subtree_end;
+    };
+    const std::vector<HierarchyNode>& GetFlattenedHierarchy();
+
+    // World matrix of every object, indexed like GetFlattenedHierarchy. Brought up to date by UpdatePose,
+    // which the update and render prepasses call, so rendering, tracing and collision all share it.
+    const std::vector<glm::mat4>& GetWorldMatrices() const { return world_matrices_; }
+    // Recomposes every transform that changed since the last pass in one batch, then computes world
+    // matrices in one pass over the flattened hierarchy, parents first.
+    void UpdatePose();
+
+    // Hierarchy indices of every object with a component in T's slot (e.g. all Lights), in hierarchy
+    // order, so a pass can visit only the objects it cares about. Rebuilt along with the hierarchy.
+    template<typename T>
+    const std::vector<size_t>& GetComponentOwners() {
+        GetFlattenedHierarchy();
+        return component_owners_[static_cast<size_t>(T::SLOT)];
+    }
+    // Whether the object at a hierarchy index and all its ancestors below the root are enabled
+    bool IsEnabledInHierarchy(size_t index) const;
+
+    // An animatable property driven by a curve, the property group (e.g. a Vec3Property) it belongs to, if any,
+    // and the component that owns it.
+    struct AnimationChannel {
+        DoubleProperty* property;
+        PropertyGroup* group;
+        Component* component;
+    };
+    // Every animated property in the scene. Channels of the same group are contiguous.
+    // Rebuilt lazily after objects or components are added or removed, or a curve is attached to a property.
+    const std::vector<AnimationChannel>& GetAnimationChannels();
+
     // Returns a list of SceneObjects with Colliders and their ModelMatrices
     // Updated whenever UpdatePrepass is called.
-    std::vector<std::pair<SceneObject*, glm::mat4>> GetColliders();
+    const std::vector<std::pair<SceneObject*, glm::mat4>>& GetColliders() const { return colliders_; }
 
     // Returns a list of SceneObjects with Lights and their ModelMatrices
     // Updated whenever RenderPrepass is called.
-    std::vector<std::pair<SceneObject*, glm::mat4>> GetLights();
+    const std::vector<std::pair<SceneObject*, glm::mat4>>& GetLights() const { return lights_; }
 
     // Returns a list of SceneObjects with EnvironmentMaps and their ModelMatrices
     // Updated whenever RenderPrepass is called.
-    std::vector<std::pair<SceneObject*, glm::mat4>> GetEnvMaps();
+    const std::vector<std::pair<SceneObject*, glm::mat4>>& GetEnvMaps() const { return envmaps_; }
 
     // Animation Properties
     unsigned int GetAnimationLength() const { return animation_length_; }
@@ -53,6 +95,9 @@ public:
     unsigned int GetFPS() const { return fps_; }
     void SetFPS(unsigned int fps) { fps_ = fps; }
     void SetRealtime(bool set) { realtime_ = set; }
+    // Fixed step that all simulated components advance by, independent of the frame rate
+    float GetSimulationTimestep() const { return sim_clock_.GetTimestep(); }
+    void SetSimulationTimestep(float timestep) { sim_clock_.SetTimestep(timestep); }
 
     // Animation Functions
     void Start();
@@ -60,6 +105,8 @@ public:
     void Reset();
     void RenderPrepass();
     void Update(float t, float delta_t);
+    // Property change signals emitted during the last Update, for instrumentation
+    unsigned long GetSignalsEmittedLastUpdate() const { return signals_last_update_; }
 
     // SceneObject Manipulation
     SceneObject* FindSceneObject(uint64_t UID);
@@ -106,34 +153,66 @@ protected:
     AssetManager asset_manager_;
     std::unique_ptr<SceneObject> scene_root_;
     std::unordered_map<uint64_t, std::unique_ptr<SceneObject>> scene_objects_;
-    std::unordered_map<uint64_t, SceneObject*> light_sources_;
-    std::unordered_map<uint64_t, SceneObject*> particle_systems_;
     SceneCamera scene_camera_;
 
+    std::vector<HierarchyNode> hierarchy_;
+    std::vector<glm::mat4> world_matrices_;
+    // Stale local transforms gathered by UpdatePose, their hierarchy indices and composed matrices
+    TransformBatch pose_batch_;
+    std::vector<size_t> pose_indices_;
+    std::vector<glm::mat4> pose_matrices_;
+    std::array<std::vector<size_t>, static_cast<size_t>(ComponentSlot::Count)> component_owners_;
+    bool hierarchy_dirty_;
+    void FlattenHierarchy(SceneObject& node, int parent);
+    void OnHierarchyChanged(SceneObject&) { hierarchy_dirty_ = true; }
+    void OnComponentAdded(Component&) { hierarchy_dirty_ = true; channels_dirty_ = true; }
+    void OnComponentRemoved(std::string) { hierarchy_dirty_ = true; channels_dirty_ = true; }
+
+    // Number of channels sampled per task when spreading the animation pass over threads
+    static const size_t CHANNELS_PER_TASK = 256;
+    std::vector<AnimationChannel> animation_channels_;
+    std::vector<double> channel_values_;
+    std::vector<bool> channel_changed_;
+    bool channels_dirty_;
+    QThreadPool animation_pool_;
+    void CollectAnimationChannels(ObjectWithProperties& o, PropertyGroup* group, Component* component);
+    void OnCurveAssigned() { channels_dirty_ = true; }
+    // Samples every animated property at time t and applies the values, signalling each group once
+    void EvaluateAnimation(float t);
+
     std::vector<std::pair<SceneObject*, glm::mat4>> colliders_;
-    void UpdatePrepass(SceneObject& node, glm::mat4 model_matrix);
-    void SetAnimationTime(float t, ObjectWithProperties* o);
+    void UpdatePrepass();
     std::vector<std::pair<SceneObject*, glm::mat4>> lights_;
     std::vector<std::pair<SceneObject*, glm::mat4>> envmaps_;
-    void RenderPrepass(SceneObject& node, glm::mat4 model_matrix);
     SceneObject* render_cam_;
 
     // Animation Properties
     unsigned int animation_length_;
     unsigned int fps_;
     bool realtime_;
+    SimulationClock sim_clock_;
+    unsigned long signals_last_update_;
+    void StepSimulation(float frame_time);
 
     bool signal_lock_;
     // Unsignalled object creation queue
     std::vector<SceneObject*> signalqueue;
 
-    void RegisterLightSource(SceneObject& light) { light_sources_[light.GetUID()] = &light; }
-    void RegisterParticleSystem(SceneObject& ps) { particle_systems_[ps.GetUID()] = &ps; }
+    // Removes every object below the root, before loading replaces them
+    void DeleteRootChildren();
+    // Imports the scene's files through the asset manager. Throws if the user cancels the load.
+    void LoadAssets(const std::vector<AssetManager::AssetImport>& imports);
 
     // Serializable interface
 public:
     void SaveToYAML(YAML::Emitter &out) const;
     void LoadFromYAML(const YAML::Node &node);
+    // Loads everything but the scene graph (settings and assets) and clears out the current scene graph
+    void LoadSettingsFromYAML(const YAML::Node &node);
+    // Same contents as the YAML. Assets loaded from disk are stored by name and path, so they can be
+    // loaded before the scene graph that refers to them.
+    void SaveToBinary(BinaryWriter& out) const;
+    void LoadFromBinary(BinaryReader& in);
 };
 
 #endif // SCENE_H
@@ -12,7 +12,10 @@
 #include <yaml-cpp/yaml.h>
 #include "yamlextensions.h"
 #include <scene/scene.h>
+#include <scene/yamlscenereader.h>
 #include <animation/curvesampler.h>
+#include <binarystream.h>
+#include <QFile>
 #include <fstream>
 #include <deque>
 #include <string>
@@ -20,6 +23,43 @@
 
 template<> SceneManager* Singleton<SceneManager>::_instance_ = nullptr;
 
+const std::string SceneManager::BINARY_EXTENSION = ".scene";
+
+// Binary scene files start with this and the version of the format they were written in
+static const uint32_t BINARY_SCENE_MAGIC = 0x4E435341; // "ASCN"
+// Version 2 stores each component as a sized block, version 3 whether each texture is compressed
+static const uint32_t BINARY_SCENE_VERSION = 3;
+
+bool SceneManager::IsBinarySceneFile(const std::string& filename) {
+    return filename.length() >= BINARY_EXTENSION.length() &&
+           filename.compare(filename.length() - BINARY_EXTENSION.length(), std::string::npos, BINARY_EXTENSION) == 0;
+}
+
+static void SaveBinaryScene(const std::string& filename) {
+    BinaryWriter out;
+    out.WriteUInt32(BINARY_SCENE_MAGIC);
+    out.WriteUInt32(BINARY_SCENE_VERSION);
+    Scene::Instance()->SaveToBinary(out);
+    FileIO::WriteBinaryFile(filename, out.GetData());
+}
+
+static void LoadBinaryScene(Scene& scene, const std::string& filename) {
+    QFile file(QString::fromStdString(filename));
+    if (!file.open(QIODevice::ReadOnly)) throw FileIOException("Cannot open file \"" + filename + "\": " + file.errorString().toStdString());
+    // Decode straight out of the page cache rather than copying the file into memory first
+    const char* data = reinterpret_cast<const char*>(file.map(0, file.size()));
+    if (data == nullptr) throw FileIOException("Cannot map file \"" + filename + "\": " + file.errorString().toStdString());
+
+    BinaryReader in(data, file.size());
+    if (in.ReadUInt32() != BINARY_SCENE_MAGIC) throw FileIOException("\"" + filename + "\" is not a binary scene file");
+    uint32_t version = in.ReadUInt32();
+    if (version > BINARY_SCENE_VERSION) {
+        throw FileIOException("\"" + filename + "\" was saved in a newer scene format (version " + std::to_string(version) + ")");
+    }
+    in.SetVersion(version);
+    scene.LoadFromBinary(in);
+}
+
 SceneManager::SceneManager(ShaderFactory& shader_factory, CurveSamplerFactory& curve_factory) :
     Singleton<SceneManager>(),
     shader_factory_(&shader_factory),
@@ -35,8 +75,12 @@ void SceneManager::SaveScene(const std::string& scene_name, const std::string& f
 
     try {
         Scene::Instance()->SetName(scene_name);
-        Scene::Instance()->SaveToYAML(out);
-        FileIO::WriteTextFile(filename, out.c_str());
+        if (IsBinarySceneFile(filename)) {
+            SaveBinaryScene(filename);
+        } else {
+            Scene::Instance()->SaveToYAML(out);
+            FileIO::WriteTextFile(filename, out.c_str());
+        }
     } catch (const std::exception& e) {
         Debug::Log.WriteLine("Could not save scene to \"" + filename + "\"", Priority::Error);
         Debug::Log.WriteLine("    " + std::string(e.what()));
@@ -51,10 +95,17 @@ Scene* SceneManager::LoadScene(const std::string& filename) {
         delete current;
     }
     current = new Scene("Untitled Scene", *shader_factory_);
+    current->GetAssetManager().LoadProgress.Connect(this, &SceneManager::OnLoadProgress);
 
     try {
-        YAML::Node scene_file = YAML::LoadFile(filename);
-        current->LoadFromYAML(scene_file);
+        if (IsBinarySceneFile(filename)) {
+            LoadBinaryScene(*current, filename);
+        } else {
+            std::ifstream file(filename.c_str(), std::ifstream::in);
+            if (!file.is_open()) throw FileIOException("Cannot open file \"" + filename + "\": " + strerror(errno));
+            YAMLSceneReader reader(*current);
+            reader.Load(file);
+        }
     } catch (const std::exception& e) {
         Debug::Log.WriteLine("Could not load scene \"" + filename + "\"", Priority::Error);
         Debug::Log.WriteLine("    " + std::string(e.what()));
@@ -66,6 +117,11 @@ Scene* SceneManager::LoadScene(const std::string& filename) {
     return current;
 }
 
+void SceneManager::CancelLoad() {
+    AssetManager* assets = AssetManager::Instance();
+    if (loading_ && assets != nullptr) assets->CancelLoad();
+}
+
 Scene* SceneManager::NewScene(const std::string& scene_name) {
     loading_ = true;
     Scene* current = Scene::Instance();
@@ -13,6 +13,7 @@
 #include <string>
 #include <memory>
 #include <singleton.h>
+#include <signals/Signal.h>
 
 namespace YAML {
     class Emitter;
@@ -38,6 +39,16 @@ public:
     Scene* NewScene(const std::string& scene_name);
     // Loads the scene from disk. Returns nullptr if failed.
     Scene* LoadScene(const std::string& filename);
+    // Stops the scene being loaded once the files already decoding are done, so LoadScene returns nullptr.
+    // Safe to call from a LoadProgress handler or another thread.
+    void CancelLoad();
+
+    // Emitted on the loading thread as LoadScene imports the scene's files: the number imported and the total
+    Signal2<size_t, size_t> LoadProgress;
+
+    // Scenes are saved in the binary format when the filename ends with this, and as YAML otherwise
+    static const std::string BINARY_EXTENSION;
+    static bool IsBinarySceneFile(const std::string& filename);
 
     ShaderFactory* GetShaderFactory() { return shader_factory_; }
     CurveSamplerFactory* GetCurveSamplerFactory() { return curve_factory_; }
@@ -51,6 +62,7 @@ private:
     ShaderFactory* shader_factory_;
     CurveSamplerFactory* curve_factory_;
     bool loading_ = false;
+    void OnLoadProgress(size_t loaded, size_t total) { LoadProgress.Emit(loaded, total); }
 };
 
 #endif // SCENEMANAGER_H
@@ -17,10 +17,13 @@ SceneObject::SceneObject(const std::string& name, int flag) :
     uid_(SceneObject::uid_counter_++),
     name_(name),
     parent_(nullptr),
+    model_matrix_dirty_(true),
     enabled_(true),
     flag_(flag)
 {
+    components_.fill(nullptr);
     AddComponent<Transform>();
+    GetTransform().MatrixChanged.Connect(this, &SceneObject::InvalidateModelMatrix);
 }
 
 SceneObject::~SceneObject() {
@@ -44,8 +47,9 @@ void SceneObject::AddComponent(Component* component) {
     if (dynamic_cast<PointLight*>(component) || dynamic_cast<DirectionalLight*>(component)) LightSourceAdded.Emit(*this);
     // Let whomever know that this object is now a particle system
     if (dynamic_cast<ParticleSystem*>(component)) ParticleSystemAdded.Emit(*this);
-    assert(components_.find(component->GetBaseType()) == components_.end());
-    components_[component->GetBaseType()] = component;
+    size_t slot = static_cast<size_t>(component->GetSlot());
+    assert(components_[slot] == nullptr);
+    components_[slot] = component;
     ComponentAdded.Emit(*component);
 }
 
@@ -85,9 +89,9 @@ void SceneObject::SaveToYAML(YAML::Emitter &out) const
     out << YAML::Key << "Enabled" << YAML::Value << enabled_;
 
     out << YAML::Key << "Components" << YAML::Value << YAML::BeginMap;
-    for(auto it = components_.begin(); it!=components_.end(); it++) {
-        out << YAML::Key << it->second->GetTypeName() << YAML::Value;
-        it->second->SaveToYAML(out);
+    for (Component* component : GetComponents()) {
+        out << YAML::Key << component->GetTypeName() << YAML::Value;
+        component->SaveToYAML(out);
     }
     out << YAML::EndMap;
 
@@ -104,6 +108,18 @@ void SceneObject::SaveToYAML(YAML::Emitter &out) const
 }
 
 void SceneObject::LoadFromYAML(const YAML::Node &node)
+{
+    LoadObjectFromYAML(node);
+
+    assert(node["Children"] && node["Children"].IsSequence());
+    for(auto it=node["Children"].begin(); it!=node["Children"].end(); it++) {
+        SceneObject* added = &(Scene::Instance()->CreateSceneObject("temp"));
+        added->LoadFromYAML(*it);
+        added->SetParent(*this);
+    }
+}
+
+void SceneObject::LoadObjectFromYAML(const YAML::Node &node)
 {
     assert(node.IsMap());
     assert(node["Name"]);
@@ -113,23 +129,99 @@ void SceneObject::LoadFromYAML(const YAML::Node &node)
     assert(node["Components"] && node["Components"].IsMap());
     for(auto it=node["Components"].begin(); it!=node["Components"].end(); it++)
     {
-        Component* added = it->first.as<std::string>()=="Transform" ? &GetTransform() : AddComponent(it->first.as<std::string>());
-
+        std::string comp_name = it->first.as<std::string>();
+        Component* added = AddLoadedComponent(comp_name);
         added->LoadFromYAML(it->second);
+        OnComponentLoaded(comp_name, added);
+    }
+}
 
-        std::string comp_name = it->first.as<std::string>();
-        if (comp_name == "RobotArmProp")
-            dynamic_cast<RobotArmProp*>(added)->SetRoot(this);
-        else if (comp_name == "CustomProp")
-            dynamic_cast<CustomProp*>(added)->SetRoot(this);
+void SceneObject::SaveToBinary(BinaryWriter& out) const
+{
+    out.WriteString(name_);
+    out.WriteUInt8(enabled_);
+
+    ComponentRange range = GetComponents();
+    std::vector<Component*> components(range.begin(), range.end());
+    out.WriteUInt32(components.size());
+    // Each component is a sized block, so readers can skip types they don't know
+    for (Component* component : components) {
+        out.WriteString(component->GetTypeName());
+        size_t block = out.BeginBlock();
+        component->SaveToBinary(out);
+        out.EndBlock(block);
     }
 
-    assert(node["Children"] && node["Children"].IsSequence());
-    for(auto it=node["Children"].begin(); it!=node["Children"].end(); it++) {
+    std::vector<SceneObject*> children;
+    for (auto it=children_.begin(); it!=children_.end(); it++) {
+        if (!it->second->IsInternal()) children.push_back(it->second);
+    }
+    out.WriteUInt32(children.size());
+    for (SceneObject* child : children) {
+        child->SaveToBinary(out);
+    }
+}
+
+void SceneObject::LoadFromBinary(BinaryReader& in)
+{
+    SetName(in.ReadString());
+    SetEnabled(in.ReadUInt8() != 0);
+
+    uint32_t component_count = in.ReadUInt32();
+    // Version 1 wrote components back to back, without their sizes
+    bool sized = in.GetVersion() != 1;
+    for (uint32_t i = 0; i < component_count; i++) {
+        std::string comp_name = in.ReadString();
+        size_t end = sized ? in.BeginBlock() : 0;
+        if (!Component::IsDefined(comp_name)) {
+            if (!sized) throw FileIOException("Unknown component \"" + comp_name + "\"");
+            qDebug() << "Unknown component: " << comp_name.c_str();
+            in.Seek(end);
+            continue;
+        }
+        Component* added = AddLoadedComponent(comp_name);
+        added->LoadFromBinary(in);
+        OnComponentLoaded(comp_name, added);
+        if (sized) in.Seek(end);
+    }
+
+    uint32_t child_count = in.ReadUInt32();
+    for (uint32_t i = 0; i < child_count; i++) {
         SceneObject* added = &(Scene::Instance()->CreateSceneObject("temp"));
-        added->LoadFromYAML(*it);
+        added->LoadFromBinary(in);
         added->SetParent(*this);
     }
 }
 
+void SceneObject::CopyFrom(const SceneObject& other)
+{
+    SetName(other.name_);
+    SetEnabled(other.enabled_);
+
+    for (Component* component : other.GetComponents()) {
+        std::string comp_name = component->GetTypeName();
+        Component* added = AddLoadedComponent(comp_name);
+        added->CopyPropertiesFrom(*component);
+        OnComponentLoaded(comp_name, added);
+    }
+
+    for (auto it=other.children_.begin(); it!=other.children_.end(); it++) {
+        if (it->second->IsInternal()) continue;
+        SceneObject* added = &(Scene::Instance()->CreateSceneObject(it->second->GetName()));
+        added->CopyFrom(*it->second);
+        added->SetParent(*this);
+    }
+}
+
+Component* SceneObject::AddLoadedComponent(const std::string& comp_name) {
+    return comp_name=="Transform" ? &GetTransform() : AddComponent(comp_name);
+}
+
+void SceneObject::OnComponentLoaded(const std::string& comp_name, Component* added) {
+    if (comp_name == "RobotArmProp")
+        dynamic_cast<RobotArmProp*>(added)->SetRoot(this);
+    else if (comp_name == "CustomProp")
+        dynamic_cast<CustomProp*>(added)->SetRoot(this);
+}
+
 uint64_t SceneObject::uid_counter_ = 0;
@@ -14,6 +14,8 @@
 #include <scene/components/component.h>
 #include <scene/components/transform.h>
 #include <functional>
+#include <array>
+#include <mapvaluerange.h>
 
 #include <QDebug>
 #include <serializable.h>
@@ -43,19 +45,23 @@ public:
     template<typename T, typename std::enable_if<std::is_base_of<Component, T>::value>::type* = nullptr>
     void RemoveComponent() {
         assert(Component::GetTypeName<T>() != "Transform");
-        std::type_index type = Component::GetBaseType<T>();
-        if (components_.count(type) > 0) {
-            delete components_[type];
-            components_.erase(type);
+        Component*& component = components_[static_cast<size_t>(T::SLOT)];
+        if (component != nullptr) {
+            delete component;
+            component = nullptr;
             ComponentRemoved.Emit(Component::GetTypeName<T>());
         }
     }
 
+    bool HasComponent(ComponentSlot slot) const { return components_[static_cast<size_t>(slot)] != nullptr; }
+
+    // O(1): an array index, plus a dynamic_cast only when asking for a type derived from the slot's base
     template<typename T, typename std::enable_if<std::is_base_of<Component, T>::value>::type* = nullptr>
     T* GetComponent() {
-        std::type_index type = Component::GetBaseType<T>();
-        if (components_.find(type) == components_.end()) return nullptr;
-        else return components_[type]->as<T>();
+        Component* component = components_[static_cast<size_t>(T::SLOT)];
+        if (component == nullptr) return nullptr;
+        if (std::is_same<T, typename T::SlotType>::value) return static_cast<T*>(component);
+        return component->as<T>();
     }
 
     // Whether or not this object should be renderered
@@ -92,16 +98,10 @@ public:
         assert(xform != nullptr); // SceneObjects should always has a Transform component!
         return *xform;
     }
-    // Used for traversing a scene graph
-    // TODO: The best way to do this would actually be to return a custom iterator... but for now this will do at a performance cost.
-    std::vector<SceneObject*> GetChildren() const {
-        std::vector<SceneObject*> ret;
-        for (auto& kv : children_) {
-            assert(kv.second != nullptr); // A child should never be null
-            ret.push_back(kv.second);
-        }
-        return ret;
-    }
+    // Used for traversing a scene graph. This is a view, not a copy: if the loop reparents or
+    // deletes children, copy it into a std::vector<SceneObject*> first.
+    typedef MapValueRange<std::map<uint64_t, SceneObject*>> ChildRange;
+    ChildRange GetChildren() const { return ChildRange(children_); }
 
     // Utilities for finding descendants that satisfy some predicate
     std::vector<SceneObject*> FilterDescendants(std::function<bool(SceneObject*)> f) {
@@ -137,29 +137,71 @@ public:
         );
     }
 
-    // Used for serialization and UI
-    std::vector<Component*> GetComponents() const {
-        std::vector<Component*> ret;
-        for (auto& kv : components_) {
-            assert(kv.second != nullptr); // A child should never be null
-            ret.push_back(kv.second);
+    typedef std::array<Component*, static_cast<size_t>(ComponentSlot::Count)> ComponentSlots;
+
+    // View over the occupied component slots, in slot order
+    class ComponentRange {
+    public:
+        class iterator {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef Component* value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef Component* const* pointer;
+            typedef Component* const& reference;
+
+            iterator(ComponentSlots::const_iterator it, ComponentSlots::const_iterator end) : it_(it), end_(end) { SkipEmpty(); }
+            reference operator*() const { return *it_; }
+            iterator& operator++() { ++it_; SkipEmpty(); return *this; }
+            iterator operator++(int) { iterator prev(*this); ++(*this); return prev; }
+            bool operator==(const iterator& other) const { return it_ == other.it_; }
+            bool operator!=(const iterator& other) const { return it_ != other.it_; }
+        private:
+            void SkipEmpty() { while (it_ != end_ && *it_ == nullptr) ++it_; }
+            ComponentSlots::const_iterator it_;
+            ComponentSlots::const_iterator end_;
+        };
+
+        ComponentRange(const ComponentSlots& slots) : slots_(&slots) { }
+        iterator begin() const { return iterator(slots_->begin(), slots_->end()); }
+        iterator end() const { return iterator(slots_->end(), slots_->end()); }
+    private:
+        const ComponentSlots* slots_;
+    };
+
+    // Used for serialization and UI. Like GetChildren, this is a view over the components.
+    ComponentRange GetComponents() const { return ComponentRange(components_); }
+
+    // LocalToWorldMatrix - O(1) if nothing above this object has moved since it was last asked for,
+    // otherwise recomputes only the dirty part of the path to the root
+    glm::mat4 GetModelMatrix() {
+        if (model_matrix_dirty_) {
+            if (parent_ != nullptr) model_matrix_ = parent_->GetModelMatrix() * GetTransform().GetMatrix();
+            else model_matrix_ = GetTransform().GetMatrix();
+            model_matrix_dirty_ = false;
         }
-        return ret;
+        return model_matrix_;
     }
 
-    // LocalToWorldMatrix - O(log(n)) operation
-    glm::mat4 GetModelMatrix() {
-        return GetParentModelMatrix() * GetTransform().GetMatrix();
+    // For passes that compute model matrices in bulk, parents before children
+    bool IsModelMatrixDirty() const { return model_matrix_dirty_; }
+    void SetModelMatrix(const glm::mat4& model_matrix) {
+        model_matrix_ = model_matrix;
+        model_matrix_dirty_ = false;
     }
 
     glm::mat4 GetParentModelMatrix() {
-        glm::mat4 model_matrix;
-        SceneObject* parent = GetParent();
-        while(parent != nullptr) {
-            model_matrix = parent->GetTransform().GetMatrix() * model_matrix;
-            parent = parent->GetParent();
-        }
-        return model_matrix;
+        if (parent_ == nullptr) return glm::mat4();
+        return parent_->GetModelMatrix();
+    }
+
+    // Marks the cached model matrix of this object and all its descendants as stale.
+    // Called when our Transform changes or we are reparented.
+    void InvalidateModelMatrix() {
+        // A dirty object's descendants are always dirty too, so there's nothing left to do
+        if (model_matrix_dirty_) return;
+        model_matrix_dirty_ = true;
+        for (auto& kv : children_) kv.second->InvalidateModelMatrix();
     }
 
     // Sets the parent
@@ -216,6 +258,13 @@ public:
 
     virtual void SaveToYAML(YAML::Emitter& out) const;
     virtual void LoadFromYAML(const YAML::Node& node);
+    virtual void SaveToBinary(BinaryWriter& out) const;
+    virtual void LoadFromBinary(BinaryReader& in);
+    // Loads the name, enabled state and components, but not the children
+    void LoadObjectFromYAML(const YAML::Node& node);
+    // Gives this object copies of the other's components and children, the same as saving and
+    // loading it would, but copying values directly
+    void CopyFrom(const SceneObject& other);
 
 protected:
     // Shouldn't allow the parent to be set to null, so use a reference.
@@ -230,17 +279,26 @@ protected:
         // Set the parent relationship and notify the parent of its new child.
         parent_ = &parent;
         parent_->RegisterChild(*this);
+        InvalidateModelMatrix();
     }
 
+    // Shared by the YAML and binary loaders: finds or adds the component being loaded,
+    // then hooks it up once its properties are set
+    Component* AddLoadedComponent(const std::string& comp_name);
+    void OnComponentLoaded(const std::string& comp_name, Component* added);
+
     static uint64_t uid_counter_; // Program might break if you make 9223372036854775807 objects
     uint64_t uid_; // Unique identifier for this scene object
     // TODO: Maybe name, enabled should be BooleanProperty and TextProperty rather than raw as they are now.
     std::string name_;
 
-    std::map<std::type_index, Component*> components_;
+    ComponentSlots components_;
     SceneObject* parent_; // Nullptr if this node is the root
     Scene* scene_; // Can't be a ref cause refs must be initialized
     std::map<uint64_t, SceneObject*> children_;
+    // World transform, valid unless model_matrix_dirty_
+    glm::mat4 model_matrix_;
+    bool model_matrix_dirty_;
 
     // TODO: Serialize this property
     // TODO: Make UI responsive to this change (signal)
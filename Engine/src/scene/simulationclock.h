@@ -0,0 +1,86 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#ifndef SIMULATIONCLOCK_H
+#define SIMULATIONCLOCK_H
+
+#include <algorithm>
+#include <cmath>
+
+// Fixed timestep scheduler for simulated components (particle systems, etc).
+// Frame time is banked in an accumulator and paid out in whole steps of a fixed size,
+// so the simulation advances identically whether it is driven by a realtime preview
+// or by an offline render at some fixed FPS. Whatever is left in the accumulator is
+// exposed as an interpolation factor for blending render state between the last two steps.
+class SimulationClock {
+public:
+    // Default catch-up budget per Update in realtime mode, beyond which time is dropped
+    static const unsigned int MAX_SUBSTEPS = 8;
+    // Steps a single Advance takes at most even in offline mode, so a huge delta_t can't stall the caller
+    static const unsigned int MAX_STEPS = 1 << 16;
+    static constexpr float DEFAULT_TIMESTEP = 1.0f / 120.0f;
+
+    SimulationClock(float timestep = DEFAULT_TIMESTEP) :
+        timestep_(DEFAULT_TIMESTEP),
+        accumulator_(0.0),
+        steps_(0)
+    {
+        SetTimestep(timestep);
+    }
+
+    float GetTimestep() const { return timestep_; }
+    void SetTimestep(float timestep) { if (IsValid(timestep)) timestep_ = timestep; Reset(); }
+
+    // Number of fixed steps taken since the last Reset
+    unsigned long long GetStepCount() const { return steps_; }
+    double GetSimulationTime() const { return steps_ * (double)timestep_; }
+
+    void Reset() {
+        accumulator_ = 0.0;
+        steps_ = 0;
+    }
+
+    // Banks delta_t and returns the number of fixed steps the caller should take.
+    // When max_substeps is nonzero and the clock has fallen too far behind, the excess
+    // time is discarded instead of spiralling; pass 0 to only drop time past MAX_STEPS (offline rendering).
+    // A delta_t that isn't a positive, finite number of seconds takes no steps.
+    unsigned int Advance(float delta_t, unsigned int max_substeps = MAX_SUBSTEPS) {
+        // Tolerance so that e.g. 1/30s frames split into exactly four 1/120s steps despite rounding
+        static const double EPSILON = 1e-9;
+        if (!IsValid(delta_t)) return 0;
+        if (max_substeps == 0 || max_substeps > MAX_STEPS) max_substeps = MAX_STEPS;
+        accumulator_ += delta_t;
+        unsigned int steps = 0;
+        while (accumulator_ + EPSILON >= timestep_) {
+            if (steps == max_substeps) {
+                accumulator_ = std::fmod(accumulator_, (double)timestep_);
+                break;
+            }
+            accumulator_ -= timestep_;
+            steps++;
+        }
+        if (accumulator_ < 0.0) accumulator_ = 0.0;
+        steps_ += steps;
+        return steps;
+    }
+
+    // Fraction of a step remaining in the accumulator, in [0, 1)
+    float GetAlpha() const {
+        return std::min(0.999999f, (float)(accumulator_ / timestep_));
+    }
+
+protected:
+    static bool IsValid(float seconds) { return std::isfinite(seconds) && seconds > 0.0f; }
+
+    float timestep_;
+    double accumulator_;
+    unsigned long long steps_;
+};
+
+#endif // SIMULATIONCLOCK_H
@@ -0,0 +1,60 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#include "transformbatch.h"
+
+void TransformBatch::Clear() {
+    for (auto values : {&tx_, &ty_, &tz_, &rx_, &ry_, &rz_, &sx_, &sy_, &sz_}) values->clear();
+}
+
+void TransformBatch::Add(const glm::vec3& translation, const glm::vec3& rotation, const glm::vec3& scale) {
+    tx_.push_back(translation.x); ty_.push_back(translation.y); tz_.push_back(translation.z);
+    rx_.push_back(rotation.x); ry_.push_back(rotation.y); rz_.push_back(rotation.z);
+    sx_.push_back(scale.x); sy_.push_back(scale.y); sz_.push_back(scale.z);
+}
+
+// Writes translate * eulerAngleXYZ(radians(r)) * scale into m
+static inline void ComposeMatrix(float tx, float ty, float tz, float rx, float ry, float rz,
+                                 float sx, float sy, float sz, glm::mat4& m) {
+    // glm::eulerAngleXYZ works with the sines and cosines of the negated angles
+    const float to_radians = -float(M_PI) / 180.0f;
+    const float s1 = std::sin(rx * to_radians), s2 = std::sin(ry * to_radians), s3 = std::sin(rz * to_radians);
+    const float c1 = std::cos(rx * to_radians), c2 = std::cos(ry * to_radians), c3 = std::cos(rz * to_radians);
+    // Rotation columns scaled by the scale along each axis
+    m[0][0] = c2 * c3 * sx;
+    m[0][1] = (-c1 * s3 + s1 * s2 * c3) * sx;
+    m[0][2] = (s1 * s3 + c1 * s2 * c3) * sx;
+    m[0][3] = 0.0f;
+    m[1][0] = c2 * s3 * sy;
+    m[1][1] = (c1 * c3 + s1 * s2 * s3) * sy;
+    m[1][2] = (-s1 * c3 + c1 * s2 * s3) * sy;
+    m[1][3] = 0.0f;
+    m[2][0] = -s2 * sz;
+    m[2][1] = s1 * c2 * sz;
+    m[2][2] = c1 * c2 * sz;
+    m[2][3] = 0.0f;
+    m[3][0] = tx;
+    m[3][1] = ty;
+    m[3][2] = tz;
+    m[3][3] = 1.0f;
+}
+
+void TransformBatch::Compose(std::vector<glm::mat4>& out_matrices) const {
+    const size_t count = GetCount();
+    out_matrices.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        ComposeMatrix(tx_[i], ty_[i], tz_[i], rx_[i], ry_[i], rz_[i], sx_[i], sy_[i], sz_[i], out_matrices[i]);
+    }
+}
+
+glm::mat4 TransformBatch::Compose(const glm::vec3& translation, const glm::vec3& rotation, const glm::vec3& scale) {
+    glm::mat4 m;
+    ComposeMatrix(translation.x, translation.y, translation.z, rotation.x, rotation.y, rotation.z, scale.x, scale.y, scale.z, m);
+    return m;
+}
@@ -0,0 +1,37 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#ifndef TRANSFORMBATCH_H
+#define TRANSFORMBATCH_H
+
+#include <vectors.h>
+
+// Local transforms (translation, XYZ euler rotation in degrees, scale) stored as structure-of-arrays,
+// so a whole batch of joints can be composed into matrices in one straight-line loop that the
+// compiler can vectorize. Composing writes translate * eulerAngleXYZ * scale directly, without
+// building and multiplying the three matrices.
+class TransformBatch {
+public:
+    size_t GetCount() const { return tx_.size(); }
+    void Clear();
+    void Add(const glm::vec3& translation, const glm::vec3& rotation, const glm::vec3& scale);
+
+    // Composes every transform in the batch, in the order they were added
+    void Compose(std::vector<glm::mat4>& out_matrices) const;
+
+    // Composes a single transform the same way
+    static glm::mat4 Compose(const glm::vec3& translation, const glm::vec3& rotation, const glm::vec3& scale);
+
+protected:
+    std::vector<float> tx_, ty_, tz_;
+    std::vector<float> rx_, ry_, rz_;
+    std::vector<float> sx_, sy_, sz_;
+};
+
+#endif // TRANSFORMBATCH_H
@@ -0,0 +1,184 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#include "yamlscenereader.h"
+#include <animator.h>
+#include <scene/scene.h>
+#include <scene/sceneobject.h>
+#include <properties/propertybatch.h>
+
+// Error for structure the reader can't load, with the line it was found at
+static FileIOException SceneError(const YAML::Mark& mark, const std::string& message) {
+    return FileIOException(message + " at line " + std::to_string(mark.line + 1));
+}
+
+// Everything Scene::LoadSettingsFromYAML reads. Scene::SaveToYAML writes all of it before Root.
+static const char* const SCENE_SETTINGS[] = {
+    "Name", "Animation Length", "Animation FPS", "Textures", "Cubemaps", "Meshes", "Materials", "ShaderPrograms"
+};
+
+static bool IsSceneSetting(const std::string& key) {
+    for (const char* setting : SCENE_SETTINGS) {
+        if (key == setting) return true;
+    }
+    return false;
+}
+
+// Whether the scene graph can be loaded as it is read: nothing the settings would load is still to come
+static bool HasAllSceneSettings(const YAML::Node& scene_node) {
+    for (const char* setting : SCENE_SETTINGS) {
+        if (!scene_node[setting]) return false;
+    }
+    return true;
+}
+
+YAMLSceneReader::YAMLSceneReader(Scene& scene) :
+    scene_(scene),
+    root_streamed_(false),
+    keys_after_root_(false)
+{
+}
+
+void YAMLSceneReader::Load(std::istream& in) {
+    PropertyBatch batch;
+    YAML::Parser parser(in);
+    if (!parser.HandleNextDocument(*this)) throw FileIOException("Scene file is empty");
+}
+
+void YAMLSceneReader::OnDocumentStart(const YAML::Mark&) {
+    stack_.clear();
+    root_streamed_ = false;
+    keys_after_root_ = false;
+}
+
+void YAMLSceneReader::OnDocumentEnd() {
+    if (keys_after_root_) {
+        Debug::Log.WriteLine("Scene settings repeated after Root were ignored", Priority::Warning);
+    }
+}
+
+void YAMLSceneReader::OnNull(const YAML::Mark& mark, YAML::anchor_t) {
+    AddValue(mark, YAML::Node(YAML::NodeType::Null));
+}
+
+void YAMLSceneReader::OnAlias(const YAML::Mark& mark, YAML::anchor_t) {
+    throw SceneError(mark, "Aliases are not supported in scene files");
+}
+
+void YAMLSceneReader::OnScalar(const YAML::Mark& mark, const std::string&, YAML::anchor_t, const std::string& value) {
+    AddValue(mark, YAML::Node(value));
+}
+
+void YAMLSceneReader::OnSequenceStart(const YAML::Mark& mark, const std::string&, YAML::anchor_t, YAML::EmitterStyle::value) {
+    StartContainer(mark, false);
+}
+
+void YAMLSceneReader::OnSequenceEnd() {
+    EndContainer();
+}
+
+void YAMLSceneReader::OnMapStart(const YAML::Mark& mark, const std::string&, YAML::anchor_t, YAML::EmitterStyle::value) {
+    StartContainer(mark, true);
+}
+
+void YAMLSceneReader::OnMapEnd() {
+    EndContainer();
+}
+
+void YAMLSceneReader::PushFrame(FrameType type, YAML::Node node, SceneObject* object) {
+    stack_.push_back({type, node, "", false, object, false});
+}
+
+void YAMLSceneReader::StartContainer(const YAML::Mark& mark, bool is_map) {
+    YAML::NodeType::value node_type = is_map ? YAML::NodeType::Map : YAML::NodeType::Sequence;
+    if (stack_.empty()) {
+        if (!is_map) throw SceneError(mark, "Expected the scene to be a map");
+        PushFrame(FrameType::Scene, YAML::Node(node_type));
+        return;
+    }
+
+    Frame& parent = stack_.back();
+    const YAML::Node& parent_node = parent.node;
+    if (parent.type != FrameType::Children && parent_node.IsMap() && !parent.has_key) {
+        throw SceneError(mark, "Map keys must be scalars");
+    }
+
+    if (parent.type == FrameType::Scene && parent.key == "Root" && is_map && !root_streamed_ &&
+            HasAllSceneSettings(parent_node)) {
+        // Everything the scene graph can refer to has been read
+        scene_.LoadSettingsFromYAML(parent.node);
+        root_streamed_ = true;
+        //Prevent this from rendering while loading because
+        //creating curves does that
+        scene_.GetSceneRoot().SetEnabled(false);
+        PushFrame(FrameType::Object, YAML::Node(node_type), &scene_.GetSceneRoot());
+    } else if (parent.type == FrameType::Object && parent.key == "Children" && !is_map) {
+        // If Children come first, the object is loaded when its map ends instead, with its children already attached
+        if (parent_node["Components"]) LoadObject(parent);
+        PushFrame(FrameType::Children, YAML::Node());
+    } else if (parent.type == FrameType::Children) {
+        if (!is_map) throw SceneError(mark, "Expected a scene object");
+        PushFrame(FrameType::Object, YAML::Node(node_type), &scene_.CreateSceneObject("temp"));
+    } else {
+        PushFrame(FrameType::Node, YAML::Node(node_type));
+    }
+}
+
+void YAMLSceneReader::EndContainer() {
+    Frame frame = stack_.back();
+    stack_.pop_back();
+
+    switch (frame.type) {
+    case FrameType::Node:
+        AddValue(YAML::Mark(), frame.node);
+        break;
+    case FrameType::Scene:
+        // Root was missing or came before the scene settings, so it was gathered along with them
+        if (!root_streamed_) scene_.LoadFromYAML(frame.node);
+        break;
+    case FrameType::Object:
+        if (!frame.object_loaded) LoadObject(frame);
+        if (frame.object == &scene_.GetSceneRoot()) {
+            scene_.GetSceneRoot().SetEnabled(true);
+        } else {
+            // Below this object's Children is the object they belong to
+            frame.object->SetParent(*stack_[stack_.size() - 2].object);
+        }
+        stack_.back().has_key = false;
+        break;
+    case FrameType::Children:
+        stack_.back().has_key = false;
+        break;
+    }
+}
+
+void YAMLSceneReader::AddValue(const YAML::Mark& mark, const YAML::Node& value) {
+    if (stack_.empty() || stack_.back().type == FrameType::Children) {
+        throw SceneError(mark, "Expected a scene object");
+    }
+
+    Frame& frame = stack_.back();
+    if (frame.node.IsSequence()) {
+        frame.node.push_back(value);
+    } else if (!frame.has_key) {
+        frame.key = value.Scalar();
+        frame.has_key = true;
+    } else {
+        frame.node[frame.key] = value;
+        frame.has_key = false;
+        if (frame.type == FrameType::Scene && root_streamed_ && IsSceneSetting(frame.key)) keys_after_root_ = true;
+    }
+}
+
+void YAMLSceneReader::LoadObject(Frame& frame) {
+    frame.object->LoadObjectFromYAML(frame.node);
+    frame.object_loaded = true;
+    // The components have been applied, so their nodes can go
+    frame.node.reset();
+}
@@ -0,0 +1,75 @@
+/****************************************************************************
+ * Copyright ©2017 Brian Curless.  All rights reserved.  Permission is hereby
+ * granted to students registered for University of Washington CSE 457 or CSE
+ * 557 for use solely during Autumn Quarter 2017 for purposes of the course.
+ * No other use, copying, distribution, or modification is permitted without
+ * prior written consent. Copyrights for third-party components of this work
+ * must be honored.  Instructors interested in reusing these course materials
+ * should contact the author.
+ ****************************************************************************/
+#ifndef YAMLSCENEREADER_H
+#define YAMLSCENEREADER_H
+
+#include <yaml-cpp/yaml.h>
+#include <yaml-cpp/eventhandler.h>
+#include <istream>
+#include <string>
+#include <vector>
+
+class Scene;
+class SceneObject;
+
+// Loads a YAML scene from the parser's events rather than from a YAML::Node of the whole file.
+// The settings and assets before Root are gathered into a node as usual, since they are small.
+// Within the scene graph, only the object being loaded is held as a node: its name and components are
+// applied as soon as its Children start, or when its map ends if the Children came before the Components,
+// and each child is created and loaded as its events arrive.
+// Files that don't put Root after all of the scene settings, including every asset section, are loaded the usual way.
+class YAMLSceneReader : public YAML::EventHandler {
+public:
+    YAMLSceneReader(Scene& scene);
+
+    // Throws a YAML::Exception or FileIOException if the file isn't a valid scene
+    void Load(std::istream& in);
+
+    virtual void OnDocumentStart(const YAML::Mark& mark) override;
+    virtual void OnDocumentEnd() override;
+    virtual void OnNull(const YAML::Mark& mark, YAML::anchor_t anchor) override;
+    virtual void OnAlias(const YAML::Mark& mark, YAML::anchor_t anchor) override;
+    virtual void OnScalar(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor, const std::string& value) override;
+    virtual void OnSequenceStart(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor, YAML::EmitterStyle::value style) override;
+    virtual void OnSequenceEnd() override;
+    virtual void OnMapStart(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor, YAML::EmitterStyle::value style) override;
+    virtual void OnMapEnd() override;
+
+private:
+    enum class FrameType {
+        Node,       // Any other map or sequence, gathered into a node
+        Scene,      // The top level map
+        Object,     // A scene object's map
+        Children    // A scene object's Children, which is not gathered
+    };
+
+    struct Frame {
+        FrameType type;
+        YAML::Node node;
+        // For maps, the key whose value is being read
+        std::string key;
+        bool has_key;
+        SceneObject* object;
+        bool object_loaded;
+    };
+
+    Scene& scene_;
+    std::vector<Frame> stack_;
+    bool root_streamed_;
+    bool keys_after_root_;
+
+    void PushFrame(FrameType type, YAML::Node node, SceneObject* object = nullptr);
+    void StartContainer(const YAML::Mark& mark, bool is_map);
+    void EndContainer();
+    void AddValue(const YAML::Mark& mark, const YAML::Node& value);
+    void LoadObject(Frame& frame);
+};
+
+#endif // YAMLSCENEREADER_H
@@ -1,2 +1,13 @@
 #include "serializable.h"
+#include <binarystream.h>
+
+void Serializable::SaveToBinary(BinaryWriter& out) const {
+    YAML::Emitter yaml;
+    SaveToYAML(yaml);
+    out.WriteString(yaml.c_str());
+}
+
+void Serializable::LoadFromBinary(BinaryReader& in) {
+    LoadFromYAML(YAML::Load(in.ReadString()));
+}
 
@@ -12,12 +12,19 @@
 #include <yaml-cpp/yaml.h>
 #include <QDebug>
 
+class BinaryWriter;
+class BinaryReader;
+
 class Serializable
 {
 public:
     virtual ~Serializable() {}
     virtual void SaveToYAML(YAML::Emitter& out) const = 0;
     virtual void LoadFromYAML(const YAML::Node& node) = 0;
+
+    // Used by binary scene files. Unless overridden, these store the YAML as a string.
+    virtual void SaveToBinary(BinaryWriter& out) const;
+    virtual void LoadFromBinary(BinaryReader& in);
 };
 
 #endif // SERIALIZABLE_H
@@ -12,12 +12,12 @@
 
 #include <scene/components/triangleface.h>
 
-Material* Intersection::GetMaterial()
+const TraceMaterial* Intersection::GetMaterial()
 {
    assert(obj != nullptr);
    TraceGeometry* geo = dynamic_cast<TraceGeometry*>(obj);
    assert(geo != nullptr);
-   return geo->geometry->RenderMaterial.Get();
+   return geo->material;
 }
 
 glm::vec3 Intersection::GetTrueNormal()
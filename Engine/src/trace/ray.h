@@ -18,7 +18,7 @@ const double EDGE_EPSILON = 0.000000001;
 const double INDEX_OF_AIR = 1.0003;
 
 class TraceSceneObject;
-class Material;
+struct TraceMaterial;
 
 // A ray has a position where the ray starts, and a direction (which should
 // always be normalized!)
@@ -68,7 +68,7 @@ class Intersection {
     double t;
     glm::vec3 normal;
     glm::vec2 uv;
-    Material* GetMaterial();
+    const TraceMaterial* GetMaterial();
     glm::vec3 GetTrueNormal();
 };
 
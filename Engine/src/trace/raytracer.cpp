@@ -28,7 +28,7 @@ unsigned int pow4(unsigned int e) {
     return i;
 }
 
-RayTracer::RayTracer(Scene& scene, SceneObject& camobj) :
+RayTracer::RayTracer(Scene& scene, SceneObject& camobj, int max_threads) :
     trace_scene(&scene, camobj.GetComponent<Camera>()->TraceEnableAcceleration.Get()), next_render_index(0), cancelling(false), first_pass_buffer(nullptr)
 {
     Camera* cam = camobj.GetComponent<Camera>();
@@ -92,9 +92,12 @@ RayTracer::RayTracer(Scene& scene, SceneObject& camobj) :
 
     buffer = new uint8_t[settings.width * settings.height * 3]();
 
-    int num_threads = QThread::idealThreadCount();
-    if (num_threads > 1) {
-        num_threads -= 1; //leave a free thread so the computer doesn't totally die
+    int num_threads = max_threads;
+    if (num_threads <= 0) {
+        num_threads = QThread::idealThreadCount();
+        if (num_threads > 1) {
+            num_threads -= 1; //leave a free thread so the computer doesn't totally die
+        }
     }
     thread_pool.setMaxThreadCount(num_threads);
 
@@ -133,6 +136,15 @@ RayTracer::~RayTracer() {
     }
 }
 
+bool RayTracer::IsSnapshotSafe(Scene& scene) {
+    for (const Scene::AnimationChannel& channel : scene.GetAnimationChannels()) {
+        if (dynamic_cast<Transform*>(channel.component) == nullptr && dynamic_cast<Camera*>(channel.component) == nullptr) {
+            return false;
+        }
+    }
+    return true;
+}
+
 int RayTracer::GetProgress() {
     if (thread_pool.waitForDone(1)) {
         return 100;
@@ -233,11 +245,11 @@ glm::vec3 RayTracer::TraceRay(const Ray& r, int depth, RayType ray_type, Camera*
         // An intersection occured!  We've got work to do. For now,
         // this code gets the material parameters for the surface
         // that was intersected.
-        Material* mat = i.GetMaterial();
-        glm::vec3 kd = mat->Diffuse->GetColorUV(i.uv);
-        glm::vec3 ks = mat->Specular->GetColorUV(i.uv);
-        glm::vec3 ke = mat->Emissive->GetColorUV(i.uv);
-        glm::vec3 kt = mat->Transmittence->GetColorUV(i.uv);
+        const TraceMaterial* mat = i.GetMaterial();
+        glm::vec3 kd = mat->Diffuse.GetColorUV(i.uv);
+        glm::vec3 ks = mat->Specular.GetColorUV(i.uv);
+        glm::vec3 ke = mat->Emissive.GetColorUV(i.uv);
+        glm::vec3 kt = mat->Transmittence.GetColorUV(i.uv);
         float shininess = mat->Shininess;
         double index_of_refraction = mat->IndexOfRefraction;
 
@@ -71,9 +71,16 @@ class RayTracer {
         float aperture_radius;
     };
     
-    RayTracer(Scene& scene, SceneObject& camera);
+    // Starts tracing the scene as it is now on up to max_threads threads (by default, all but one core)
+    RayTracer(Scene& scene, SceneObject& camera, int max_threads = 0);
     ~RayTracer();
 
+    // Whether a tracer keeps producing the same image while the scene animates on to later frames.
+    // Meshes, transforms, materials and camera settings are copied when it is built, but lights and custom
+    // traced geometry (spheres, cylinders) are read as it traces, so this only holds if the animation moves
+    // nothing but transforms and cameras.
+    static bool IsSnapshotSafe(Scene& scene);
+
     int GetProgress();
 
     double AspectRatio();
@@ -7,7 +7,7 @@
 
 TraceScene::TraceScene(Scene *scene, bool use_acceleration)
 {
-    AddSceneObjects(&(scene->GetSceneRoot()), glm::mat4());
+    AddSceneObjects(&(scene->GetSceneRoot()));
 
     if (!use_acceleration) {
         for (auto obj : bounded_objects) {
@@ -19,25 +19,26 @@ TraceScene::TraceScene(Scene *scene, bool use_acceleration)
     tree = new TreeBox(bounded_objects);
 }
 
-void TraceScene::AddSceneObjects(SceneObject* obj, glm::mat4 model_matrix) {
+void TraceScene::AddSceneObjects(SceneObject* obj) {
     if (obj->IsInternal() || !obj->IsEnabled()) {
         return;
     }
 
-    model_matrix = model_matrix * obj->GetTransform().GetMatrix();
+    glm::mat4 model_matrix = obj->GetModelMatrix();
 
     Geometry* geo = obj->GetComponent<Geometry>();
 
-    if (geo != nullptr && geo->RenderMaterial.Get() != nullptr && geo->RenderMaterial.Get()->PrepareToTrace()) {
+    if (geo != nullptr && geo->RenderMaterial.Get() != nullptr && geo->RenderMaterial.Get()->IsTraceCompatible()) {
+        const TraceMaterial* material = GetTraceMaterial(geo->RenderMaterial.Get());
         if (geo->UseCustomTrace()) {
-            TraceGeometry* tso = new TraceGeometry(geo, model_matrix);
+            TraceGeometry* tso = new TraceGeometry(geo, material, model_matrix);
             if (tso->world_bbox == nullptr) {
                 unbounded_objects.push_back(tso);
             } else {
                 bounded_objects.push_back(tso);
             }
         } else {
-            Mesh* mesh = geo->GetRenderMesh();
+            Mesh* mesh = geo->GetCompleteRenderMesh();
             if (mesh != nullptr) {
 
                 glm::mat4 world2local = glm::inverse(model_matrix);
@@ -63,7 +64,7 @@ void TraceScene::AddSceneObjects(SceneObject* obj, glm::mat4 model_matrix) {
                             normals.size()>0
                     );
                     tgeo->RenderMaterial.Set(geo->RenderMaterial.Get());
-                    bounded_objects.push_back(new TraceGeometry(tgeo));
+                    bounded_objects.push_back(new TraceGeometry(tgeo, material));
                 }
 
             }
@@ -86,10 +87,18 @@ void TraceScene::AddSceneObjects(SceneObject* obj, glm::mat4 model_matrix) {
     }
 
     for(SceneObject* child : obj->GetChildren()) {
-        AddSceneObjects(child, model_matrix);
+        AddSceneObjects(child);
     }
 }
 
+const TraceMaterial* TraceScene::GetTraceMaterial(Material* material) {
+    auto it = materials_.find(material);
+    if (it == materials_.end()) {
+        it = materials_.emplace(material, material->GetTraceMaterial()).first;
+    }
+    return &it->second;
+}
+
 bool TraceScene::Intersect(const Ray& r, Intersection& i) const {
     bool intersect_found = false;
 
@@ -5,6 +5,7 @@
 #include "tracesceneobject.h"
 #include "tracelight.h"
 
+#include <unordered_map>
 #include <vector>
 
 class TraceScene
@@ -23,7 +24,11 @@ public:
     TreeBox* tree;
 
 private:
-    void AddSceneObjects(SceneObject* obj, glm::mat4 model_matrix);
+    void AddSceneObjects(SceneObject* obj);
+    // Copies a material's trace inputs the first time it is used, so every object sharing it shares the copy
+    const TraceMaterial* GetTraceMaterial(Material* material);
+
+    std::unordered_map<Material*, TraceMaterial> materials_;
 };
 
 #endif // TRACESCENE_H
@@ -1,13 +1,13 @@
 #include "tracesceneobject.h"
 
-TraceGeometry::TraceGeometry(Geometry* geometry_) :
-    geometry(geometry_), identity_transform(true), transform(glm::mat4()), inverse_transform(glm::mat4()), normals_transform(glm::mat3())
+TraceGeometry::TraceGeometry(Geometry* geometry_, const TraceMaterial* material_) :
+    geometry(geometry_), material(material_), identity_transform(true), transform(glm::mat4()), inverse_transform(glm::mat4()), normals_transform(glm::mat3())
 {
     world_bbox = geometry->HasBoundingBox() ? geometry->GetLocalBoundingBox() : nullptr;
 }
 
-TraceGeometry::TraceGeometry(Geometry* geometry_, glm::mat4 transform_) :
-    identity_transform(false), transform(transform_), inverse_transform(glm::inverse(transform_)), normals_transform(glm::transpose(glm::inverse(glm::mat3(transform_)))), geometry(geometry_)
+TraceGeometry::TraceGeometry(Geometry* geometry_, const TraceMaterial* material_, glm::mat4 transform_) :
+    identity_transform(false), transform(transform_), inverse_transform(glm::inverse(transform_)), normals_transform(glm::transpose(glm::inverse(glm::mat3(transform_)))), geometry(geometry_), material(material_)
 {
     world_bbox = geometry->HasBoundingBox() ? geometry->GetWorldBoundingBox(transform_) : nullptr;
 }
@@ -4,6 +4,7 @@
 #include "tracelight.h"
 
 #include <scene/components/geometry.h>
+#include <resource/material.h>
 
 // Anything that might be intersected within the scene bounds
 class TraceSceneObject
@@ -19,13 +20,14 @@ public:
 class TraceGeometry : public TraceSceneObject
 {
 public:
-    TraceGeometry(Geometry* geometry_);
-    TraceGeometry(Geometry* geometry_, glm::mat4 transform_);
+    TraceGeometry(Geometry* geometry_, const TraceMaterial* material_);
+    TraceGeometry(Geometry* geometry_, const TraceMaterial* material_, glm::mat4 transform_);
     ~TraceGeometry();
 
     virtual bool Intersect(const Ray&r, Intersection&i);
 
     Geometry* geometry;
+    const TraceMaterial* material; //owned by the TraceScene
     bool identity_transform;
     glm::mat4 transform; //local2world
     glm::mat4 inverse_transform;